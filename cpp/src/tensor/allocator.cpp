@@ -0,0 +1,156 @@
+#include "allocator.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+namespace ts {
+
+auto AlignedResource::allocate(std::size_t bytes) -> void *
+{
+    // aligned_alloc wants size to be a multiple of alignment
+    std::size_t size = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    void *ptr = std::aligned_alloc(ALIGNMENT, size);
+    if (ptr == nullptr) {
+        std::cerr << "AlignedResource: couldn't allocate " << size << " bytes" << std::endl;
+        exit(-1);
+    }
+    return ptr;
+}
+
+auto AlignedResource::deallocate(void *ptr, std::size_t) -> void { std::free(ptr); }
+
+ExternalResource::ExternalResource(void *data, std::size_t bytes, std::function<void()> release)
+    : _data(data), _bytes(bytes), _release(std::move(release))
+{
+}
+
+auto ExternalResource::allocate(std::size_t bytes) -> void *
+{
+    if (bytes > _bytes) {
+        std::cerr << "ExternalResource: asked for " << bytes << " bytes, the buffer has " << _bytes << std::endl;
+        exit(-1);
+    }
+    return _data;
+}
+
+auto ExternalResource::deallocate(void *, std::size_t) -> void {}
+
+ExternalResource::~ExternalResource()
+{
+    if (_release) {
+        _release();
+    }
+}
+
+auto CachingResource::bucket_size(std::size_t bytes) -> std::size_t
+{
+    if (bytes <= ALIGNMENT) {
+        return ALIGNMENT;
+    }
+    std::size_t power = ALIGNMENT;
+    while (power * 2 < bytes) {
+        power *= 2;
+    }
+    // four buckets between consecutive powers of two
+    std::size_t step = power / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+auto CachingResource::allocate(std::size_t bytes) -> void *
+{
+    std::size_t size = bucket_size(bytes);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats.bytes_in_use += size;
+        auto bucket = _buckets.find(size);
+        if (bucket != _buckets.end() && !bucket->second.empty()) {
+            void *ptr = bucket->second.back();
+            bucket->second.pop_back();
+            _stats.bytes_cached -= size;
+            _stats.hits++;
+            return ptr;
+        }
+        _stats.misses++;
+    }
+    return _upstream.allocate(size);
+}
+
+auto CachingResource::deallocate(void *ptr, std::size_t bytes) -> void
+{
+    std::size_t size = bucket_size(bytes);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats.bytes_in_use -= size;
+        if (_stats.bytes_cached + size <= _max_cached_bytes) {
+            _buckets[size].push_back(ptr);
+            _stats.bytes_cached += size;
+            return;
+        }
+    }
+    _upstream.deallocate(ptr, size);
+}
+
+auto CachingResource::stats() const -> AllocatorStats
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+auto CachingResource::reset_stats() -> void
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.hits = 0;
+    _stats.misses = 0;
+}
+
+auto CachingResource::release_cached() -> void
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &[size, blocks] : _buckets) {
+        for (void *ptr : blocks) {
+            _upstream.deallocate(ptr, size);
+        }
+    }
+    _buckets.clear();
+    _stats.bytes_cached = 0;
+}
+
+auto CachingResource::set_max_cached_bytes(std::size_t bytes) -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _max_cached_bytes = bytes;
+        if (_stats.bytes_cached <= _max_cached_bytes) {
+            return;
+        }
+    }
+    release_cached();
+}
+
+CachingResource::~CachingResource() { release_cached(); }
+
+auto caching_resource() -> CachingResource &
+{
+    // never destroyed on purpose, tensors living in static storage may still give their buffers back at exit
+    static auto *resource = new CachingResource();
+    return *resource;
+}
+
+namespace {
+std::atomic<MemoryResource *> current_resource{nullptr};
+} // namespace
+
+auto default_resource() -> MemoryResource *
+{
+    MemoryResource *resource = current_resource.load(std::memory_order_acquire);
+    return resource == nullptr ? &caching_resource() : resource;
+}
+
+auto set_default_resource(MemoryResource *resource) -> MemoryResource *
+{
+    MemoryResource *previous = current_resource.exchange(resource, std::memory_order_acq_rel);
+    return previous == nullptr ? &caching_resource() : previous;
+}
+
+} // namespace ts
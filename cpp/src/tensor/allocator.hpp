@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tensor/tensor_forward.hpp"
+
+namespace ts {
+
+// Tag for constructors of tensors whose every element is going to be overwritten anyway,
+// it skips zero-filling of a freshly allocated buffer.
+struct uninitialized_t {
+};
+inline constexpr uninitialized_t uninitialized{};
+
+class MemoryResource {
+  public:
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    virtual ~MemoryResource() = default;
+
+    virtual auto allocate(std::size_t bytes) -> void * = 0;
+
+    virtual auto deallocate(void *ptr, std::size_t bytes) -> void = 0;
+};
+
+// Plain aligned heap allocations, nothing is kept around after deallocate()
+class AlignedResource : public MemoryResource {
+  public:
+    auto allocate(std::size_t bytes) -> void * override;
+
+    auto deallocate(void *ptr, std::size_t bytes) -> void override;
+};
+
+// Hands out a single buffer owned by somebody else (a memory mapped file, memory of another library), nothing is
+// allocated or freed. `release` is called when the resource gets destroyed, see from_external() in storage.hpp.
+class ExternalResource : public MemoryResource {
+  public:
+    ExternalResource(void *data, std::size_t bytes, std::function<void()> release = nullptr);
+
+    ExternalResource(ExternalResource const &) = delete;
+
+    auto operator=(ExternalResource const &) -> ExternalResource & = delete;
+
+    auto allocate(std::size_t bytes) -> void * override;
+
+    auto deallocate(void *ptr, std::size_t bytes) -> void override;
+
+    ~ExternalResource() override;
+
+  private:
+    void *_data;
+    std::size_t _bytes;
+    std::function<void()> _release;
+};
+
+struct AllocatorStats {
+    size_type hits{};
+    size_type misses{};
+    size_type bytes_in_use{};
+    size_type bytes_cached{};
+
+    [[nodiscard]] auto hit_rate() const -> double
+    {
+        return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+    }
+};
+
+// Keeps freed blocks in size buckets so training loops which allocate and free the same shapes over and over
+// don't hit malloc on every op. Sizes are rounded up to one of four steps per power of two (at most 25% waste).
+class CachingResource : public MemoryResource {
+  public:
+    auto allocate(std::size_t bytes) -> void * override;
+
+    auto deallocate(void *ptr, std::size_t bytes) -> void override;
+
+    auto stats() const -> AllocatorStats;
+
+    auto reset_stats() -> void;
+
+    // Returns all cached blocks to the system
+    auto release_cached() -> void;
+
+    // Blocks freed while the cache is full are returned to the system right away
+    auto set_max_cached_bytes(std::size_t bytes) -> void;
+
+    static auto bucket_size(std::size_t bytes) -> std::size_t;
+
+    ~CachingResource() override;
+
+  private:
+    mutable std::mutex _mutex;
+    std::map<std::size_t, std::vector<void *>> _buckets;
+    std::size_t _max_cached_bytes = std::size_t(1) << 30;
+    AllocatorStats _stats{};
+    AlignedResource _upstream{};
+};
+
+// Process-wide caching resource, used by default by every tensor
+auto caching_resource() -> CachingResource &;
+
+auto default_resource() -> MemoryResource *;
+
+// Makes `resource` the one used by newly created tensors, returns the previous one.
+// Buffers are always given back to the resource which allocated them.
+auto set_default_resource(MemoryResource *resource) -> MemoryResource *;
+
+// Standard allocator on top of MemoryResource. Elements are default-initialized, so buffers of arithmetic types
+// aren't zero-filled on construction, Tensor takes care of it when needed.
+template <typename T> class Allocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    Allocator() noexcept : _resource(default_resource()) {}
+
+    explicit Allocator(MemoryResource *resource) noexcept : _resource(resource) {}
+
+    template <typename U> Allocator(Allocator<U> const &other) noexcept : _resource(other.resource()) {}
+
+    auto allocate(std::size_t n) -> T * { return static_cast<T *>(_resource->allocate(n * sizeof(T))); }
+
+    auto deallocate(T *ptr, std::size_t n) -> void { _resource->deallocate(ptr, n * sizeof(T)); }
+
+    template <typename U> auto construct(U *ptr) noexcept(std::is_nothrow_default_constructible_v<U>) -> void
+    {
+        ::new (static_cast<void *>(ptr)) U;
+    }
+
+    template <typename U, typename... Args> auto construct(U *ptr, Args &&...args) -> void
+    {
+        ::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    // copies of a tensor always land in the current default resource
+    auto select_on_container_copy_construction() const -> Allocator { return Allocator(); }
+
+    [[nodiscard]] auto resource() const noexcept -> MemoryResource * { return _resource; }
+
+  private:
+    MemoryResource *_resource;
+};
+
+template <typename T, typename U> auto operator==(Allocator<T> const &lhs, Allocator<U> const &rhs) -> bool
+{
+    return lhs.resource() == rhs.resource();
+}
+
+template <typename T, typename U> auto operator!=(Allocator<T> const &lhs, Allocator<U> const &rhs) -> bool
+{
+    return !(lhs == rhs);
+}
+
+} // namespace ts
@@ -0,0 +1,108 @@
+#include "backend.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace ts {
+
+namespace {
+
+auto default_backend() -> Backend
+{
+    char const *value = std::getenv("TENSOR_BACKEND");
+    if (value == nullptr || *value == '\0') {
+        return Backend::AUTO;
+    }
+    for (Backend backend : {Backend::AUTO, Backend::NATIVE, Backend::BLAS}) {
+        if (std::strcmp(value, backend_name(backend)) == 0) {
+            if (is_available(backend)) {
+                return backend;
+            }
+            std::cerr << "TENSOR_BACKEND: " << value << " is not compiled in, using auto" << std::endl;
+            return Backend::AUTO;
+        }
+    }
+    std::cerr << "TENSOR_BACKEND: unknown backend '" << value << "', expected one of auto, native, blas" << std::endl;
+    return Backend::AUTO;
+}
+
+std::atomic<Backend> global_backend{default_backend()};
+
+// 64 x 64 x 64, below that the call overhead of BLAS (argument checks, waking up its threads) is more than the product
+std::atomic<size_type> threshold{size_type(1) << 18};
+
+// innermost BackendScope of the current thread
+thread_local Backend scoped_backend = Backend::AUTO;
+thread_local bool scoped = false;
+
+} // namespace
+
+auto is_available(Backend backend) -> bool
+{
+    switch (backend) {
+    case Backend::BLAS:
+#ifdef USE_BLAS
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+auto backend_name(Backend backend) -> char const *
+{
+    switch (backend) {
+    case Backend::NATIVE:
+        return "native";
+    case Backend::BLAS:
+        return "blas";
+    default:
+        return "auto";
+    }
+}
+
+auto backend() -> Backend { return scoped ? scoped_backend : global_backend.load(std::memory_order_relaxed); }
+
+auto set_backend(Backend backend) -> void
+{
+    if (!is_available(backend)) {
+        std::cerr << "set_backend: " << backend_name(backend) << " is not compiled in" << std::endl;
+        return;
+    }
+    global_backend.store(backend, std::memory_order_relaxed);
+}
+
+auto blas_threshold() -> size_type { return threshold.load(std::memory_order_relaxed); }
+
+auto set_blas_threshold(size_type multiply_adds) -> void { threshold.store(multiply_adds, std::memory_order_relaxed); }
+
+BackendScope::BackendScope(Backend backend) : _previous(scoped_backend), _active(scoped)
+{
+    scoped_backend = backend;
+    scoped = true;
+}
+
+BackendScope::~BackendScope()
+{
+    scoped_backend = _previous;
+    scoped = _active;
+}
+
+namespace detail {
+
+auto select_backend(size_type m, size_type n, size_type k) -> Backend
+{
+    Backend selected = backend();
+    if (selected == Backend::AUTO) {
+        selected = m * n * k >= blas_threshold() ? Backend::BLAS : Backend::NATIVE;
+    }
+    return is_available(selected) ? selected : Backend::NATIVE;
+}
+
+} // namespace detail
+
+} // namespace ts
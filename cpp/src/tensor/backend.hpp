@@ -0,0 +1,55 @@
+#pragma once
+
+#include "tensor/tensor_forward.hpp"
+
+// Linear algebra backends picked at runtime. The native one (gemm.hpp) is always there, BLAS is compiled in when the
+// build found one (TENSOR_USE_BLAS, any CBLAS find_package(BLAS) can find, e.g. OpenBLAS or MKL through BLA_VENDOR).
+// ts::dot and friends ask for a backend on every call: the one pinned with a BackendScope or set_backend() or, for
+// AUTO (the default), BLAS for products big enough to pay for the call and native for small ones like RNN steps.
+//
+// The default can be set with TENSOR_BACKEND=auto|native|blas. A single call can skip the dispatch by calling
+// ts::naive::dot directly, or ts::blas::dot in builds with BLAS (#ifdef USE_BLAS).
+
+namespace ts {
+
+enum class Backend { AUTO, NATIVE, BLAS };
+
+auto is_available(Backend backend) -> bool;
+
+auto backend_name(Backend backend) -> char const *;
+
+// Backend of ts::dot calls made from this thread, set_backend() overridden by the innermost BackendScope
+auto backend() -> Backend;
+
+// Backend for all threads, an unavailable one is ignored (with a message)
+auto set_backend(Backend backend) -> void;
+
+// Products with fewer multiply-adds than this go to the native backend in the AUTO mode
+auto blas_threshold() -> size_type;
+
+auto set_blas_threshold(size_type multiply_adds) -> void;
+
+// Pins the backend of ts::dot calls made from the current thread until the end of the scope, e.g. to A/B a model
+class BackendScope {
+  public:
+    explicit BackendScope(Backend backend);
+
+    ~BackendScope();
+
+    BackendScope(BackendScope const &) = delete;
+
+    auto operator=(BackendScope const &) -> BackendScope & = delete;
+
+  private:
+    Backend _previous;
+    bool _active;
+};
+
+namespace detail {
+
+// NATIVE or BLAS for a product C(m, n) = A(m, k) * B(k, n)
+auto select_backend(size_type m, size_type n, size_type k) -> Backend;
+
+} // namespace detail
+
+} // namespace ts
@@ -3,13 +3,14 @@
 #include <memory>
 #include <vector>
 
+#include "tensor/allocator.hpp"
 #include "tensor/tensor_forward.hpp"
 
 namespace ts {
 
 template <typename Element> class DataHolder {
   public:
-    using vector_t = std::vector<Element>;
+    using vector_t = std::vector<Element, Allocator<Element>>;
     using data_ptr_t = std::shared_ptr<vector_t>;
     using iterator = typename vector_t::iterator;
 
@@ -0,0 +1,179 @@
+#include "epilogue.hpp"
+#include "backend.hpp"
+#include "gemm.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace ts {
+
+namespace {
+
+// the same as in ts::tanh
+constexpr float TANH_EPSILON = 1e-10f;
+
+auto as_operand(MatrixF const &A, bool transpose) -> detail::MatrixRef
+{
+    auto strides = A.strides();
+    if (transpose) {
+        return {A.raw_data(), strides[1], strides[0]};
+    }
+    return {A.raw_data(), strides[0], strides[1]};
+}
+
+// d_product = d_output * activation'(output) for a row of the output
+auto activation_backward(Activation activation, float const *output, float const *d_output, float *d_product,
+                         size_type n) -> void
+{
+    switch (activation) {
+    case Activation::RELU:
+        for (size_type j = 0; j < n; ++j) {
+            d_product[j] = output[j] > 0.0f ? d_output[j] : 0.0f;
+        }
+        break;
+    case Activation::TANH:
+        for (size_type j = 0; j < n; ++j) {
+            d_product[j] = (1.0f - output[j] * output[j]) * d_output[j];
+        }
+        break;
+    default:
+        std::copy(d_output, d_output + n, d_product);
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+auto apply_epilogue(Epilogue const &epilogue, size_type row, size_type column, size_type rows, size_type columns,
+                    float *C, size_type ldc) -> void
+{
+    auto const &kernels = simd::kernels();
+    float const *bias = epilogue.bias ? epilogue.bias->raw_data() : nullptr;
+    size_type bias_stride = epilogue.bias ? epilogue.bias->strides()[0] : 0;
+
+    for (size_type r = 0; r < rows; ++r) {
+        float *c = C + r * ldc;
+        if (bias != nullptr && epilogue.bias_axis == 0) {
+            kernels.add_scalar(c, bias[(row + r) * bias_stride], c, columns);
+        } else if (bias != nullptr && bias_stride == 1) {
+            kernels.add(c, bias + column, c, columns);
+        } else if (bias != nullptr) {
+            for (size_type j = 0; j < columns; ++j) {
+                c[j] += bias[(column + j) * bias_stride];
+            }
+        }
+
+        switch (epilogue.activation) {
+        case Activation::RELU:
+            kernels.maximum(0.0f, c, c, columns);
+            break;
+        case Activation::TANH:
+            for (size_type j = 0; j < columns; ++j) {
+                c[j] = std::tanh(c[j] + TANH_EPSILON);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+} // namespace detail
+
+auto fused::dot(MatrixF const &A, MatrixF const &B, MatrixF &C, Epilogue const &epilogue, bool A_T, bool B_T) -> void
+{
+    size_type m = A_T ? A.shape(1) : A.shape(0);
+    size_type n = B_T ? B.shape(0) : B.shape(1);
+    assert(C.shape(0) == m && C.shape(1) == n);
+    assert(!epilogue.bias || epilogue.bias->shape(0) == (epilogue.bias_axis == 0 ? m : n));
+
+    if (C.strides()[1] != 1 && n > 1) {
+        MatrixF C_contiguous({m, n}, uninitialized);
+        fused::dot(A, B, C_contiguous, epilogue, A_T, B_T);
+        C.assign(C_contiguous);
+        return;
+    }
+    size_type k = A_T ? A.shape(0) : A.shape(1);
+    size_type ldc = std::max<size_type>(C.strides()[0], 1);
+#ifdef USE_BLAS
+    if (detail::select_backend(m, n, k) == Backend::BLAS) {
+        // BLAS can't run anything per tile, the epilogue is a single pass after the product
+        blas::dot(A, B, C, A_T, B_T);
+        float *c = C.raw_data_mutable();
+        parallel_for(m, [&](size_type begin, size_type end) {
+            detail::apply_epilogue(epilogue, begin, 0, end - begin, n, c + begin * ldc, ldc);
+        });
+        return;
+    }
+#endif
+    detail::gemm(m, n, k, as_operand(A, A_T), as_operand(B, B_T), 0.0f, C.raw_data_mutable(), ldc, &epilogue);
+}
+
+auto epilogue_backward(Tensor<float, 3> const &output, Tensor<float, 3> const &d_output, Epilogue const &epilogue,
+                       VectorF *d_bias) -> Tensor<float, 3>
+{
+    assert(output.shape() == d_output.shape());
+    bool activation = epilogue.activation != Activation::NONE;
+    if (!activation && d_bias == nullptr) {
+        return d_output;
+    }
+    auto [batch_size, rows, columns] = output.shape();
+    auto d = d_output.contiguous();
+    auto y = activation ? output.contiguous() : output;
+    auto d_product = activation ? Tensor<float, 3>(output.shape(), uninitialized) : d;
+    size_type outputs = d_bias != nullptr ? d_bias->shape(0) : 0;
+    assert(d_bias == nullptr || outputs == (epilogue.bias_axis == 0 ? rows : columns));
+
+    // rows of the output are split between threads, each of them sums the bias gradient of its rows on the side
+    size_type lines = batch_size * rows;
+    size_type chunks = std::min(detail::parallel_chunks(lines * columns), std::max<size_type>(lines, 1));
+    std::vector<double> partials(chunks * outputs, 0.0);
+    detail::run_chunks(lines, chunks, 1, [&](size_type chunk, size_type begin, size_type end) {
+        double *partial = partials.data() + chunk * outputs;
+        for (size_type line = begin; line < end; ++line) {
+            float *dz = d_product.raw_data_mutable() + line * columns;
+            if (activation) {
+                activation_backward(epilogue.activation, y.raw_data() + line * columns, d.raw_data() + line * columns,
+                                    dz, columns);
+            }
+            if (outputs == 0) {
+                continue;
+            }
+            if (epilogue.bias_axis == 0) {
+                double sum = 0.0;
+                for (size_type j = 0; j < columns; ++j) {
+                    sum += dz[j];
+                }
+                partial[line % rows] += sum;
+            } else {
+                for (size_type j = 0; j < columns; ++j) {
+                    partial[j] += dz[j];
+                }
+            }
+        }
+    });
+    for (size_type i = 0; i < outputs; ++i) {
+        double sum = 0.0;
+        for (size_type chunk = 0; chunk < chunks; ++chunk) {
+            sum += partials[chunk * outputs + i];
+        }
+        (*d_bias)(i) += static_cast<float>(sum);
+    }
+    return d_product;
+}
+
+auto epilogue_backward(MatrixF const &output, MatrixF const &d_output, Epilogue const &epilogue, VectorF *d_bias)
+    -> MatrixF
+{
+    auto [rows, columns] = output.shape();
+    auto d_product = epilogue_backward(output.reshape<3>({1, rows, columns}), d_output.reshape<3>({1, rows, columns}),
+                                       epilogue, d_bias);
+    return d_product.reshape<2>({rows, columns});
+}
+
+} // namespace ts
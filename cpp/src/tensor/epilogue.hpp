@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+
+#include "tensor/tensor.hpp"
+
+// Bias and activation fused into a matrix product. The native GEMM applies them to every tile of the output right
+// after its last block of k is accumulated, while the tile is still in cache, so the layers don't need two more
+// passes over the output and two temporaries. With BLAS they are applied in a single pass after the product.
+
+namespace ts {
+
+enum class Activation { RELU, TANH, NONE };
+
+struct Epilogue {
+    // one value for every column of the output, or for every row when bias_axis is 0
+    std::optional<VectorF> bias = std::nullopt;
+    int bias_axis = 1;
+    Activation activation = Activation::NONE;
+};
+
+// in its own namespace like the backends, ts::dot has to keep finding all of them
+namespace fused {
+
+// C = activation(op(A) * op(B) + bias), C is overwritten
+auto dot(MatrixF const &A, MatrixF const &B, MatrixF &C, Epilogue const &epilogue, bool A_T = false,
+         bool B_T = false) -> void;
+
+} // namespace fused
+
+using namespace fused;
+
+// Gradient of the product from the output of the epilogue and its gradient, d_bias (when given) is increased by the
+// gradient of the bias in the same pass. Samples are [batch, rows, columns], the bias is shared by all of them.
+auto epilogue_backward(Tensor<float, 3> const &output, Tensor<float, 3> const &d_output, Epilogue const &epilogue,
+                       VectorF *d_bias = nullptr) -> Tensor<float, 3>;
+
+auto epilogue_backward(MatrixF const &output, MatrixF const &d_output, Epilogue const &epilogue,
+                       VectorF *d_bias = nullptr) -> MatrixF;
+
+namespace detail {
+
+// Applies the epilogue to a block of the output whose first element is (row, column), rows are ldc apart
+auto apply_epilogue(Epilogue const &epilogue, size_type row, size_type column, size_type rows, size_type columns,
+                    float *C, size_type ldc) -> void;
+
+} // namespace detail
+
+} // namespace ts
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <type_traits>
+
+#include "tensor/parallel.hpp"
+#include "tensor/tensor.hpp"
+
+// Lazy (fused) versions of elementwise ops from ops_common.hpp. Functions in ts::lazy only build an expression,
+// nothing is computed until it's converted to a Tensor, then the whole expression is evaluated in a single loop
+// without temporaries, e.g.
+//
+//     MatrixF c = lazy::add(lazy::multiply(f, c_prev), lazy::multiply(i, c_dash));
+//
+// Operands can be tensors, other expressions or scalars. Tensors are captured by (shallow) copy so an expression
+// stays valid even if it outlives them.
+
+namespace ts::lazy {
+
+template <typename Derived> struct Expression {
+    auto self() const -> Derived const & { return static_cast<Derived const &>(*this); }
+
+    template <typename Element, int Dim> operator Tensor<Element, Dim>() const;
+};
+
+template <typename T> inline constexpr bool is_expression_v = std::is_base_of_v<Expression<T>, T>;
+
+template <typename Element, int Dim> class Terminal : public Expression<Terminal<Element, Dim>> {
+  public:
+    using element_type = Element;
+    static constexpr int dim = Dim;
+
+    explicit Terminal(Tensor<Element, Dim> const &tensor) : _tensor(tensor.contiguous())
+    {
+        _data = _tensor.raw_data();
+    }
+
+    auto operator[](size_type i) const -> Element { return _data[i]; }
+
+    auto shape() const -> std::array<size_type, Dim> { return _tensor.shape(); }
+
+  private:
+    Tensor<Element, Dim> _tensor;
+    Element const *_data;
+};
+
+template <typename Element> class Scalar : public Expression<Scalar<Element>> {
+  public:
+    using element_type = Element;
+    static constexpr int dim = 0;
+
+    explicit Scalar(Element value) : _value(value) {}
+
+    auto operator[](size_type) const -> Element { return _value; }
+
+  private:
+    Element _value;
+};
+
+template <typename Op, typename E> class Unary : public Expression<Unary<Op, E>> {
+  public:
+    using element_type = typename E::element_type;
+    static constexpr int dim = E::dim;
+
+    Unary(Op op, E e) : _op(op), _e(e) {}
+
+    auto operator[](size_type i) const -> element_type { return _op(_e[i]); }
+
+    auto shape() const -> std::array<size_type, dim> { return _e.shape(); }
+
+  private:
+    Op _op;
+    E _e;
+};
+
+template <typename Op, typename L, typename R> class Binary : public Expression<Binary<Op, L, R>> {
+  public:
+    static_assert(L::dim == R::dim || L::dim == 0 || R::dim == 0, "operands must have the same number of dimensions");
+
+    using element_type = std::conditional_t<L::dim == 0, typename R::element_type, typename L::element_type>;
+    static constexpr int dim = L::dim == 0 ? R::dim : L::dim;
+
+    Binary(Op op, L l, R r) : _op(op), _l(l), _r(r)
+    {
+        if constexpr (L::dim != 0 && R::dim != 0) {
+            assert(_l.shape() == _r.shape());
+        }
+    }
+
+    auto operator[](size_type i) const -> element_type { return _op(_l[i], _r[i]); }
+
+    auto shape() const -> std::array<size_type, dim>
+    {
+        if constexpr (L::dim == 0) {
+            return _r.shape();
+        } else {
+            return _l.shape();
+        }
+    }
+
+  private:
+    Op _op;
+    L _l;
+    R _r;
+};
+
+// Element type of a tensor or an expression, void for scalars
+template <typename T, typename = void> struct element_of {
+    using type = void;
+};
+
+template <typename Element, int Dim> struct element_of<Tensor<Element, Dim>> {
+    using type = Element;
+};
+
+template <typename T> struct element_of<T, std::enable_if_t<is_expression_v<T>>> {
+    using type = typename T::element_type;
+};
+
+// Scalars take the element type of the other operand, so multiply(MatrixF, 0.5) stays in floats
+template <typename Element, typename T> auto as_expression(T const &t)
+{
+    if constexpr (is_expression_v<T>) {
+        return t;
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        return Scalar<Element>(static_cast<Element>(t));
+    } else {
+        return Terminal(t);
+    }
+}
+
+template <typename Op, typename L, typename R> auto make_binary(Op op, L const &l, R const &r)
+{
+    using Element = std::conditional_t<std::is_void_v<typename element_of<L>::type>, typename element_of<R>::type,
+                                       typename element_of<L>::type>;
+    auto l_expression = as_expression<Element>(l);
+    auto r_expression = as_expression<Element>(r);
+    return Binary<Op, decltype(l_expression), decltype(r_expression)>(op, l_expression, r_expression);
+}
+
+template <typename Op, typename T> auto make_unary(Op op, T const &t)
+{
+    auto expression = as_expression<typename element_of<T>::type>(t);
+    return Unary<Op, decltype(expression)>(op, expression);
+}
+
+template <typename L, typename R> auto add(L const &l, R const &r) { return make_binary(std::plus<>(), l, r); }
+
+template <typename L, typename R> auto subtract(L const &l, R const &r) { return make_binary(std::minus<>(), l, r); }
+
+template <typename L, typename R> auto multiply(L const &l, R const &r)
+{
+    return make_binary(std::multiplies<>(), l, r);
+}
+
+template <typename L, typename R> auto divide(L const &l, R const &r) { return make_binary(std::divides<>(), l, r); }
+
+template <typename Value, typename T> auto maximum(Value value, T const &t)
+{
+    return make_binary([](auto v, auto e) { return e < v ? v : e; }, value, t);
+}
+
+template <typename T, typename Fn> auto apply(T const &t, Fn fn) { return make_unary(fn, t); }
+
+template <typename L, typename R, typename Fn> auto apply(L const &l, R const &r, Fn fn)
+{
+    return make_binary(fn, l, r);
+}
+
+// same epsilons as the eager versions
+template <typename T> auto log(T const &t)
+{
+    return make_unary([](auto e) { return std::log(e + 1e-10f); }, t);
+}
+
+template <typename T> auto exp(T const &t)
+{
+    return make_unary([](auto e) { return std::exp(e) + 1e-10f; }, t);
+}
+
+template <typename T> auto pow(T const &t, float value)
+{
+    return make_unary([value](auto e) { return std::pow(e, value); }, t);
+}
+
+// Evaluates expression into an existing tensor of the same shape, output may also be one of the operands
+template <typename E, typename Element, int Dim>
+auto evaluate(Expression<E> const &expression, Tensor<Element, Dim> &output) -> void
+{
+    auto const &e = expression.self();
+    assert(output.shape() == e.shape());
+    if (!output.is_contiguous()) {
+        Tensor<Element, Dim> result(output.shape(), uninitialized);
+        evaluate(expression, result);
+        output.assign(result);
+        return;
+    }
+    Element *data = output.raw_data_mutable();
+    parallel_for(
+        output.data_size(),
+        [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                data[i] = e[i];
+            }
+        },
+        elements_per_cache_line<Element>);
+}
+
+template <typename E> auto evaluate(Expression<E> const &expression) -> Tensor<typename E::element_type, E::dim>
+{
+    Tensor<typename E::element_type, E::dim> result(expression.self().shape(), uninitialized);
+    evaluate(expression, result);
+    return result;
+}
+
+template <typename Derived>
+template <typename Element, int Dim>
+Expression<Derived>::operator Tensor<Element, Dim>() const
+{
+    Tensor<Element, Dim> result(self().shape(), uninitialized);
+    evaluate(*this, result);
+    return result;
+}
+
+} // namespace ts::lazy
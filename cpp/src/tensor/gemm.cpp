@@ -0,0 +1,237 @@
+#include "gemm.hpp"
+#include "epilogue.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace ts::detail {
+
+namespace {
+
+// biggest micro-kernel tile (AVX-512)
+constexpr size_type GEMM_TILE = 12 * 32;
+// independent sums of a row of A times x, they let the compiler vectorize the loop
+constexpr size_type LANES = 8;
+
+auto round_up(size_type value, size_type multiple) -> size_type { return (value + multiple - 1) / multiple * multiple; }
+
+// out[(panel * kc + p) * mr + r] = A(panel * mr + r, p), rows past `rows` are zero
+auto pack_a(MatrixRef A, size_type rows, size_type kc, size_type mr, float *out) -> void
+{
+    for (size_type panel = 0; panel * mr < rows; ++panel) {
+        float *dst = out + panel * kc * mr;
+        float const *src = A.data + panel * mr * A.row_stride;
+        size_type count = std::min(mr, rows - panel * mr);
+        if (A.column_stride == 1) {
+            for (size_type r = 0; r < count; ++r) {
+                float const *row = src + r * A.row_stride;
+                for (size_type p = 0; p < kc; ++p) {
+                    dst[p * mr + r] = row[p];
+                }
+            }
+        } else {
+            for (size_type p = 0; p < kc; ++p) {
+                for (size_type r = 0; r < count; ++r) {
+                    dst[p * mr + r] = src[r * A.row_stride + p * A.column_stride];
+                }
+            }
+        }
+        for (size_type p = 0; count < mr && p < kc; ++p) {
+            std::fill(dst + p * mr + count, dst + (p + 1) * mr, 0.0f);
+        }
+    }
+}
+
+// out[(panel * kc + p) * nr + j] = B(p, panel * nr + j), columns past `columns` are zero
+auto pack_b(MatrixRef B, size_type kc, size_type columns, size_type nr, float *out) -> void
+{
+    for (size_type panel = 0; panel * nr < columns; ++panel) {
+        float *dst = out + panel * kc * nr;
+        float const *src = B.data + panel * nr * B.column_stride;
+        size_type count = std::min(nr, columns - panel * nr);
+        if (B.column_stride == 1) {
+            for (size_type p = 0; p < kc; ++p) {
+                float const *row = src + p * B.row_stride;
+                std::copy(row, row + count, dst + p * nr);
+            }
+        } else {
+            for (size_type j = 0; j < count; ++j) {
+                float const *column = src + j * B.column_stride;
+                for (size_type p = 0; p < kc; ++p) {
+                    dst[p * nr + j] = column[p * B.row_stride];
+                }
+            }
+        }
+        for (size_type p = 0; count < nr && p < kc; ++p) {
+            std::fill(dst + p * nr + count, dst + (p + 1) * nr, 0.0f);
+        }
+    }
+}
+
+auto dot_row(float const *a, size_type a_stride, float const *x, size_type x_stride, size_type k) -> float
+{
+    float partial[LANES] = {};
+    size_type p = 0;
+    if (a_stride == 1 && x_stride == 1) {
+        for (; p + LANES <= k; p += LANES) {
+            for (size_type l = 0; l < LANES; ++l) {
+                partial[l] += a[p + l] * x[p + l];
+            }
+        }
+    }
+    for (; p < k; ++p) {
+        partial[0] += a[p * a_stride] * x[p * x_stride];
+    }
+    float result = 0.0f;
+    for (float value : partial) {
+        result += value;
+    }
+    return result;
+}
+
+} // namespace
+
+auto gemm(size_type m, size_type n, size_type k, MatrixRef A, MatrixRef B, float beta, float *C, size_type ldc,
+          Epilogue const *epilogue) -> void
+{
+    if (m == 0 || n == 0) {
+        return;
+    }
+    auto const &kernels = simd::kernels();
+    if (m == 1 && beta == 0.0f) {
+        // a single row of C is B^T times the row of A
+        gemv(n, k, {B.data, B.column_stride, B.row_stride}, A.data, A.column_stride, C);
+        if (epilogue != nullptr) {
+            apply_epilogue(*epilogue, 0, 0, 1, n, C, ldc);
+        }
+        return;
+    }
+    // the micro-kernel either overwrites C or adds to it, other betas are applied up front
+    if (beta != 0.0f && beta != 1.0f) {
+        for (size_type i = 0; i < m; ++i) {
+            kernels.multiply_scalar(C + i * ldc, beta, C + i * ldc, n);
+        }
+    }
+    if (k == 0) {
+        for (size_type i = 0; beta == 0.0f && i < m; ++i) {
+            kernels.fill(C + i * ldc, 0.0f, n);
+        }
+        if (epilogue != nullptr) {
+            apply_epilogue(*epilogue, 0, 0, m, n, C, ldc);
+        }
+        return;
+    }
+
+    size_type const mr = kernels.gemm_rows;
+    size_type const nr = kernels.gemm_columns;
+    size_type const mc = GEMM_MC / mr * mr;
+    size_type const nc_max = round_up(std::min(GEMM_NC, n), nr);
+    assert(mr * nr <= GEMM_TILE);
+    std::vector<float> b_pack(std::min(GEMM_KC, k) * nc_max);
+    size_type const m_blocks = (m + mc - 1) / mc;
+
+    for (size_type jc = 0; jc < n; jc += GEMM_NC) {
+        size_type nc = std::min(GEMM_NC, n - jc);
+        size_type panels = (nc + nr - 1) / nr;
+        // when there are fewer row blocks than threads the panels of B are split between them too
+        size_type groups = std::min(panels, (static_cast<size_type>(max_threads()) + m_blocks - 1) / m_blocks);
+        size_type group_size = (panels + groups - 1) / groups;
+
+        for (size_type pc = 0; pc < k; pc += GEMM_KC) {
+            size_type kc = std::min(GEMM_KC, k - pc);
+            bool accumulate = beta != 0.0f || pc > 0;
+            bool last = pc + kc == k;
+            pack_b({B.data + pc * B.row_stride + jc * B.column_stride, B.row_stride, B.column_stride}, kc, nc, nr,
+                   b_pack.data());
+
+            parallel_for_each(m_blocks * groups, [&](size_type item) {
+                size_type ic = item / groups * mc;
+                size_type rows = std::min(mc, m - ic);
+                size_type panel_begin = item % groups * group_size;
+                size_type panel_end = std::min(panels, panel_begin + group_size);
+
+                // items never wait for other tasks, so nothing else runs on this thread while the buffer is in use
+                thread_local std::vector<float> a_pack;
+                a_pack.resize(std::max(a_pack.size(), mc * GEMM_KC));
+                pack_a({A.data + ic * A.row_stride + pc * A.column_stride, A.row_stride, A.column_stride}, rows, kc,
+                       mr, a_pack.data());
+
+                float tile[GEMM_TILE];
+                for (size_type panel = panel_begin; panel < panel_end; ++panel) {
+                    float const *b = b_pack.data() + panel * kc * nr;
+                    size_type columns = std::min(nr, nc - panel * nr);
+                    for (size_type ir = 0; ir < rows; ir += mr) {
+                        float const *a = a_pack.data() + ir * kc;
+                        float *c = C + (ic + ir) * ldc + jc + panel * nr;
+                        size_type tile_rows = std::min(mr, rows - ir);
+                        if (tile_rows == mr && columns == nr) {
+                            kernels.gemm(kc, a, b, c, ldc, accumulate);
+                        } else {
+                            // edges of C go through a full tile
+                            kernels.gemm(kc, a, b, tile, nr, false);
+                            for (size_type r = 0; r < tile_rows; ++r) {
+                                for (size_type j = 0; j < columns; ++j) {
+                                    c[r * ldc + j] = accumulate ? c[r * ldc + j] + tile[r * nr + j] : tile[r * nr + j];
+                                }
+                            }
+                        }
+                        // the tile is still in cache
+                        if (last && epilogue != nullptr) {
+                            apply_epilogue(*epilogue, ic + ir, jc + panel * nr, tile_rows, columns, c, ldc);
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+auto gemm_batched(size_type batch, size_type m, size_type n, size_type k, MatrixRef A, size_type A_batch_stride,
+                  MatrixRef B, size_type B_batch_stride, float beta, float *C, size_type ldc, size_type C_batch_stride)
+    -> void
+{
+    if (batch == 0) {
+        return;
+    }
+    // with B shared and the rows of A and C evenly spaced across samples, the samples are one product of stacked rows
+    if (B_batch_stride == 0 && A_batch_stride == m * A.row_stride && C_batch_stride == m * ldc) {
+        gemm(batch * m, n, k, A, B, beta, C, ldc);
+        return;
+    }
+    // samples go to different threads, gemm splits each of them further when there are threads left
+    parallel_for_each(batch, [&](size_type b) {
+        gemm(m, n, k, {A.data + b * A_batch_stride, A.row_stride, A.column_stride},
+             {B.data + b * B_batch_stride, B.row_stride, B.column_stride}, beta, C + b * C_batch_stride, ldc);
+    });
+}
+
+auto gemv(size_type m, size_type k, MatrixRef A, float const *x, size_type x_stride, float *y) -> void
+{
+    if (A.row_stride == 1 && m > 1) {
+        // columns of A are contiguous, y is built from them one at a time
+        auto const &kernels = simd::kernels();
+        parallel_for(
+            m,
+            [&](size_type begin, size_type end) {
+                kernels.fill(y + begin, 0.0f, end - begin);
+                for (size_type p = 0; p < k; ++p) {
+                    kernels.axpy(x[p * x_stride], A.data + begin + p * A.column_stride, y + begin, end - begin);
+                }
+            },
+            elements_per_cache_line<float>);
+        return;
+    }
+    parallel_for(
+        m,
+        [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                y[i] = dot_row(A.data + i * A.row_stride, A.column_stride, x, x_stride, k);
+            }
+        },
+        elements_per_cache_line<float>);
+}
+
+} // namespace ts::detail
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "tensor_forward.hpp"
+
+// Native float GEMM for builds without BLAS, organized like GotoBLAS/BLIS: k is cut into blocks of GEMM_KC, a block
+// of B (GEMM_KC x GEMM_NC, sized for L3) is packed into panels of gemm_columns and shared by all threads, blocks of
+// A (GEMM_MC x GEMM_KC, sized for L2) are packed by every thread into panels of gemm_rows and multiplied by the
+// register-tiled simd::kernels().gemm micro-kernel. Threads take row blocks of A and, when there are not enough of
+// them, groups of B panels.
+//
+// Packing reads A and B through their strides, so transposed operands and views don't need a copy.
+
+namespace ts {
+struct Epilogue;
+}
+
+namespace ts::detail {
+
+inline constexpr size_type GEMM_KC = 256;
+inline constexpr size_type GEMM_MC = 144;
+inline constexpr size_type GEMM_NC = 4096;
+
+// Element (i, j) is data[i * row_stride + j * column_stride]
+struct MatrixRef {
+    float const *data;
+    size_type row_stride;
+    size_type column_stride;
+};
+
+// C(m, n) = A(m, k) * B(k, n) + beta * C(m, n), C is row-major with rows ldc apart. C isn't read when beta is 0.
+// The epilogue, if any, is applied to every tile of C once it's final
+auto gemm(size_type m, size_type n, size_type k, MatrixRef A, MatrixRef B, float beta, float *C, size_type ldc,
+          Epilogue const *epilogue = nullptr) -> void;
+
+// C_b = A_b * B_b + beta * C_b for every sample b < batch, operands of sample b start b batch strides past the first
+// ones. A batch stride of 0 shares the operand between all samples
+auto gemm_batched(size_type batch, size_type m, size_type n, size_type k, MatrixRef A, size_type A_batch_stride,
+                  MatrixRef B, size_type B_batch_stride, float beta, float *C, size_type ldc, size_type C_batch_stride)
+    -> void;
+
+// y(m) = A(m, k) * x(k)
+auto gemv(size_type m, size_type k, MatrixRef A, float const *x, size_type x_stride, float *y) -> void;
+
+} // namespace ts::detail
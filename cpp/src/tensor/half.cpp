@@ -0,0 +1,44 @@
+#include "half.hpp"
+#include "simd.hpp"
+
+namespace ts {
+
+// bf16 is the upper half of a float, the loops below are plain integer code the compiler vectorizes on its own
+
+auto convert(float const *x, bf16 *out, size_type n) -> void
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i].bits = bf16::from_float(x[i]);
+    }
+}
+
+auto convert(bf16 const *x, float *out, size_type n) -> void
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i];
+    }
+}
+
+auto convert(float const *x, fp16 *out, size_type n) -> void
+{
+    if (auto kernel = simd::kernels().float_to_fp16; kernel != nullptr) {
+        kernel(x, reinterpret_cast<std::uint16_t *>(out), n);
+        return;
+    }
+    for (size_type i = 0; i < n; ++i) {
+        out[i].bits = fp16::from_float(x[i]);
+    }
+}
+
+auto convert(fp16 const *x, float *out, size_type n) -> void
+{
+    if (auto kernel = simd::kernels().fp16_to_float; kernel != nullptr) {
+        kernel(reinterpret_cast<std::uint16_t const *>(x), out, n);
+        return;
+    }
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i];
+    }
+}
+
+} // namespace ts
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "tensor/tensor_forward.hpp"
+
+// 16 bit storage types. Tensor<bf16, Dim> and Tensor<fp16, Dim> take half the memory (and memory bandwidth) of float
+// tensors, but all the math is done in float: elements convert to float implicitly, results are rounded (to nearest
+// even) once when they're stored back.
+//
+// bf16 keeps the exponent range of float with 8 bits of mantissa, fp16 (IEEE binary16) has 11 bits of mantissa but
+// overflows above 65504.
+
+namespace ts {
+
+namespace detail {
+
+inline auto float_bits(float value) -> std::uint32_t
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline auto bits_float(std::uint32_t bits) -> float
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace detail
+
+struct bf16 {
+    std::uint16_t bits;
+
+    bf16() = default;
+
+    bf16(float value) : bits(from_float(value)) {}
+
+    operator float() const { return detail::bits_float(static_cast<std::uint32_t>(bits) << 16); }
+
+    static auto from_bits(std::uint16_t bits) -> bf16
+    {
+        bf16 value;
+        value.bits = bits;
+        return value;
+    }
+
+    static auto from_float(float value) -> std::uint16_t
+    {
+        std::uint32_t bits = detail::float_bits(value);
+        if ((bits & 0x7fffffffu) > 0x7f800000u) {
+            // keep NaNs NaNs, truncation could turn one into an infinity
+            return static_cast<std::uint16_t>((bits >> 16) | 0x40u);
+        }
+        bits += 0x7fffu + ((bits >> 16) & 1u);
+        return static_cast<std::uint16_t>(bits >> 16);
+    }
+};
+
+struct fp16 {
+    std::uint16_t bits;
+
+    fp16() = default;
+
+    fp16(float value) : bits(from_float(value)) {}
+
+    operator float() const
+    {
+        std::uint32_t const shifted_exponent = 0x7c00u << 13;
+        std::uint32_t bits32 = (bits & 0x7fffu) << 13;
+        std::uint32_t exponent = bits32 & shifted_exponent;
+        bits32 += (127u - 15u) << 23;
+        if (exponent == shifted_exponent) {
+            // inf and NaN
+            bits32 += (128u - 16u) << 23;
+        } else if (exponent == 0) {
+            // zero and subnormals, renormalized by float arithmetic
+            bits32 += 1u << 23;
+            bits32 = detail::float_bits(detail::bits_float(bits32) - detail::bits_float(113u << 23));
+        }
+        return detail::bits_float(bits32 | (static_cast<std::uint32_t>(bits & 0x8000u) << 16));
+    }
+
+    static auto from_bits(std::uint16_t bits) -> fp16
+    {
+        fp16 value;
+        value.bits = bits;
+        return value;
+    }
+
+    static auto from_float(float value) -> std::uint16_t
+    {
+        std::uint32_t bits = detail::float_bits(value);
+        std::uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        std::uint32_t result;
+        if (bits >= (127u + 16u) << 23) {
+            // too big for fp16, inf or NaN
+            result = bits > 0x7f800000u ? 0x7e00u : 0x7c00u;
+        } else if (bits < 113u << 23) {
+            // subnormal or zero, adding 0.5 lets the float unit do the rounding
+            float const magic = detail::bits_float(126u << 23);
+            result = detail::float_bits(detail::bits_float(bits) + magic) - (126u << 23);
+        } else {
+            std::uint32_t odd = (bits >> 13) & 1u;
+            bits += ((15u - 127u) << 23) + 0xfffu + odd;
+            result = bits >> 13;
+        }
+        return static_cast<std::uint16_t>(result | (sign >> 16));
+    }
+};
+
+template <typename T> inline constexpr bool is_half_v = std::is_same_v<T, bf16> || std::is_same_v<T, fp16>;
+
+// Bulk conversions of contiguous buffers, fp16 ones use F16C/AVX-512 instructions when the CPU has them. They run on
+// the calling thread, Tensor::cast() splits big tensors between threads.
+auto convert(float const *x, bf16 *out, size_type n) -> void;
+auto convert(bf16 const *x, float *out, size_type n) -> void;
+auto convert(float const *x, fp16 *out, size_type n) -> void;
+auto convert(fp16 const *x, float *out, size_type n) -> void;
+
+} // namespace ts
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "tensor/epilogue.hpp"
 #include "tensor/tensor.hpp"
 #include <tensor/nn/autograd/relu.hpp>
 #include <tensor/nn/autograd/tanh.hpp>
@@ -49,8 +50,6 @@ template <typename Element, int Dim> class Tanh : public ActivationBase<Element,
     Tensor<Element, Dim> _output;
 };
 
-enum class Activation { RELU, TANH, NONE };
-
 template <typename Element, int Dim> class ActivationFactory {
   public:
     using ActivationPtr = std::unique_ptr<ActivationBase<Element, Dim>>;
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "tensor/nn/saving_scope.hpp"
+#include "tensor/random.hpp"
+
+// Activation checkpointing. A computation of `steps` steps (layers of a stack, timesteps of a recurrent network) is
+// cut into segments of `segment_length` steps. Forward keeps only the input of every segment, the steps drop what
+// they would save for backward (their SavedTensors). Backward runs the forward of each segment again, this time with
+// saving on, goes back through it and releases its saved tensors before the previous segment. The last segment keeps
+// its activations from forward and isn't recomputed.
+//
+// Memory of activations goes from O(steps) to O(steps / segment_length + segment_length) at the cost of a second
+// forward of all but the last segment, sqrt(steps) is the sweet spot. Only what layers keep in SavedTensor is dropped:
+// FeedForward, im2col Conv2D, LSTM, LSTMCell and RNNCell.
+//
+// The steps are given as callables, state = forward(step, state) and d_state = backward(step, d_state). A forward
+// step must give the same results when run again: losses are stored per step rather than summed, and the generator
+// is rewound to where the segment started, so dropout masks are drawn again the same.
+
+namespace ts {
+
+template <typename State> class Checkpoint {
+  public:
+    // segment_length 0 turns checkpointing off
+    explicit Checkpoint(int segment_length = 0, Generator &generator = default_generator())
+        : _segment_length(segment_length), _generator(&generator)
+    {
+    }
+
+    [[nodiscard]] auto segment_length() const -> int { return _segment_length; }
+
+    auto set_segment_length(int segment_length) -> void { _segment_length = segment_length; }
+
+    template <typename Forward> auto forward(int steps, State const &input, Forward const &forward) -> State
+    {
+        _steps = steps;
+        _inputs.clear();
+        _offsets.clear();
+        State state = input;
+        for (int begin = 0; begin < steps; begin += length()) {
+            int end = std::min(begin + length(), steps);
+            _inputs.push_back(state);
+            _offsets.push_back(_generator->offset());
+            detail::SavingScope scope(end < steps, nullptr);
+            for (int step = begin; step < end; ++step) {
+                state = forward(step, state);
+            }
+        }
+        return state;
+    }
+
+    template <typename Forward, typename Backward>
+    auto backward(State const &d_output, Forward const &forward, Backward const &backward) -> State
+    {
+        std::uint64_t offset = _generator->offset();
+        State d_state = d_output;
+        for (int segment = static_cast<int>(_inputs.size()) - 1; segment >= 0; --segment) {
+            int begin = segment * length();
+            int end = std::min(begin + length(), _steps);
+            std::vector<detail::Saved *> saved;
+            if (end < _steps) {
+                _generator->set_offset(_offsets[segment]);
+                detail::SavingScope scope(false, &saved);
+                State state = _inputs[segment];
+                for (int step = begin; step < end; ++step) {
+                    state = forward(step, state);
+                }
+            }
+            for (int step = end - 1; step >= begin; --step) {
+                d_state = backward(step, d_state);
+            }
+            for (auto *tensor : saved) {
+                tensor->release();
+            }
+        }
+        _generator->set_offset(offset);
+        _inputs.clear();
+        return d_state;
+    }
+
+  private:
+    auto length() const -> int { return _segment_length > 0 ? _segment_length : std::max(_steps, 1); }
+
+    int _segment_length;
+    Generator *_generator;
+    int _steps = 0;
+    std::vector<State> _inputs{};
+    std::vector<std::uint64_t> _offsets{};
+};
+
+} // namespace ts
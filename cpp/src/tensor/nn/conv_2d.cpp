@@ -5,8 +5,8 @@
 #include "im2col.hpp"
 
 auto ts::conv_2d_im2col(ts::Tensor<float, 4> const &images, ts::Tensor<float, 2> const &kernel,
-                        ts::Tensor<float, 2> &im2col_buffer, int kernel_size, int stride, int pad, int dilatation)
-    -> ts::Tensor<float, 4>
+                        ts::Tensor<float, 2> &im2col_buffer, int kernel_size, int stride, int pad, int dilatation,
+                        ts::Epilogue const &epilogue) -> ts::Tensor<float, 4>
 {
     // we assume CHW image format
     ts::size_type batch_size = images.shape(0);
@@ -17,18 +17,17 @@ auto ts::conv_2d_im2col(ts::Tensor<float, 4> const &images, ts::Tensor<float, 2>
     ts::size_type C_out = kernel.shape(0);
 
     ts::size_type dim_out = ts::_calculate_output_dim(H, kernel_size, pad, stride, dilatation);
-    ts::Tensor<float, 3> results(batch_size, C_out, dim_out * dim_out);
+    ts::Tensor<float, 3> results({batch_size, C_out, dim_out * dim_out}, ts::uninitialized);
     auto const buffer_shape = ts::im2col::im2col_buffer_shape({C_in, H, W}, kernel_size, stride, pad, dilatation);
 
-    //#pragma omp parallel for // TODO: check if using OpenMP here will improve something
-    for (int b = 0; b < batch_size; ++b) {
-        auto buffer = ts::Tensor<float, 2>(buffer_shape);
+    ts::parallel_for_each(batch_size, [&](size_type b) {
+        auto buffer = ts::Tensor<float, 2>(buffer_shape, ts::uninitialized);
 
         auto image = images(b);
         auto result = results(b);
         ts::im2col::im2col(image, kernel_size, pad, stride, dilatation, buffer);
-        ts::dot(kernel, buffer, result, false, false);
-    }
+        ts::dot(kernel, buffer, result, epilogue);
+    });
     return results.reshape<4>({batch_size, C_out, dim_out, dim_out});
 }
 
@@ -39,8 +38,7 @@ auto ts::conv_2d(ts::Tensor<float, 4> const &images, ts::Tensor<float, 2> const
     uint dim_out = ts::_calculate_output_dim(images.shape(1), kernel_size, 0, stride, 1);
     ts::Tensor<float, 4> results(batch_size, dim_out, dim_out, kernel.shape(1));
 
-#pragma omp parallel for
-    for (int b = 0; b < batch_size; ++b) {
+    ts::parallel_for_each(batch_size, [&](size_type b) {
         auto image = images(b);
         auto result = results(b);
         for (size_type i = 0; i < dim_out; ++i) {
@@ -51,7 +49,7 @@ auto ts::conv_2d(ts::Tensor<float, 4> const &images, ts::Tensor<float, 2> const
                 std::copy(tile_output.begin(), tile_output.end(), result_begin);
             }
         }
-    }
+    });
     return results;
 }
 
@@ -107,19 +105,30 @@ auto ts::conv_2d_backward_im2col(ts::Tensor<float, 4> const &inputs, ts::Tensor<
     size_type dim_out = d_outputs.shape(2);
     auto d_outputs_reshaped = d_outputs.reshape<3>({batch_size, C_out, dim_out * dim_out});
 
-    //#pragma omp parallel for
-    for (int b = 0; b < batch_size; ++b) {
-        auto d_output = d_outputs_reshaped(b);
-        auto input = inputs(b);
-        auto d_input = d_inputs(b);
-
-        // backpropagate to input
-        ts::dot(kernel, d_output, im2col_buffer, true, false);
-        im2col::col2im(im2col_buffer, kernel_size, pad, stride, dilatation, d_input);
-
-        // backpropagate to weight
-        im2col::im2col(input, kernel_size, pad, stride, dilatation, im2col_buffer);
-        ts::dot(d_output, im2col_buffer, d_kernel, false, true, 1.0f);
+    // every thread works on its own part of the batch with its own buffer and its own copy of d_kernel, the copies
+    // are summed up at the end (always in the same order)
+    size_type threads = std::min(static_cast<size_type>(ts::max_threads()), static_cast<size_type>(batch_size));
+    std::vector<ts::Tensor<float, 2>> d_kernels(threads);
+    ts::parallel_for_each(threads, [&](size_type thread) {
+        auto buffer = thread == 0 ? im2col_buffer : ts::Tensor<float, 2>(im2col_buffer.shape(), ts::uninitialized);
+        auto d_kernel_part = thread == 0 ? d_kernel : ts::Tensor<float, 2>(kernel.shape());
+        for (size_type b = thread; b < batch_size; b += threads) {
+            auto d_output = d_outputs_reshaped(b);
+            auto input = inputs(b);
+            auto d_input = d_inputs(b);
+
+            // backpropagate to input
+            ts::dot(kernel, d_output, buffer, true, false);
+            im2col::col2im(buffer, kernel_size, pad, stride, dilatation, d_input);
+
+            // backpropagate to weight
+            im2col::im2col(input, kernel_size, pad, stride, dilatation, buffer);
+            ts::dot(d_output, buffer, d_kernel_part, false, true, 1.0f);
+        }
+        d_kernels[thread] = std::move(d_kernel_part);
+    });
+    for (size_type thread = 1; thread < threads; ++thread) {
+        ts::add_(d_kernel, d_kernels[thread]);
     }
     return std::make_tuple(std::move(d_inputs), std::move(d_kernel));
 }
@@ -136,24 +145,32 @@ auto ts::conv_2d_backward(ts::Tensor<float, 4> const &inputs, ts::Tensor<float,
     ts::Tensor<float, 4> d_inputs(batch_size, dim_in, dim_in, channels_in);
     ts::Tensor<float, 2> d_kernel(kernel_size * kernel_size * channels_in, channels_out);
 
-#pragma omp parallel for
-    for (int b = 0; b < batch_size; ++b) {
-        auto d_output = d_outputs(b);
-        auto input = inputs(b);
-        auto d_input = d_inputs(b);
-        for (int i = 0; i < d_output.shape(0); ++i) {
-            for (int j = 0; j < d_output.shape(1); ++j) {
-                ts::VectorF d_tile = d_output(i, j);
-                ts::VectorF tile = _get_flatten_tile(input, kernel_size, i * stride, j * stride);
-
-                auto d_tile_input = ts::dot(kernel, d_tile);
-                _add_flatten_tile(d_input, d_tile_input, kernel_size, i * stride, j * stride);
-
-                auto d_tile_kernel = ts::outer_product(tile, d_tile);
-#pragma omp critical
-                ts::add_(d_kernel, d_tile_kernel);
+    // same as in conv_2d_backward_im2col, every thread accumulates its own d_kernel
+    size_type threads = std::min(static_cast<size_type>(ts::max_threads()), static_cast<size_type>(batch_size));
+    std::vector<ts::Tensor<float, 2>> d_kernels(threads);
+    ts::parallel_for_each(threads, [&](size_type thread) {
+        auto d_kernel_part = thread == 0 ? d_kernel : ts::Tensor<float, 2>(d_kernel.shape());
+        for (size_type b = thread; b < batch_size; b += threads) {
+            auto d_output = d_outputs(b);
+            auto input = inputs(b);
+            auto d_input = d_inputs(b);
+            for (int i = 0; i < d_output.shape(0); ++i) {
+                for (int j = 0; j < d_output.shape(1); ++j) {
+                    ts::VectorF d_tile = d_output(i, j);
+                    ts::VectorF tile = _get_flatten_tile(input, kernel_size, i * stride, j * stride);
+
+                    auto d_tile_input = ts::dot(kernel, d_tile);
+                    _add_flatten_tile(d_input, d_tile_input, kernel_size, i * stride, j * stride);
+
+                    auto d_tile_kernel = ts::outer_product(tile, d_tile);
+                    ts::add_(d_kernel_part, d_tile_kernel);
+                }
             }
         }
+        d_kernels[thread] = std::move(d_kernel_part);
+    });
+    for (size_type thread = 1; thread < threads; ++thread) {
+        ts::add_(d_kernel, d_kernels[thread]);
     }
     return std::make_tuple(std::move(d_inputs), std::move(d_kernel));
 }
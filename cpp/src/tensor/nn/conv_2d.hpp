@@ -1,13 +1,16 @@
 #pragma once
 
+#include <tensor/epilogue.hpp>
 #include <tensor/tensor_forward.hpp>
 #include <tuple>
 
 namespace ts {
 
+// The epilogue works on the output of every sample as a [C_out, H_out * W_out] matrix, a per channel bias has
+// bias_axis 0
 auto conv_2d_im2col(ts::Tensor<float, 4> const &images, ts::Tensor<float, 2> const &kernel,
-                    ts::Tensor<float, 2> &im2col_buffer, int kernel_size, int stride, int pad, int dilatation)
-    -> ts::Tensor<float, 4>;
+                    ts::Tensor<float, 2> &im2col_buffer, int kernel_size, int stride, int pad, int dilatation,
+                    Epilogue const &epilogue = {}) -> ts::Tensor<float, 4>;
 
 auto conv_2d(ts::Tensor<float, 4> const &images, ts::Tensor<float, 2> const &kernel, int kernel_size, size_type stride)
     -> ts::Tensor<float, 4>;
@@ -18,8 +18,7 @@ auto ts::_get_flatten_tile(Tensor<float, 4> const &images, int size, int row, in
         MatrixF tile(std::pow(size, 2), image.shape(2));
         for (int i = 0; i < size; ++i) {
             for (int j = 0; j < size; ++j) {
-                VectorF vec = image(i + row, j + col);
-                std::copy(vec.begin(), vec.end(), tile(j + i * size).begin());
+                tile(j + i * size).assign(image(i + row, j + col));
             }
         }
         tiles.push_back(std::move(tile.flatten()));
@@ -68,9 +67,7 @@ auto ts::_get_tile(Tensor<Element, 3> const &image, size_type size, size_type ro
     Tensor<Element, 3> tile(size, size, image.shape(2));
     for (size_type i = 0; i < size; ++i) {
         for (size_type j = 0; j < size; ++j) {
-            auto [vec_begin, vec_end] = image.get_subarray({i + row, j + col});
-            auto [tile_begin, tile_end] = tile.get_subarray({i, j});
-            std::copy(vec_begin, vec_end, tile_begin);
+            tile(i, j).assign(image(i + row, j + col));
         }
     }
     return tile;
@@ -81,8 +78,7 @@ auto ts::_set_tile(Tensor<Element, 3> &image, Tensor<Element, 3> const &tile, in
 {
     for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
-            auto vec = tile(i, j);
-            std::copy(vec.begin(), vec.end(), image(i + row, j + col).begin());
+            image(i + row, j + col).assign(tile(i, j));
         }
     }
 }
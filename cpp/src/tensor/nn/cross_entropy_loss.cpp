@@ -15,13 +15,15 @@ auto ts::CrossEntropyLoss::forward(const ts::MatrixF &logits, ts::Tensor<int, 1>
     return -ts::sum(log_probs) / static_cast<float>(log_probs.shape(0));
 }
 
-auto ts::CrossEntropyLoss::backward() -> ts::MatrixF
+auto ts::CrossEntropyLoss::backward(float scale) -> ts::MatrixF
 {
-    auto d_scores = ts::apply_if(
-        _scores, ts::to_one_hot(_labels, _scores.shape(1) - 1), (Fn<float>)[](float e) { return e - 1.0f; });
+    auto d_scores =
+        ts::apply_if(_scores, ts::to_one_hot(_labels, _scores.shape(1) - 1), [](float e) { return e - 1.0f; });
     if (size_type batch_size = _scores.shape(0); batch_size > 1) {
-        d_scores = ts::apply(
-            d_scores, (Fn<float>)[&](float e) { return e / static_cast<float>(batch_size); });
+        d_scores = ts::apply(d_scores, [&](float e) { return e / static_cast<float>(batch_size); });
+    }
+    if (scale != 1.0f) {
+        d_scores = ts::multiply(d_scores, scale);
     }
     return d_scores;
 }
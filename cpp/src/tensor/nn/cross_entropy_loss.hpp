@@ -12,7 +12,8 @@ class CrossEntropyLoss {
 
     auto forward(MatrixF const &probs, Tensor<int, 1> const &labels) -> float;
 
-    auto backward() -> MatrixF;
+    // Gradient of the loss times `scale` (see LossScaler)
+    auto backward(float scale = 1.0f) -> MatrixF;
 
   private:
     Tensor<int, 1> _labels;
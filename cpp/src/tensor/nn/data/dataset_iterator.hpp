@@ -13,6 +13,7 @@ class DatasetIterator {
     int _index = 0;
 
   public:
+    // batches are views of the dataset, clone() them before writing into them
     using return_type = std::pair<ts::Tensor<float, 2>, ts::Tensor<int, 1>>;
 
     typedef std::forward_iterator_tag iterator_category;
@@ -1,15 +1,18 @@
 #pragma once
 
+#include <iterator>
 #include <memory>
 #include <string>
 
 #include "tensor/data_holder.hpp"
+#include "tensor/nn/row_sparse_grad.hpp"
 
 namespace ts {
 
 template <typename Element> class GradHolder {
   public:
     using DataHolderRef = DataHolder<Element> &;
+    using data_ptr_t = typename DataHolder<Element>::data_ptr_t;
 
     virtual auto grad() -> DataHolderRef = 0;
 
@@ -17,8 +20,24 @@ template <typename Element> class GradHolder {
 
     virtual auto name() -> std::string { return _name; };
 
+    // Number of elements of the weight (and of the gradient)
+    virtual auto size() -> size_type { return std::distance(tensor().begin(), tensor().end()); }
+
+    // Moves the weight and the gradient into buffers shared with other parameters, at `offset` of both of them (see
+    // ParameterRegistry::pack), values are copied over. Holders which manage their memory on their own return false.
+    virtual auto move_to(data_ptr_t, data_ptr_t, size_type) -> bool { return false; }
+
+    // Whether move_to() would succeed, pack() asks every parameter before it moves any of them
+    virtual auto can_move() -> bool { return false; }
+
+    // Weights buffer of the arena the holder was last moved into, nullptr if it manages its memory
+    virtual auto arena() -> data_ptr_t { return nullptr; }
+
+    // The gradient as rows when it's kept row-sparse, nullptr when grad() is used
+    virtual auto sparse_grad() -> RowSparseGrad<Element> * { return nullptr; }
+
   private:
     std::string _name = "GradHolder";
 };
 
-} // namespace ts
\ No newline at end of file
+} // namespace ts
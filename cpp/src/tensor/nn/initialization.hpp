@@ -1,48 +1,46 @@
 #pragma once
+#include <tensor/random.hpp>
 #include <tensor/tensor.hpp>
 
 namespace ts {
 
-template <typename Element, int Dim> auto kaiming_uniform(std::vector<int> const &shape) -> Tensor<Element, Dim>
+template <typename Element, int Dim>
+auto kaiming_uniform(std::vector<int> const &shape, Generator &generator = default_generator()) -> Tensor<Element, Dim>
 {
-    std::default_random_engine random(69);
     float fan_in = shape[0];
 
     float gain = (float)(M_SQRT2) / std::sqrt(fan_in);
     float std = gain / std::sqrt(fan_in);
     float bound = std::sqrt(3.0f) * std;
-    std::uniform_real_distribution<Element> dist{-bound, bound};
 
     std::array<size_type, Dim> array_shape;
     std::copy(shape.begin(), shape.end(), array_shape.begin());
-    Tensor<Element, Dim> tensor(array_shape);
-    std::generate(tensor.begin(), tensor.end(), [&dist, &random]() { return dist(random); });
+    Tensor<Element, Dim> tensor(array_shape, uninitialized);
+    ts::uniform_(tensor, Element(-bound), Element(bound), generator);
     return tensor;
 }
 
 template <typename Element, int Dim>
-auto standard_normal(std::vector<int> const &shape, Element scale) -> Tensor<Element, Dim>
+auto standard_normal(std::vector<int> const &shape, Element scale, Generator &generator = default_generator())
+    -> Tensor<Element, Dim>
 {
-    std::default_random_engine random(69);
-    std::normal_distribution<Element> dist;
-
     std::array<size_type, Dim> array_shape;
     std::copy(shape.begin(), shape.end(), array_shape.begin());
-    Tensor<Element, Dim> tensor(array_shape);
-    std::generate(tensor.begin(), tensor.end(), [&dist, &random, &scale]() { return scale * dist(random); });
+    Tensor<Element, Dim> tensor(array_shape, uninitialized);
+    ts::normal_(tensor, Element(0), scale, generator);
     return tensor;
 }
 
-template <typename Element, int Dim> auto uniform(std::vector<int> const &shape, int fan_out) -> Tensor<Element, Dim>
+template <typename Element, int Dim>
+auto uniform(std::vector<int> const &shape, int fan_out, Generator &generator = default_generator())
+    -> Tensor<Element, Dim>
 {
-    std::default_random_engine random(69);
     float bound = 1.0f / std::sqrt(fan_out);
-    std::uniform_real_distribution<Element> dist{-bound, bound};
 
     std::array<size_type, Dim> array_shape;
     std::copy(shape.begin(), shape.end(), array_shape.begin());
-    Tensor<Element, Dim> tensor(array_shape);
-    std::generate(tensor.begin(), tensor.end(), [&dist, &random]() { return dist(random); });
+    Tensor<Element, Dim> tensor(array_shape, uninitialized);
+    ts::uniform_(tensor, Element(-bound), Element(bound), generator);
     return tensor;
 }
 
@@ -63,16 +61,14 @@ template <typename Element, int Dim> auto ones(std::vector<int> const &shape) ->
     return tensor;
 }
 
-template <typename Element, int Dim> auto bernoulli(std::vector<int> const &shape, float p) -> Tensor<Element, Dim>
+template <typename Element, int Dim>
+auto bernoulli(std::vector<int> const &shape, float p, Generator &generator = default_generator())
+    -> Tensor<Element, Dim>
 {
-    std::default_random_engine random(69);
-    std::bernoulli_distribution dist(p);
-
     std::array<size_type, Dim> array_shape;
     std::copy(shape.begin(), shape.end(), array_shape.begin());
-    Tensor<Element, Dim> tensor(array_shape);
-    std::generate(tensor.begin(), tensor.end(), [&dist, &random]() { return Element(dist(random)); });
-
+    Tensor<Element, Dim> tensor(array_shape, uninitialized);
+    ts::bernoulli_(tensor, p, generator);
     return tensor;
 }
 
@@ -21,117 +21,55 @@ class BatchNormalization2D : public ParameterRegistry<float> {
         // input: [batch_size, channel_in, height, width]
         auto [B, C, H, W] = input.shape();
 
-        // compute statistics along C axis
-        VectorF mean(C);
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                mean.at(c) += ts::sum(input(b, c));
-            }
-        }
-        ts::multiply(mean, static_cast<float>(1.0 / (B * H * W)));
-
-        _var = VectorF(C);
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                _var(c) +=
-                    ts::sum(ts::apply<float>(input(b, c), [&](float const &e) { return std::pow(e - mean.at(c), 2); }));
-            }
-        }
-        ts::multiply(_var, static_cast<float>(1.0 / (B * H * W)));
+        // statistics of every channel over the batch and the image, first per sample then over the batch
+        auto samples = input.reshape<3>({B, C, H * W});
+        auto sample_mean = ts::mean(samples, 2);
+        auto mean = ts::mean(sample_mean, 0);
+        // variance of the whole channel is the mean of sample variances plus the variance of sample means
+        _var = ts::add(ts::mean(ts::variance(samples, 2), 0), ts::variance(sample_mean, 0));
 
         _update_running_variables(mean, _var);
 
         _stddev = ts::apply<float>(_var, [this](auto const &e) { return std::sqrt(e + _epsilon); });
 
-        _input_centered = input.clone();
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                ts::apply_<float>(_input_centered(b, c), [&](float const &e) { return e - mean.at(c); });
-            }
-        }
-
-        _input_normalized = _input_centered.clone();
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                ts::apply_<float>(_input_normalized(b, c),
-                                  [&, this](float const &e) { return e / (_stddev.at(c) + _epsilon); });
-            }
-        }
-
-        auto input_scaled = _input_normalized.clone();
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                ts::apply_<float>(input_scaled(b, c), [&, this](float const &e) {
-                    return _gamma.tensor().at(c) * e + _bias.tensor().at(c);
-                });
-            }
-        }
-        return input_scaled;
+        _input_centered = ts::subtract(input, _per_channel(mean));
+        _input_normalized = ts::divide(_input_centered, _per_channel(ts::add(_stddev, _epsilon)));
+        auto output = ts::multiply(_input_normalized, _per_channel(_gamma.tensor()));
+        ts::add_(output, _per_channel(_bias.tensor()));
+        return output;
     }
 
     auto backward(Tensor<float, 4> const &d_output) -> Tensor<float, 4>
     {
         auto [B, C, H, W] = d_output.shape();
+        auto n = static_cast<float>(B * H * W);
         _bias.grad() += _sum_channel_wise(d_output);
         _gamma.grad() += _sum_channel_wise(ts::multiply(_input_normalized, d_output));
 
-        auto d_normalized = Tensor<float, 4>(d_output.shape());
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                ts::apply_<float>(d_normalized(b, c), [&, this](float const &e) { return _gamma.tensor().at(c) * e; });
-            }
-        }
-
-        auto d_var = VectorF(_var.shape());
-        auto pow_var = ts::pow(_var, -3.0f / 2.0f);
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                d_var(c) += ts::sum(
-                    ts::apply<float>(d_normalized(b, c), _input_centered(b, c),
-                                     [&](float const &e1, float const &e2) { return e1 * e2 * -0.5 * pow_var.at(c); }));
-            }
-        }
-        ts::multiply(d_var, static_cast<float>(1.0 / (B * H * W)));
-
-        int batch_size = B;
-        auto aux_input_centered =
-            ts::apply<float>(_input_centered, [batch_size](auto const &e) { return 2 * e / batch_size; });
+        auto d_normalized = ts::multiply(d_output, _per_channel(_gamma.tensor()));
         auto stddev_inv = ts::apply<float>(_stddev, [](auto const &e) { return 1.0f / e; });
 
-        auto d_mean = VectorF(_var.shape());
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                d_mean(c) += ts::sum(ts::apply<float>(
-                    d_normalized(b, c), aux_input_centered(b, c),
-                    [&](float const &e1, float const &e2) { return e1 * -stddev_inv.at(c) + -e2 * d_var.at(c); }));
-            }
-        }
+        auto d_var = ts::multiply(_sum_channel_wise(ts::multiply(d_normalized, _input_centered)),
+                                  ts::multiply(ts::pow(_var, -3.0f / 2.0f), -0.5f));
+        auto d_mean = ts::subtract(ts::multiply(_sum_channel_wise(d_normalized), ts::multiply(stddev_inv, -1.0f)),
+                                   ts::multiply(d_var, ts::multiply(_sum_channel_wise(_input_centered), 2.0f / n)));
 
-        auto d_input = Tensor<float, 4>(d_output.shape());
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                for (int h = 0; h < H; ++h) {
-                    for (int w = 0; w < W; ++w) {
-                        d_input.at({b, c, h, w}) = d_normalized.at({b, c, h, w}) * stddev_inv.at(c) +
-                                                   d_var.at(c) * aux_input_centered.at({b, c, h, w}) +
-                                                   d_mean.at(c) / batch_size;
-                    }
-                }
-            }
-        }
+        auto d_input = ts::multiply(d_normalized, _per_channel(stddev_inv));
+        ts::add_(d_input, ts::multiply(_input_centered, _per_channel(ts::multiply(d_var, 2.0f / n))));
+        ts::add_(d_input, _per_channel(ts::multiply(d_mean, 1.0f / n)));
         return d_input;
     }
 
+    // [C] seen as [1, C, 1, 1], broadcasts over the batch and the image
+    static auto _per_channel(VectorF const &values) -> Tensor<float, 4>
+    {
+        return values.reshape<4>({1, values.shape(0), 1, 1});
+    }
+
     auto _sum_channel_wise(Tensor<float, 4> const &input) -> VectorF
     {
         auto [B, C, H, W] = input.shape();
-        auto result = VectorF(C);
-        for (int b = 0; b < B; ++b) {
-            for (int c = 0; c < C; ++c) {
-                result.at(c) += ts::sum(input(b, c));
-            }
-        }
-        return result;
+        return ts::sum(ts::sum(input.reshape<3>({B, C, H * W}), 2), 0);
     }
 
     auto _update_running_variables(VectorF const &mean, VectorF const &var) -> void
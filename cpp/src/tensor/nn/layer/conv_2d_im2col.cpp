@@ -5,7 +5,7 @@
 
 ts::im2col::Conv2D::Conv2D(Variable<float, 2> weight, std::optional<Variable<float, 1>> bias, int kernel_size,
                            int stride, int pad, int dilatation, Activation activation)
-    : _weight(std::move(weight)), _bias(std::move(bias)), _activation(Activations::get(activation)), _stride(stride),
+    : _weight(std::move(weight)), _bias(std::move(bias)), _activation_type(activation), _stride(stride),
       _kernel_size(kernel_size), _pad(pad), _dilatation(dilatation)
 {
     register_parameters(_weight);
@@ -32,45 +32,39 @@ auto ts::im2col::Conv2D::operator()(ts::Tensor<float, 4> const &input) -> Tensor
 
 auto ts::im2col::Conv2D::forward(ts::Tensor<float, 4> const &input) -> ts::Tensor<float, 4>
 {
-    _input = input;
+    _input.save(input, _precision);
 
     auto const im2col_buffer_shape = ts::im2col::im2col_buffer_shape({input.shape(1), input.shape(2), input.shape(3)},
                                                                      _kernel_size, _stride, _pad, _dilatation);
     if (_im2col_buffer.data() == nullptr || _im2col_buffer.shape() != im2col_buffer_shape) {
-        _im2col_buffer = Tensor<float, 2>(im2col_buffer_shape);
+        _im2col_buffer = Tensor<float, 2>(im2col_buffer_shape, uninitialized);
     }
-    auto output = ts::conv_2d_im2col(input, _weight.tensor(), _im2col_buffer, _kernel_size, _stride, _pad, _dilatation);
-    if (_bias.has_value()) {
-        for (int b = 0; b < output.shape(0); ++b) {
-            ts::add_(output(b), _bias.value().tensor());
-        }
-    }
-    if (_activation) {
-        output = _activation.value()->forward(output);
-    }
-    return output;
+    auto output = ts::conv_2d_im2col(input, _weight.tensor(), _im2col_buffer, _kernel_size, _stride, _pad,
+                                     _dilatation, epilogue());
+    _output.save(output, _precision);
+    return _precision == Precision::FLOAT ? output : _output.load();
 }
 
 auto ts::im2col::Conv2D::backward(ts::Tensor<float, 4> const &d_output) -> ts::Tensor<float, 4>
 {
-    auto d_output_(d_output); // cheap, not a deep copy
-    if (_activation) {
-        d_output_ = _activation.value()->backward(d_output_);
-    }
-    auto [d_input, d_weight] = ts::conv_2d_backward_im2col(_input, _weight.tensor(), _im2col_buffer, d_output_,
-                                                           _kernel_size, _stride, _pad, _dilatation);
+    // back through the activation and the bias in one pass over [B, C, H * W]
+    auto [B, C, H, W] = d_output.shape();
+    auto d_product = ts::epilogue_backward(_output.load().reshape<3>({B, C, H * W}),
+                                           d_output.reshape<3>({B, C, H * W}), epilogue(),
+                                           _bias.has_value() ? &_bias.value().grad() : nullptr);
+    auto [d_input, d_weight] =
+        ts::conv_2d_backward_im2col(_input.load(), _weight.tensor(), _im2col_buffer,
+                                    d_product.reshape<4>({B, C, H, W}), _kernel_size, _stride, _pad, _dilatation);
     _weight.grad() += d_weight;
+    return ts::round_to(d_input, _precision);
+}
 
+auto ts::im2col::Conv2D::epilogue() -> Epilogue
+{
     if (_bias.has_value()) {
-        for (int b = 0; b < d_output.shape(0); ++b) {
-            for (int i = 0; i < d_output.shape(1); ++i) {
-                for (int j = 0; j < d_output.shape(2); ++j) {
-                    ts::add_(_bias.value().grad(), d_output(b, i, j));
-                }
-            }
-        }
+        return {_bias.value().tensor(), 0, _activation_type};
     }
-    return std::move(d_input);
+    return {std::nullopt, 0, _activation_type};
 }
 
 auto ts::im2col::Conv2D::weight() -> ts::Variable<float, 2> & { return _weight; }
@@ -84,6 +78,20 @@ auto ts::im2col::Conv2D::bias() -> std::optional<std::reference_wrapper<ts::Vari
     }
 }
 
+auto ts::im2col::Conv2D::kernel_size() const -> int { return _kernel_size; }
+
+auto ts::im2col::Conv2D::stride() const -> int { return _stride; }
+
+auto ts::im2col::Conv2D::pad() const -> int { return _pad; }
+
+auto ts::im2col::Conv2D::dilatation() const -> int { return _dilatation; }
+
+auto ts::im2col::Conv2D::activation() const -> Activation { return _activation_type; }
+
+auto ts::im2col::Conv2D::set_precision(Precision precision) -> void { _precision = precision; }
+
+auto ts::im2col::Conv2D::precision() const -> Precision { return _precision; }
+
 auto ts::im2col::Conv2D::weights() -> VectorRef
 {
     std::vector<std::reference_wrapper<ts::GradHolder<float>>> vars;
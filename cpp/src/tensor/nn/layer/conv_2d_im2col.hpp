@@ -3,6 +3,7 @@
 #include <tensor/tensor.hpp>
 
 #include "tensor/nn/activations.hpp"
+#include "tensor/nn/mixed_precision.hpp"
 #include "tensor/nn/parameters_registry.hpp"
 #include "tensor/nn/variable.hpp"
 
@@ -28,19 +29,39 @@ class Conv2D : public ParameterRegistry<float> {
 
     auto weights() -> VectorRef;
 
+    auto kernel_size() const -> int;
+
+    auto stride() const -> int;
+
+    auto pad() const -> int;
+
+    auto dilatation() const -> int;
+
+    auto activation() const -> Activation;
+
+    // Precision of the activations kept for backward and of the outputs and input gradients (see mixed_precision.hpp)
+    auto set_precision(Precision precision) -> void;
+
+    auto precision() const -> Precision;
+
   private:
     Conv2D(Variable<float, 2> weight, std::optional<Variable<float, 1>> bias, int kernel_size, int stride, int pad,
            int dilatation, Activation activation = Activation::NONE);
 
+    // bias and activation done by the product, one bias value per output channel
+    auto epilogue() -> Epilogue;
+
     Variable<float, 2> _weight;
     std::optional<Variable<float, 1>> _bias;
-    Activations::OptActivationPtr _activation;
+    Activation _activation_type;
     int _stride;
     int _kernel_size;
     int _pad;
     int _dilatation;
+    Precision _precision = Precision::FLOAT;
 
-    Tensor<float, 4> _input{};
+    SavedTensor<4> _input{};
+    SavedTensor<4> _output{};
     Tensor<float, 2> _im2col_buffer{};
 };
 
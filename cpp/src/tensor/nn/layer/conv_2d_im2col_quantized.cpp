@@ -0,0 +1,46 @@
+#include "conv_2d_im2col_quantized.hpp"
+#include "tensor/nn/autograd/tanh.hpp"
+#include "tensor/nn/conv_2d_helpers.hpp"
+#include "tensor/nn/im2col.hpp"
+
+namespace ts::im2col {
+
+QuantizedConv2D::QuantizedConv2D(Conv2D &layer, RangeObserver const &inputs)
+    : _weight(quantize_weights(layer.weight().tensor().permute({1, 0}))), _activation(layer.activation()),
+      _input_scale(inputs.scale()), _kernel_size(layer.kernel_size()), _stride(layer.stride()), _pad(layer.pad()),
+      _dilatation(layer.dilatation())
+{
+    if (auto bias = layer.bias(); bias.has_value()) {
+        _bias = VectorF(bias.value().get().tensor(), true);
+    }
+}
+
+auto QuantizedConv2D::operator()(Tensor<float, 4> const &input) -> Tensor<float, 4> { return forward(input); }
+
+auto QuantizedConv2D::forward(Tensor<float, 4> const &input) -> Tensor<float, 4>
+{
+    // CHW images, same as Conv2D
+    size_type batch_size = input.shape(0);
+    size_type C_out = _weight.columns;
+    size_type dim_out = _calculate_output_dim(input.shape(2), _kernel_size, _pad, _stride, _dilatation);
+    auto const buffer_shape = im2col_buffer_shape({input.shape(1), input.shape(2), input.shape(3)}, _kernel_size,
+                                                  _stride, _pad, _dilatation);
+
+    Tensor<float, 3> results({batch_size, C_out, dim_out * dim_out}, uninitialized);
+    parallel_for_each(batch_size, [&](size_type b) {
+        MatrixF buffer(buffer_shape, uninitialized);
+        auto image = input(b);
+        im2col(image, _kernel_size, _pad, _stride, _dilatation, buffer);
+        // pixels are rows of the product, it comes out as HW x C_out
+        auto y = quantized_dot(buffer.permute({1, 0}), _input_scale, _weight, _bias, _activation == Activation::RELU);
+        results(b).assign(y.permute({1, 0}));
+    });
+
+    auto output = results.reshape<4>({batch_size, C_out, dim_out, dim_out});
+    if (_activation == Activation::TANH) {
+        output = ts::tanh(output);
+    }
+    return output;
+}
+
+} // namespace ts::im2col
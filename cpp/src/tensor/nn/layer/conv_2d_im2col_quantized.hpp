@@ -0,0 +1,31 @@
+#pragma once
+
+#include <optional>
+
+#include "tensor/nn/layer/conv_2d_im2col.hpp"
+#include "tensor/quantization.hpp"
+
+namespace ts::im2col {
+
+// Inference-only int8 copy of an im2col Conv2D layer. Kernels are quantized per output channel, inputs with the scale
+// of a RangeObserver fed with calibration images. The bias is added per output channel.
+class QuantizedConv2D {
+  public:
+    QuantizedConv2D(Conv2D &layer, RangeObserver const &inputs);
+
+    auto operator()(Tensor<float, 4> const &) -> Tensor<float, 4>;
+
+    auto forward(Tensor<float, 4> const &) -> Tensor<float, 4>;
+
+  private:
+    QuantizedMatrix _weight;
+    std::optional<VectorF> _bias = std::nullopt;
+    Activation _activation;
+    float _input_scale;
+    int _kernel_size;
+    int _stride;
+    int _pad;
+    int _dilatation;
+};
+
+} // namespace ts::im2col
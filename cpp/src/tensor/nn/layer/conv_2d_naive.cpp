@@ -34,9 +34,9 @@ auto ts::naive::Conv2D::forward(const ts::Tensor<float, 4> &input) -> ts::Tensor
     _input = input;
     auto output = ts::conv_2d(input, _weight.tensor(), _kernel_size, _stride);
     if (_bias.has_value()) {
-        for (int b = 0; b < output.shape(0); ++b) {
-            ts::add_(output(b), _bias.value().tensor());
-        }
+        // one value per output channel
+        auto const &bias = _bias.value().tensor();
+        ts::add_(output, bias.reshape<4>({1, bias.shape(0), 1, 1}));
     }
     if (_activation) {
         output = _activation.value()->forward(output);
@@ -54,13 +54,8 @@ auto ts::naive::Conv2D::backward(const ts::Tensor<float, 4> &d_output) -> ts::Te
     _weight.grad() += d_weight;
 
     if (_bias.has_value()) {
-        for (int b = 0; b < d_output.shape(0); ++b) {
-            for (int i = 0; i < d_output.shape(1); ++i) {
-                for (int j = 0; j < d_output.shape(2); ++j) {
-                    ts::add_(_bias.value().grad(), d_output(b, i, j));
-                }
-            }
-        }
+        auto [B, C, H, W] = d_output_.shape();
+        _bias.value().grad() += ts::sum(ts::sum(d_output_.reshape<3>({B, C, H * W}), 2), 0);
     }
     return std::move(d_input);
 }
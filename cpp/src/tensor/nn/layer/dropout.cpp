@@ -1,16 +1,19 @@
 #include "dropout.hpp"
+#include "tensor/simd.hpp"
 
-ts::Dropout::Dropout(float keep_probability) : _p(keep_probability) {}
+ts::Dropout::Dropout(float keep_probability, Generator &generator) : _p(keep_probability), _generator(&generator) {}
 
 auto ts::Dropout::operator()(const ts::MatrixF &input) -> ts::MatrixF { return forward(input); }
 
 auto ts::Dropout::forward(const ts::MatrixF &input) -> ts::MatrixF
 {
-    // TODO: change input parameters in initialization.hpp to std::array
-    int dim0 = input.shape(0);
-    int dim1 = input.shape(1);
-    _weight = ts::multiply(ts::bernoulli<float, 2>({dim0, dim1}, _p),
-                           1.0f / (1.0f - _p));
+    // the mask of the previous batch is overwritten when the shape is the same
+    if (_weight.shape() != input.shape()) {
+        _weight = MatrixF(input.shape(), uninitialized);
+    }
+    ts::bernoulli_(_weight, _p, *_generator);
+    float *weight = _weight.raw_data_mutable();
+    ts::simd::kernels().multiply_scalar(weight, 1.0f / (1.0f - _p), weight, _weight.data_size());
 
     return ts::multiply(input, _weight);
 }
@@ -7,7 +7,8 @@ namespace ts {
 
 class Dropout {
   public:
-    explicit Dropout(float keep_probability);
+    // A new mask is drawn from the generator on every forward
+    explicit Dropout(float keep_probability, Generator &generator = default_generator());
 
     auto operator()(MatrixF const &input) -> MatrixF;
 
@@ -17,6 +18,7 @@ class Dropout {
 
   private:
     float _p;
+    Generator *_generator;
 
     MatrixF _weight{};
 };
@@ -0,0 +1,104 @@
+#include "embedding.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+#include "tensor/nn/initialization.hpp"
+#include "tensor/parallel.hpp"
+#include "tensor/simd.hpp"
+
+namespace ts {
+
+namespace {
+
+// Indices are token ids from data, a bad one would read out of the table in forward and write out of it in backward
+auto check_indices(int const *index, size_type count, size_type rows) -> void
+{
+    for (size_type i = 0; i < count; ++i) {
+        if (index[i] < 0 || static_cast<size_type>(index[i]) >= rows) {
+            std::cerr << "Embedding: index " << index[i] << " is out of range [0, " << rows << ")" << std::endl;
+            exit(-1);
+        }
+    }
+}
+
+} // namespace
+
+Embedding::Embedding(int num_embeddings, int dim)
+    : Embedding(Variable<float, 2>(
+          std::make_unique<ts::MatrixF>(ts::standard_normal<float, 2>({num_embeddings, dim}, 1.0f)),
+          std::make_unique<ts::MatrixF>(ts::zeros<float, 2>({num_embeddings, dim})), "Embedding(weight)"))
+{
+}
+
+Embedding::Embedding(Variable<float, 2> weight) : _weight(std::move(weight)) { register_parameters(_weight); }
+
+auto Embedding::create(int num_embeddings, int dim) -> Embedding { return Embedding(num_embeddings, dim); }
+
+auto Embedding::operator()(VectorI const &indices) -> MatrixF { return forward(indices); }
+
+auto Embedding::forward(VectorI const &indices) -> MatrixF
+{
+    _indices = indices.contiguous();
+    return lookup(_indices);
+}
+
+auto Embedding::lookup(VectorI const &indices) const -> MatrixF
+{
+    auto contiguous_indices = indices.contiguous();
+    auto const &weight = _weight.tensor();
+    size_type count = contiguous_indices.shape(0);
+    size_type dim = weight.shape(1);
+    MatrixF output({count, dim}, uninitialized);
+
+    float const *w = weight.raw_data();
+    int const *index = contiguous_indices.raw_data();
+    float *out = output.raw_data_mutable();
+    check_indices(index, count, weight.shape(0));
+    size_type chunks = std::min(detail::parallel_chunks(count * dim), std::max<size_type>(count, 1));
+    detail::run_chunks(count, chunks, 1, [&](size_type, size_type begin, size_type end) {
+        for (size_type i = begin; i < end; ++i) {
+            std::copy(w + index[i] * dim, w + (index[i] + 1) * dim, out + i * dim);
+        }
+    });
+    return round_to(output, _precision);
+}
+
+auto Embedding::backward(MatrixF const &d_output) -> void
+{
+    auto d = d_output.contiguous();
+    size_type count = _indices.shape(0);
+    size_type dim = d.shape(1);
+    assert(d.shape(0) == count && dim == _weight.tensor().shape(1));
+    int const *index = _indices.raw_data();
+    float const *d_rows = d.raw_data();
+
+    if (auto *sparse = _weight.sparse_grad(); sparse != nullptr) {
+        for (size_type i = 0; i < count; ++i) {
+            sparse->add(index[i], d_rows + i * dim);
+        }
+        return;
+    }
+
+    float *grad = _weight.grad().raw_data_mutable();
+    auto const &kernels = simd::kernels();
+    // threads take columns rather than indices, repeated indices don't race and rows are summed up in a fixed order
+    size_type chunks = std::min(detail::parallel_chunks(count * dim),
+                                std::max<size_type>(dim / elements_per_cache_line<float>, 1));
+    detail::run_chunks(dim, chunks, elements_per_cache_line<float>, [&](size_type, size_type begin, size_type end) {
+        for (size_type i = 0; i < count; ++i) {
+            float *row = grad + index[i] * dim;
+            kernels.add(row + begin, d_rows + i * dim + begin, row + begin, end - begin);
+        }
+    });
+}
+
+auto Embedding::weight() -> Variable<float, 2> & { return _weight; }
+
+auto Embedding::set_precision(Precision precision) -> void { _precision = precision; }
+
+auto Embedding::precision() const -> Precision { return _precision; }
+
+} // namespace ts
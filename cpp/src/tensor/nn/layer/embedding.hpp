@@ -0,0 +1,46 @@
+#pragma once
+
+#include "tensor/nn/mixed_precision.hpp"
+#include "tensor/nn/parameters_registry.hpp"
+#include "tensor/nn/variable.hpp"
+#include "tensor/tensor.hpp"
+
+namespace ts {
+
+// Lookup table of `num_embeddings` rows. Forward gathers the rows of the given indices, backward adds the gradient of
+// every output row to the row it came from, the rest of the weight gradient isn't touched. The same as a one-hot
+// input times the weight, without the O(num_embeddings) work per index. With a row-sparse gradient on the weight
+// (Variable::set_sparse_grad) backward appends the rows to it instead, and optimizers update only those.
+class Embedding : public ParameterRegistry<float> {
+  public:
+    Embedding(int num_embeddings, int dim);
+
+    explicit Embedding(Variable<float, 2> weight);
+
+    static auto create(int num_embeddings, int dim) -> Embedding;
+
+    auto operator()(VectorI const &indices) -> MatrixF;
+
+    // [indices, dim]
+    auto forward(VectorI const &indices) -> MatrixF;
+
+    // The same rows without keeping the indices for backward, e.g. for sampling between forward and backward
+    auto lookup(VectorI const &indices) const -> MatrixF;
+
+    auto backward(MatrixF const &d_output) -> void;
+
+    auto weight() -> Variable<float, 2> &;
+
+    // Precision of the output rows (see mixed_precision.hpp), the table stays in float
+    auto set_precision(Precision precision) -> void;
+
+    auto precision() const -> Precision;
+
+  private:
+    Variable<float, 2> _weight;
+    Precision _precision = Precision::FLOAT;
+
+    VectorI _indices{};
+};
+
+} // namespace ts
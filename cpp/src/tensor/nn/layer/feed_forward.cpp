@@ -4,8 +4,7 @@
 namespace ts {
 
 FeedForward::FeedForward(Variable<float, 2> weight, std::optional<Variable<float, 1>> bias, Activation activation)
-    : _weight(std::move(weight)), _bias(std::move(bias)), _activation(Activations::get(activation)),
-      _use_bias(_bias.has_value())
+    : _weight(std::move(weight)), _bias(std::move(bias)), _activation_type(activation), _use_bias(_bias.has_value())
 {
     register_parameters(_weight);
     if (_bias.has_value()) {
@@ -16,7 +15,7 @@ FeedForward::FeedForward(Variable<float, 2> weight, std::optional<Variable<float
 FeedForward::FeedForward(int dim_in, int dim_out, Activation activation, bool use_bias)
     : _weight(std::make_unique<ts::MatrixF>(ts::kaiming_uniform<float, 2>({dim_in, dim_out})),
               std::make_unique<ts::MatrixF>(ts::zeros<float, 2>({dim_in, dim_out})), "FeedForward(weight)"),
-      _bias(std::nullopt), _activation(Activations::get(activation)), _use_bias(use_bias)
+      _bias(std::nullopt), _activation_type(activation), _use_bias(use_bias)
 {
     register_parameters(_weight);
     if (use_bias) {
@@ -45,34 +44,33 @@ auto FeedForward::operator()(MatrixF const &inputs) -> MatrixF { return forward(
 
 auto FeedForward::forward(MatrixF const &inputs) -> MatrixF
 {
-    _x = inputs.clone();
-    auto _y = ts::dot(_x, _weight.tensor());
-    if (_use_bias) {
-        _y = ts::add(_y, _bias.value().tensor());
-    }
-
-    if (_activation) {
-        _y = _activation.value()->forward(_y);
-    }
-    return _y;
+    _x.save(_precision == Precision::FLOAT ? inputs.clone() : inputs, _precision);
+    // bias and activation are applied to the tiles of the product, no extra passes over the output
+    MatrixF y({inputs.shape(0), _weight.tensor().shape(1)}, uninitialized);
+    ts::dot(inputs, _weight.tensor(), y, epilogue());
+    _y.save(y, _precision);
+    return _precision == Precision::FLOAT ? y : _y.load();
 }
 
 auto FeedForward::backward(MatrixF const &d_y) -> MatrixF
 {
-    MatrixF d_output = d_y.clone();
-    if (_activation) {
-        d_output = _activation.value()->backward(d_output);
-    }
-    _weight.grad() += ts::dot(_x, d_output, true);
+    // the bias gradient is summed in the same pass that goes back through the activation
+    auto d_output = ts::epilogue_backward(_y.load(), d_y, epilogue(), _use_bias ? &_bias.value().grad() : nullptr);
+    _weight.grad() += ts::dot(_x.load(), d_output, true);
 
-    if (_use_bias) {
-        _bias.value().grad() += ts::sum(d_output, 0);
-    }
 //    auto [min_x, max_x] = std::minmax_element(_x.begin(), _x.end());
 //    auto [min_y, max_y] = std::minmax_element(d_y.begin(), d_y.end());
 //    auto [min_g, max_g] = std::minmax_element(_weight.grad().begin(), _weight.grad().end());
 
-    return ts::dot(d_output, _weight.tensor(), false, true);
+    return ts::round_to(ts::dot(d_output, _weight.tensor(), false, true), _precision);
+}
+
+auto FeedForward::epilogue() -> Epilogue
+{
+    if (_use_bias) {
+        return {_bias.value().tensor(), 1, _activation_type};
+    }
+    return {std::nullopt, 1, _activation_type};
 }
 
 auto FeedForward::weight() -> Variable<float, 2> & { return _weight; }
@@ -86,6 +84,12 @@ auto FeedForward::bias() -> std::optional<std::reference_wrapper<Variable<float,
     }
 }
 
+auto FeedForward::activation() const -> Activation { return _activation_type; }
+
+auto FeedForward::set_precision(Precision precision) -> void { _precision = precision; }
+
+auto FeedForward::precision() const -> Precision { return _precision; }
+
 auto FeedForward::weights() -> VectorRef
 {
     std::vector<std::reference_wrapper<ts::GradHolder<float>>> vars;
@@ -3,6 +3,7 @@
 #include <optional>
 
 #include "tensor/nn/activations.hpp"
+#include "tensor/nn/mixed_precision.hpp"
 #include "tensor/nn/parameters_registry.hpp"
 #include "tensor/nn/variable.hpp"
 #include "tensor/tensor.hpp"
@@ -31,16 +32,28 @@ class FeedForward : public ParameterRegistry<float> {
 
     auto weights() -> VectorRef;
 
+    auto activation() const -> Activation;
+
+    // Precision of the activations kept for backward and of the outputs and input gradients (see mixed_precision.hpp)
+    auto set_precision(Precision precision) -> void;
+
+    auto precision() const -> Precision;
+
   private:
     FeedForward(Variable<float, 2> weight, std::optional<Variable<float, 1>> bias,
                 Activation activation = Activation::NONE);
 
+    // bias and activation done by the product
+    auto epilogue() -> Epilogue;
+
     Variable<float, 2> _weight;
     std::optional<Variable<float, 1>> _bias = std::nullopt;
-    Activations::OptActivationPtr _activation;
+    Activation _activation_type;
     bool _use_bias;
+    Precision _precision = Precision::FLOAT;
 
-    MatrixF _x{};
+    SavedTensor<2> _x{};
+    SavedTensor<2> _y{};
 };
 
 } // namespace ts
@@ -0,0 +1,46 @@
+#include "feed_forward_half.hpp"
+
+namespace ts {
+
+template <typename Half>
+FeedForwardHalf<Half>::FeedForwardHalf(FeedForward &layer)
+    : _weight(layer.weight().tensor().template cast<Half>()),
+      _activation(FeedForward::Activations::get(layer.activation()))
+{
+    if (auto bias = layer.bias(); bias.has_value()) {
+        _bias = VectorF(bias.value().get().tensor(), true);
+    }
+}
+
+template <typename Half> auto FeedForwardHalf<Half>::operator()(MatrixF const &inputs) -> MatrixF
+{
+    return forward(inputs);
+}
+
+template <typename Half> auto FeedForwardHalf<Half>::forward(MatrixF const &inputs) -> MatrixF
+{
+    return finish(ts::dot(inputs, _weight));
+}
+
+template <typename Half> auto FeedForwardHalf<Half>::forward(Matrix<Half> const &inputs) -> Matrix<Half>
+{
+    return finish(ts::dot(inputs, _weight)).template cast<Half>();
+}
+
+template <typename Half> auto FeedForwardHalf<Half>::weight() const -> Matrix<Half> const & { return _weight; }
+
+template <typename Half> auto FeedForwardHalf<Half>::finish(MatrixF y) -> MatrixF
+{
+    if (_bias.has_value()) {
+        y = ts::add(y, _bias.value());
+    }
+    if (_activation) {
+        y = _activation.value()->forward(y);
+    }
+    return y;
+}
+
+template class FeedForwardHalf<bf16>;
+template class FeedForwardHalf<fp16>;
+
+} // namespace ts
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <optional>
+
+#include "tensor/nn/layer/feed_forward.hpp"
+
+namespace ts {
+
+// Inference-only copy of a FeedForward layer with the weight stored in bf16 or fp16. The bias stays in float (it's
+// tiny) and all the math is done in float, so outputs differ from the original layer only by the rounding of the
+// weight. Later updates of the original layer are not seen, create the copy again after training.
+template <typename Half> class FeedForwardHalf {
+  public:
+    explicit FeedForwardHalf(FeedForward &layer);
+
+    auto operator()(MatrixF const &) -> MatrixF;
+
+    auto forward(MatrixF const &) -> MatrixF;
+
+    // Activations in half precision too, rounded once at the end
+    auto forward(Matrix<Half> const &) -> Matrix<Half>;
+
+    auto weight() const -> Matrix<Half> const &;
+
+  private:
+    auto finish(MatrixF y) -> MatrixF;
+
+    Matrix<Half> _weight;
+    std::optional<VectorF> _bias = std::nullopt;
+    FeedForward::Activations::OptActivationPtr _activation;
+};
+
+} // namespace ts
@@ -0,0 +1,26 @@
+#include "feed_forward_quantized.hpp"
+#include "tensor/nn/autograd/tanh.hpp"
+
+namespace ts {
+
+QuantizedFeedForward::QuantizedFeedForward(FeedForward &layer, RangeObserver const &inputs)
+    : _weight(quantize_weights(layer.weight().tensor())), _activation(layer.activation()),
+      _input_scale(inputs.scale())
+{
+    if (auto bias = layer.bias(); bias.has_value()) {
+        _bias = VectorF(bias.value().get().tensor(), true);
+    }
+}
+
+auto QuantizedFeedForward::operator()(MatrixF const &inputs) -> MatrixF { return forward(inputs); }
+
+auto QuantizedFeedForward::forward(MatrixF const &inputs) -> MatrixF
+{
+    auto y = quantized_dot(inputs, _input_scale, _weight, _bias, _activation == Activation::RELU);
+    if (_activation == Activation::TANH) {
+        y = ts::tanh(y);
+    }
+    return y;
+}
+
+} // namespace ts
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <optional>
+
+#include "tensor/nn/layer/feed_forward.hpp"
+#include "tensor/quantization.hpp"
+
+namespace ts {
+
+// Inference-only int8 copy of a FeedForward layer. The weight is quantized per output column, inputs with the scale
+// of a RangeObserver fed with calibration batches of this layer's inputs. Bias and ReLU are applied by the GEMM
+// kernel itself.
+class QuantizedFeedForward {
+  public:
+    QuantizedFeedForward(FeedForward &layer, RangeObserver const &inputs);
+
+    auto operator()(MatrixF const &) -> MatrixF;
+
+    auto forward(MatrixF const &) -> MatrixF;
+
+  private:
+    QuantizedMatrix _weight;
+    std::optional<VectorF> _bias = std::nullopt;
+    Activation _activation;
+    float _input_scale;
+};
+
+} // namespace ts
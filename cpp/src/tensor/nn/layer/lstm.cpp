@@ -1,60 +1,111 @@
 #include "lstm.hpp"
 
+#include <algorithm>
 #include <utility>
 
 #include "tensor/nn/initialization.hpp"
 #include "tensor/nn/softmax.hpp"
+#include "tensor/simd.hpp"
+
+namespace {
+
+using ts::MatrixF;
+using ts::size_type;
+
+// Views of rows [from, to) and of columns [from, to) of a matrix
+auto rows(MatrixF const &matrix, size_type from, size_type to) -> MatrixF
+{
+    auto strides = matrix.strides();
+    return MatrixF(matrix.data(), {to - from, matrix.shape(1)}, strides, matrix.begin() + from * strides[0]);
+}
+
+auto columns(MatrixF const &matrix, size_type from, size_type to) -> MatrixF
+{
+    auto strides = matrix.strides();
+    return MatrixF(matrix.data(), {matrix.shape(0), to - from}, strides, matrix.begin() + from * strides[1]);
+}
+
+// z holds the product of a timestep and is overwritten with the gates, sigmoid for forget, input and output and tanh
+// for the candidate. memory = f * previous_memory + i * candidate, state = o * memory (tanh omitted like in LSTMCell).
+auto gates_forward(float *z, float const *previous_memory, float *memory, float *state, size_type hidden) -> void
+{
+    auto const &kernels = ts::simd::kernels();
+    // sigmoid(x) = 1 / (1 + exp(-x)) and tanh(x) = 2 * sigmoid(2x) - 1, so a single exp over all four gates
+    kernels.multiply_scalar(z, -1.0f, z, 3 * hidden);
+    kernels.multiply_scalar(z + 3 * hidden, -2.0f, z + 3 * hidden, hidden);
+    kernels.exp(z, 0.0f, z, 4 * hidden);
+    for (size_type j = 0; j < 4 * hidden; ++j) {
+        z[j] = 1.0f / (1.0f + z[j]);
+    }
+    float const *f = z;
+    float const *i = z + hidden;
+    float const *o = z + 2 * hidden;
+    float *c = z + 3 * hidden;
+    for (size_type j = 0; j < hidden; ++j) {
+        c[j] = 2.0f * c[j] - 1.0f;
+        memory[j] = f[j] * previous_memory[j] + i[j] * c[j];
+        state[j] = o[j] * memory[j];
+    }
+}
+
+// Gradient of the product of a timestep from the ones of its state and memory, d_memory becomes the gradient of the
+// previous memory
+auto gates_backward(float const *gates, float const *previous_memory, float const *memory, float const *d_state,
+                    float *d_memory, float *d_z, size_type hidden) -> void
+{
+    float const *f = gates;
+    float const *i = gates + hidden;
+    float const *o = gates + 2 * hidden;
+    float const *c = gates + 3 * hidden;
+    for (size_type j = 0; j < hidden; ++j) {
+        float d_c = o[j] * d_state[j] + d_memory[j];
+        d_z[j] = previous_memory[j] * d_c * f[j] * (1.0f - f[j]);
+        d_z[hidden + j] = c[j] * d_c * i[j] * (1.0f - i[j]);
+        d_z[2 * hidden + j] = memory[j] * d_state[j] * o[j] * (1.0f - o[j]);
+        d_z[3 * hidden + j] = i[j] * d_c * (1.0f - c[j] * c[j]);
+        d_memory[j] = d_c * f[j];
+    }
+}
+
+} // namespace
 
 ts::LSTM::LSTM(int vocab_size, int sequence_length, int hidden_size, int embedding_dim)
     : _hidden_size(hidden_size), _sequence_length(sequence_length), _vocab_size(vocab_size),
       _concat_size(embedding_dim + hidden_size),
-      _p{Variable<float, 2>::create(ts::uniform<float, 2>({_concat_size, hidden_size}, hidden_size)),
-         Variable<float, 2>::create(ts::uniform<float, 2>({_concat_size, hidden_size}, hidden_size)),
-         Variable<float, 2>::create(ts::uniform<float, 2>({_concat_size, hidden_size}, hidden_size)),
-         Variable<float, 2>::create(ts::uniform<float, 2>({_concat_size, hidden_size}, hidden_size)),
-         Variable<float, 1>::create(ts::uniform<float, 1>({hidden_size}, hidden_size)),
-         Variable<float, 1>::create(ts::uniform<float, 1>({hidden_size}, hidden_size)),
-         Variable<float, 1>::create(ts::uniform<float, 1>({hidden_size}, hidden_size)),
-         Variable<float, 1>::create(ts::uniform<float, 1>({hidden_size}, hidden_size))},
-      _index2hidden(vocab_size, hidden_size, Activation::NONE, false),
+      _weight(Variable<float, 2>::create(ts::uniform<float, 2>({_concat_size, 4 * hidden_size}, hidden_size))),
+      _bias(Variable<float, 1>::create(ts::uniform<float, 1>({4 * hidden_size}, hidden_size))),
+      _embedding(Variable<float, 2>::create(ts::kaiming_uniform<float, 2>({vocab_size, embedding_dim}))),
       _hidden2output(hidden_size, vocab_size, Activation::NONE, false), _last_memory(1, hidden_size),
       _last_state(1, hidden_size)
 
 {
-    for (int i = 0; i < sequence_length; ++i) {
-        _cells.emplace_back(_p);
-    }
-    register_parameters(_p.wxc);
-    register_parameters(_p.wxf);
-    register_parameters(_p.wxi);
-    register_parameters(_p.wxo);
-    register_parameters(_p.bc);
-    register_parameters(_p.bf);
-    register_parameters(_p.bi);
-    register_parameters(_p.bo);
-    register_parameters(_index2hidden.parameters());
+    register_parameters(_weight);
+    register_parameters(_bias);
+    register_parameters(_embedding.parameters());
     register_parameters(_hidden2output.parameters());
 }
 
 auto ts::LSTM::forward(std::vector<int> inputs, std::vector<int> targets, ts::MatrixF const &previous_state,
                        ts::MatrixF const &previous_memory) -> float
 {
-    _last_state = previous_state;
-    _last_memory = previous_memory;
-    float loss = 0.0;
-    for (int i = 0; i < inputs.size(); ++i) {
-        MatrixF input(1, _vocab_size);
-        input.at({0, inputs[i]}) = 1;
-        _input_embedding = _index2hidden.forward(input);
-        auto &cell = _cells[i];
-        auto hidden_state = cell.forward(_input_embedding, _last_state, _last_memory);
-        auto logits = _hidden2output.forward(hidden_state);
-        loss += cell.loss().forward(logits, {targets[i]});
-
-        _last_state = cell.state();
-        _last_memory = cell.memory();
-    }
-    return loss;
+    _steps = inputs.size();
+    VectorI indices(_steps);
+    VectorI labels(_steps);
+    std::copy(inputs.begin(), inputs.end(), indices.begin());
+    std::copy(targets.begin(), targets.end(), labels.begin());
+    _embeddings = _embedding.forward(indices);
+    _states = MatrixF({_steps, static_cast<size_type>(_hidden_size)}, uninitialized);
+
+    int blocks = _block_size > 0 ? static_cast<int>((_steps + _block_size - 1) / _block_size) : 1;
+    _blocks.resize(blocks);
+    auto [state, memory] = _checkpoint.forward(blocks, {previous_state, previous_memory},
+                                               [this](int i, State const &s) { return forward_block(i, s); });
+    _last_state = state;
+    _last_memory = memory;
+
+    // the loss is summed over timesteps, CrossEntropyLoss averages over rows
+    auto logits = _hidden2output.forward(_states);
+    return _loss_fn.forward(logits, labels) * static_cast<float>(_steps);
 }
 
 auto ts::LSTM::forward(std::vector<int> inputs, std::vector<int> targets) -> float
@@ -62,29 +113,104 @@ auto ts::LSTM::forward(std::vector<int> inputs, std::vector<int> targets) -> flo
     return forward(std::move(inputs), std::move(targets), _last_state, _last_memory);
 }
 
-auto ts::LSTM::backward() -> void
+auto ts::LSTM::block(int i) const -> std::pair<size_type, size_type>
+{
+    if (_block_size <= 0) {
+        return {0, _steps};
+    }
+    size_type begin = static_cast<size_type>(i) * _block_size;
+    return {begin, std::min(begin + _block_size, _steps)};
+}
+
+auto ts::LSTM::forward_block(int i, State const &state) -> State
 {
-    auto d_hidden_state = MatrixF(1, _hidden_size);
-    auto d_memory_state = MatrixF(1, _hidden_size);
-
-    for (int i = _sequence_length - 1; i >= 0; --i) {
-        auto &cell = _cells[i];
-        auto d_scores = cell.loss().backward();
-        auto d_hidden = _hidden2output.backward(d_scores);
-        d_hidden_state += d_hidden;
-        auto [d_h, d_c, d_x] = cell.backward(d_hidden_state, d_memory_state);
-        _index2hidden.backward(d_x);
-        d_hidden_state = d_h;
-        d_memory_state = d_c;
+    auto [begin, end] = block(i);
+    size_type steps = end - begin;
+    size_type hidden = _hidden_size;
+    size_type embedding = _concat_size - _hidden_size;
+    auto const &w = _weight.tensor();
+
+    MatrixF xh({steps, static_cast<size_type>(_concat_size)}, uninitialized);
+    columns(xh, 0, embedding).assign(rows(_embeddings, begin, end));
+    // input half of the product for all timesteps of the block at once, with the bias
+    MatrixF gates({steps, 4 * hidden}, uninitialized);
+    ts::dot(columns(xh, 0, embedding), rows(w, 0, embedding), gates, Epilogue{_bias.tensor()});
+
+    MatrixF memory({steps + 1, hidden}, uninitialized);
+    rows(memory, 0, 1).assign(state.second);
+    auto w_h = rows(w, embedding, _concat_size);
+    MatrixF h = state.first;
+    for (size_type t = 0; t < steps; ++t) {
+        columns(rows(xh, t, t + 1), embedding, _concat_size).assign(h);
+        auto z = rows(gates, t, t + 1);
+        ts::dot(h, w_h, z, false, false, 1.0f);
+        auto next_h = rows(_states, begin + t, begin + t + 1);
+        float *next_memory = memory.raw_data_mutable() + (t + 1) * hidden;
+        gates_forward(z.raw_data_mutable(), next_memory - hidden, next_memory, next_h.raw_data_mutable(), hidden);
+        h = next_h;
     }
+
+    auto &saved = _blocks[i];
+    saved.xh.save(xh, _precision);
+    saved.gates.save(gates, _precision);
+    saved.memory.save(memory, _precision);
+    return {h.clone(), rows(memory, steps, steps + 1).clone()};
+}
+
+auto ts::LSTM::backward(float loss_scale) -> void
+{
+    // the same scale for every timestep, backward of the averaged loss divides by their number
+    _d_states = _hidden2output.backward(_loss_fn.backward(loss_scale * static_cast<float>(_steps)));
+    _d_embeddings = MatrixF({_steps, static_cast<size_type>(_concat_size - _hidden_size)}, uninitialized);
+
+    State d_state{MatrixF(1, _hidden_size), MatrixF(1, _hidden_size)};
+    _checkpoint.backward(
+        d_state, [this](int i, State const &s) { return forward_block(i, s); },
+        [this](int i, State const &d) { return backward_block(i, d); });
+    _embedding.backward(_d_embeddings);
+}
+
+auto ts::LSTM::backward_block(int i, State const &d_state) -> State
+{
+    auto [begin, end] = block(i);
+    size_type steps = end - begin;
+    size_type hidden = _hidden_size;
+    size_type embedding = _concat_size - _hidden_size;
+    auto const &w = _weight.tensor();
+    auto xh = _blocks[i].xh.load();
+    auto gates = _blocks[i].gates.load();
+    auto memory = _blocks[i].memory.load();
+    auto const &kernels = simd::kernels();
+
+    MatrixF d_gates({steps, 4 * hidden}, uninitialized);
+    MatrixF d_memory = d_state.second.clone();
+    MatrixF d_next_h = d_state.first.contiguous();
+    MatrixF d_h({1, hidden}, uninitialized);
+    auto w_h = rows(w, embedding, _concat_size);
+    for (size_type t = steps; t-- > 0;) {
+        // the state goes to the output projection and to the next timestep
+        kernels.add(_d_states.raw_data() + (begin + t) * hidden, d_next_h.raw_data(), d_h.raw_data_mutable(), hidden);
+        auto d_z = rows(d_gates, t, t + 1);
+        gates_backward(gates.raw_data() + t * 4 * hidden, memory.raw_data() + t * hidden,
+                       memory.raw_data() + (t + 1) * hidden, d_h.raw_data(), d_memory.raw_data_mutable(),
+                       d_z.raw_data_mutable(), hidden);
+        d_next_h = ts::dot(d_z, w_h, false, true);
+    }
+
+    // weight gradient of all timesteps of the block in one product
+    ts::dot(xh, d_gates, _weight.grad(), true, false, 1.0f);
+    _bias.grad() += ts::sum(d_gates, 0);
+    auto d_embeddings = rows(_d_embeddings, begin, end);
+    ts::dot(d_gates, rows(w, 0, embedding), d_embeddings, false, true);
+    return {d_next_h, d_memory};
 }
 
 auto ts::LSTM::sample(int idx, ts::MatrixF const &previous_state, ts::MatrixF const &previous_memory, int sample_size)
     -> std::vector<int>
 {
-    auto cell = ts::LSTMCell(_p);
+    size_type hidden = _hidden_size;
     auto prev_h = previous_state;
-    auto prev_c = previous_memory;
+    auto prev_c = previous_memory.contiguous();
 
     std::vector<int> indices(sample_size);
     indices[0] = idx;
@@ -93,14 +219,19 @@ auto ts::LSTM::sample(int idx, ts::MatrixF const &previous_state, ts::MatrixF co
     std::default_random_engine random;
 
     for (int i = 0; i < sample_size - 1; ++i) {
-        MatrixF input(1, _vocab_size);
-        input.at({0, indices[i]}) = 1;
-        auto probabilities = ts::softmax(_hidden2output(cell.forward(_index2hidden(input), prev_h, prev_c)));
+        auto xh = ts::concatenate(std::vector<MatrixF>{_embedding.lookup(VectorI{indices[i]}), prev_h}, 1);
+        MatrixF z({1, 4 * hidden}, uninitialized);
+        ts::dot(xh, _weight.tensor(), z, Epilogue{_bias.tensor()});
+        MatrixF h({1, hidden}, uninitialized);
+        MatrixF c({1, hidden}, uninitialized);
+        gates_forward(z.raw_data_mutable(), prev_c.raw_data(), c.raw_data_mutable(), h.raw_data_mutable(), hidden);
+        // the projection has no bias nor activation, calling it would overwrite what it keeps for backward
+        auto probabilities = ts::softmax(ts::dot(h, _hidden2output.weight().tensor()));
 
         distribution.param({probabilities.begin(), probabilities.end()});
         indices[i + 1] = distribution(random);
-        prev_h = cell.state();
-        prev_c = cell.memory();
+        prev_h = h;
+        prev_c = c;
     }
     return indices;
 }
@@ -108,3 +239,14 @@ auto ts::LSTM::sample(int idx, ts::MatrixF const &previous_state, ts::MatrixF co
 auto ts::LSTM::last_state() -> ts::MatrixF & { return _last_state; }
 
 auto ts::LSTM::last_memory() -> ts::MatrixF & { return _last_memory; }
+
+auto ts::LSTM::set_precision(Precision precision) -> void
+{
+    _precision = precision;
+    _embedding.set_precision(precision);
+    _hidden2output.set_precision(precision);
+}
+
+auto ts::LSTM::set_checkpointing(int segment_length) -> void { _block_size = segment_length; }
+
+auto ts::LSTM::embedding() -> ts::Embedding & { return _embedding; }
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "tensor/nn/checkpoint.hpp"
+#include "tensor/nn/cross_entropy_loss.hpp"
+#include "tensor/nn/layer/embedding.hpp"
 #include "tensor/nn/layer/feed_forward.hpp"
-#include "tensor/nn/layer/lstm_cell.hpp"
 #include "tensor/nn/parameters_registry.hpp"
 
 namespace ts {
 
+// The gates of all timesteps come from one packed weight [embedding + hidden, 4 * hidden], columns of the forget,
+// input, output and candidate gates side by side. The input half of the product is done for the whole sequence in
+// one GEMM before the recurrence, every timestep adds its recurrent half with one more and runs a fused gate kernel,
+// backward sums up the weight gradient of all timesteps with a single GEMM.
 class LSTM : public ParameterRegistry<float> {
   public:
     LSTM(int vocab_size, int sequence_length, int hidden_size, int embedding_dim);
@@ -15,7 +21,8 @@ class LSTM : public ParameterRegistry<float> {
     auto forward(std::vector<int> inputs, std::vector<int> targets, MatrixF const &previous_state,
                  MatrixF const &previous_memory) -> float;
 
-    auto backward() -> void;
+    // loss_scale multiplies the gradient of every step's loss, see LossScaler
+    auto backward(float loss_scale = 1.0f) -> void;
 
     auto sample(int idx, ts::MatrixF const &previous_state, ts::MatrixF const &previous_memory, int sample_size)
         -> std::vector<int>;
@@ -24,19 +31,62 @@ class LSTM : public ParameterRegistry<float> {
 
     auto last_memory() -> MatrixF &;
 
+    // Runs the recurrence, the embedding and the output projection with activations in the given precision, the weights
+    // stay in float
+    auto set_precision(Precision precision) -> void;
+
+    // Keeps the activations of only one segment of timesteps, the others are recomputed in backward (see
+    // checkpoint.hpp). 0 turns it off.
+    auto set_checkpointing(int segment_length) -> void;
+
+    // e.g. embedding().weight().set_sparse_grad(true) for optimizer steps over the used rows only
+    auto embedding() -> Embedding &;
+
   private:
+    using State = std::pair<MatrixF, MatrixF>;
+
+    // Everything backward needs from a block of timesteps
+    struct Block {
+        // [steps, embedding + hidden], embeddings and previous states
+        SavedTensor<2> xh;
+        // [steps, 4 * hidden], after activations
+        SavedTensor<2> gates;
+        // [steps + 1, hidden], memory before the first timestep and after every one
+        SavedTensor<2> memory;
+    };
+
+    // Timesteps [begin, end) of a block, all of them when checkpointing is off
+    auto block(int i) const -> std::pair<size_type, size_type>;
+
+    // (state, memory) before the block -> after it, states of the timesteps go to _states
+    auto forward_block(int i, State const &state) -> State;
+
+    // Gradients of (state, memory) after the block -> before it, the ones of the embeddings go to _d_embeddings
+    auto backward_block(int i, State const &d_state) -> State;
+
     int _hidden_size;
     int _sequence_length;
     int _vocab_size;
     int _concat_size;
-    LSTMCell::Parameters _p;
-    FeedForward _index2hidden;
+    Variable<float, 2> _weight;
+    Variable<float, 1> _bias;
+    Embedding _embedding;
     FeedForward _hidden2output;
+    CrossEntropyLoss _loss_fn{};
     MatrixF _last_memory;
     MatrixF _last_state;
+    Precision _precision = Precision::FLOAT;
 
-    std::vector<LSTMCell> _cells{};
-    MatrixF _input_embedding{};
+    // every block is a segment of its own
+    Checkpoint<State> _checkpoint{1};
+    int _block_size = 0;
+    size_type _steps = 0;
+    std::vector<Block> _blocks{};
+    // [steps, embedding] and [steps, hidden] for the whole sequence
+    MatrixF _embeddings{};
+    MatrixF _states{};
+    MatrixF _d_embeddings{};
+    MatrixF _d_states{};
 };
 
-} // namespace ts
\ No newline at end of file
+} // namespace ts
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "tensor/nn/cross_entropy_loss.hpp"
+#include "tensor/nn/mixed_precision.hpp"
 #include "tensor/nn/variable.hpp"
 
 namespace ts {
@@ -31,6 +32,10 @@ class LSTMCell {
 
     auto loss() -> CrossEntropyLoss &;
 
+    // The concatenated input, gates and previous memory are kept for backward in this precision, the state and memory
+    // passed to the next step stay in float
+    auto set_precision(Precision precision) -> void;
+
 
   private:
     Parameters &_p;
@@ -38,13 +43,14 @@ class LSTMCell {
     CrossEntropyLoss _loss_fn{};
 
     int _x_dim;
-    MatrixF _xh{};
-    MatrixF _prev_state_c{};
-    MatrixF _state_i{};
-    MatrixF _state_o{};
-    MatrixF _state_f{};
+    Precision _precision = Precision::FLOAT;
+    SavedTensor<2> _xh{};
+    SavedTensor<2> _prev_state_c{};
+    SavedTensor<2> _state_i{};
+    SavedTensor<2> _state_o{};
+    SavedTensor<2> _state_f{};
+    SavedTensor<2> _state_c_dash{};
     MatrixF _state_c{};
-    MatrixF _state_c_dash{};
     MatrixF _state_h{};
 };
 } // namespace ts
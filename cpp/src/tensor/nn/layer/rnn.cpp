@@ -1,20 +1,22 @@
 #include "rnn.hpp"
 
+#include <algorithm>
+
 #include "tensor/nn/initialization.hpp"
 #include "tensor/nn/softmax.hpp"
 
 ts::RNN::RNN(int hidden_size, int sequence_length, int vocab_size)
     : _hidden_size(hidden_size), _sequence_length(sequence_length), _vocab_size(vocab_size),
-      _p{Variable<float, 2>::create(ts::standard_normal<float, 2>({vocab_size, hidden_size}, 0.01)),
-         Variable<float, 2>::create(ts::standard_normal<float, 2>({hidden_size, hidden_size}, 0.01)),
+      _embedding(Variable<float, 2>::create(ts::standard_normal<float, 2>({vocab_size, hidden_size}, 0.01))),
+      _p{Variable<float, 2>::create(ts::standard_normal<float, 2>({hidden_size, hidden_size}, 0.01)),
          Variable<float, 2>::create(ts::standard_normal<float, 2>({hidden_size, vocab_size}, 0.01)),
          Variable<float, 1>::create(ts::Tensor<float, 1>(hidden_size)),
          Variable<float, 1>::create(ts::Tensor<float, 1>(vocab_size))}
 {
     for (int i = 0; i < sequence_length; ++i) {
-        _cells.emplace_back(_p, vocab_size);
+        _cells.emplace_back(_p);
     }
-    register_parameters(_p.wxh);
+    register_parameters(_embedding.parameters());
     register_parameters(_p.whh);
     register_parameters(_p.why);
     register_parameters(_p.bh);
@@ -22,30 +24,49 @@ ts::RNN::RNN(int hidden_size, int sequence_length, int vocab_size)
 }
 auto ts::RNN::forward(std::vector<int> inputs, std::vector<int> targets, ts::MatrixF const &previous_state) -> float
 {
-    _last_state = previous_state; // not a deep copy but we won't be modifying content so its fine
+    _inputs = std::move(inputs);
+    _targets = std::move(targets);
+    _losses.assign(_inputs.size(), 0.0f);
+    VectorI indices(_inputs.size());
+    std::copy(_inputs.begin(), _inputs.end(), indices.begin());
+    _embeddings = _embedding.forward(indices);
+    // not a deep copy but we won't be modifying content so its fine
+    _last_state = _checkpoint.forward(static_cast<int>(_inputs.size()), previous_state,
+                                      [this](int i, MatrixF const &state) { return step(i, state); });
     float loss = 0.0;
-    for (int i = 0; i < inputs.size(); ++i) {
-        auto &cell = _cells[i];
-        auto output = cell.forward(inputs[i], _last_state);
-        loss += cell.loss().forward(output, {targets[i]});
-        _last_state = cell.hidden_state(); // deep copy doesn't make much sense here
+    for (float step_loss : _losses) {
+        loss += step_loss;
     }
     return loss;
 }
+auto ts::RNN::step(int i, ts::MatrixF const &previous_state) -> ts::MatrixF
+{
+    auto &cell = _cells[i];
+    auto output = cell.forward(ts::slice(_embeddings, i, i + 1, 0), previous_state);
+    _losses[i] = cell.loss().forward(output, {_targets[i]});
+    return cell.hidden_state(); // deep copy doesn't make much sense here
+}
 auto ts::RNN::backward() -> void
 {
-    auto next_d_hidden_state = MatrixF(1, _hidden_size);
-    for (int i = _sequence_length - 1; i >= 0; --i) {
-        auto &cell = _cells[i];
-        auto d_scores = cell.loss().backward();
-        next_d_hidden_state = cell.backward(d_scores, next_d_hidden_state);
-    }
+    _d_embeddings = MatrixF({_inputs.size(), static_cast<size_type>(_hidden_size)}, uninitialized);
+    _checkpoint.backward(
+        MatrixF(1, _hidden_size), [this](int i, MatrixF const &state) { return step(i, state); },
+        [this](int i, MatrixF const &next_d_hidden_state) {
+            auto &cell = _cells[i];
+            auto d_scores = cell.loss().backward();
+            auto [d_hidden_state, d_input] = cell.backward(d_scores, next_d_hidden_state);
+            std::copy(d_input.begin(), d_input.end(), _d_embeddings.begin() + i * _hidden_size);
+            return d_hidden_state;
+        });
+    _embedding.backward(_d_embeddings);
 }
 auto ts::RNN::state() -> ts::MatrixF & { return _last_state; }
 
+auto ts::RNN::set_checkpointing(int segment_length) -> void { _checkpoint.set_segment_length(segment_length); }
+
 auto ts::RNN::sample(int idx, ts::MatrixF const &previous_state, int sample_size) -> std::vector<int>
 {
-    auto cell = RNNCell(_p, _vocab_size);
+    auto cell = RNNCell(_p);
     auto prev_state = previous_state;
     std::vector<int> indices(sample_size);
     indices[0] = idx;
@@ -54,10 +75,12 @@ auto ts::RNN::sample(int idx, ts::MatrixF const &previous_state, int sample_size
     std::default_random_engine random;
 
     for (int i = 0; i < sample_size - 1; ++i) {
-        auto probabilities = ts::softmax(cell.forward(indices[i], prev_state));
+        auto probabilities = ts::softmax(cell.forward(_embedding.lookup(VectorI{indices[i]}), prev_state));
         distribution.param({probabilities.begin(), probabilities.end()});
         indices[i + 1] = distribution(random);
         prev_state = cell.hidden_state();
     }
     return indices;
 }
+
+auto ts::RNN::embedding() -> ts::Embedding & { return _embedding; }
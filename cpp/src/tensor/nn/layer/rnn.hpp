@@ -1,5 +1,7 @@
 #pragma once
 
+#include "tensor/nn/checkpoint.hpp"
+#include "tensor/nn/layer/embedding.hpp"
 #include "tensor/nn/parameters_registry.hpp"
 #include "tensor/nn/layer/rnn_cell.hpp"
 
@@ -17,14 +19,32 @@ class RNN : public ParameterRegistry<float> {
 
     auto state() -> MatrixF &;
 
+    // Keeps the activations of only one segment of timesteps, the others are recomputed in backward (see
+    // checkpoint.hpp). 0 turns it off.
+    auto set_checkpointing(int segment_length) -> void;
+
+    // e.g. embedding().weight().set_sparse_grad(true) for optimizer steps over the used rows only
+    auto embedding() -> Embedding &;
+
   private:
+    // One timestep: hidden state -> hidden state, the loss goes to _losses
+    auto step(int i, MatrixF const &previous_state) -> MatrixF;
+
     int _hidden_size;
     int _sequence_length;
     int _vocab_size;
+    Embedding _embedding;
     RNNCell::Parameters _p;
 
     std::vector<RNNCell> _cells{};
     MatrixF _last_state{};
+    Checkpoint<MatrixF> _checkpoint{};
+    std::vector<int> _inputs{};
+    std::vector<int> _targets{};
+    std::vector<float> _losses{};
+    // [steps, hidden_size], inputs of the cells
+    MatrixF _embeddings{};
+    MatrixF _d_embeddings{};
 };
 
 } // namespace ts
\ No newline at end of file
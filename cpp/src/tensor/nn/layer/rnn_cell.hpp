@@ -1,25 +1,28 @@
 #pragma once
 
 #include "tensor/nn/cross_entropy_loss.hpp"
+#include "tensor/nn/mixed_precision.hpp"
 #include "tensor/nn/variable.hpp"
 
 namespace ts {
 
 class RNNCell {
   public:
+    // the input weight is the table of an Embedding, the cell gets its rows
     struct Parameters {
-        Variable<float, 2> wxh;
         Variable<float, 2> whh;
         Variable<float, 2> why;
         Variable<float, 1> bh;
         Variable<float, 1> by;
     };
 
-    RNNCell(Parameters &p, int vocab_size);
+    explicit RNNCell(Parameters &p);
 
-    auto forward(int input_index, MatrixF const &previous_hidden_state) -> MatrixF;
+    // input is the embedding of the input index, [batch_size, hidden_size]
+    auto forward(MatrixF const &input, MatrixF const &previous_hidden_state) -> MatrixF;
 
-    auto backward(MatrixF const &d_output, MatrixF const &next_d_hidden_state) -> MatrixF;
+    // Gradients of the previous hidden state and of the input
+    auto backward(MatrixF const &d_output, MatrixF const &next_d_hidden_state) -> std::tuple<MatrixF, MatrixF>;
 
     auto hidden_state() -> MatrixF &;
 
@@ -27,11 +30,9 @@ class RNNCell {
 
   private:
     Parameters &_p;
-    int _vocab_size;
 
     MatrixF _hidden_state{};
     CrossEntropyLoss _loss_fn{};
-    MatrixF _input{};
-    MatrixF _previous_hidden_state{};
+    SavedTensor<2> _previous_hidden_state{};
 };
 } // namespace ts
@@ -0,0 +1,72 @@
+#include "loss_scaler.hpp"
+
+#include <cmath>
+
+#include "tensor/parallel.hpp"
+#include "tensor/simd.hpp"
+
+namespace ts {
+
+namespace {
+
+// Multiplies the values by `factor`, true if all of them are finite afterwards
+auto unscale(float *values, size_type size, float factor) -> bool
+{
+    return parallel_reduce(
+        size, true,
+        [&](size_type begin, size_type end) {
+            simd::kernels().multiply_scalar(values + begin, factor, values + begin, end - begin);
+            bool finite = true;
+            for (size_type i = begin; i < end; ++i) {
+                finite &= std::isfinite(values[i]);
+            }
+            return finite;
+        },
+        [](bool a, bool b) { return a && b; });
+}
+
+} // namespace
+
+LossScaler::LossScaler(float initial_scale, float growth, float backoff, int growth_interval)
+    : _scale(initial_scale), _growth(growth), _backoff(backoff), _growth_interval(growth_interval)
+{
+}
+
+auto LossScaler::scale() const -> float { return _scale; }
+
+auto LossScaler::backward(CrossEntropyLoss &loss) const -> MatrixF { return loss.backward(_scale); }
+
+auto LossScaler::step(Optimizer<float> &optimizer) -> bool
+{
+    float factor = 1.0f / _scale;
+    bool finite = true;
+    if (optimizer.is_packed()) {
+        finite = unscale(optimizer.packed_gradients(), optimizer.packed_size(), factor);
+    } else {
+        for (GradHolder<float> &param : optimizer.parameters()) {
+            if (size_type size = param.size(); size > 0) {
+                finite &= unscale(&*param.grad().begin(), size, factor);
+            }
+        }
+    }
+    for (GradHolder<float> &param : optimizer.parameters()) {
+        if (auto *grad = param.sparse_grad(); grad != nullptr && !grad->empty()) {
+            finite &= unscale(grad->values(), grad->size() * grad->row_size(), factor);
+        }
+    }
+
+    if (!finite) {
+        optimizer.zero_gradients();
+        _scale *= _backoff;
+        _finite_steps = 0;
+        return false;
+    }
+    optimizer.step();
+    if (++_finite_steps == _growth_interval) {
+        _scale *= _growth;
+        _finite_steps = 0;
+    }
+    return true;
+}
+
+} // namespace ts
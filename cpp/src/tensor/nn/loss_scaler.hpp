@@ -0,0 +1,32 @@
+#pragma once
+
+#include "tensor/nn/cross_entropy_loss.hpp"
+#include "tensor/nn/optimizer/optimizer.hpp"
+
+namespace ts {
+
+// Dynamic loss scaling: the scale grows by `growth` after `growth_interval` steps in a row with finite gradients and
+// shrinks by `backoff` whenever some gradient overflows, that step is skipped.
+class LossScaler {
+  public:
+    explicit LossScaler(float initial_scale = 65536.0f, float growth = 2.0f, float backoff = 0.5f,
+                        int growth_interval = 2000);
+
+    [[nodiscard]] auto scale() const -> float;
+
+    // Gradient of the loss multiplied by the scale
+    auto backward(CrossEntropyLoss &loss) const -> MatrixF;
+
+    // Divides the gradients of the optimizer's parameters by the scale and steps the optimizer, unless some of them
+    // aren't finite: then the gradients are zeroed and the step is skipped. Returns whether the step was taken.
+    auto step(Optimizer<float> &optimizer) -> bool;
+
+  private:
+    float _scale;
+    float _growth;
+    float _backoff;
+    int _growth_interval;
+    int _finite_steps = 0;
+};
+
+} // namespace ts
@@ -39,8 +39,7 @@ auto ts::max_pool_2d_hwc(ts::Tensor<float, 4> const &inputs, int kernel_size, in
     ts::Tensor<float, 4> results(batch_size, dim_out, dim_out, C_in);
     ts::Tensor<char, 4> masks(inputs.shape());
 
-#pragma omp parallel for
-    for (int b = 0; b < batch_size; ++b) {
+    ts::parallel_for_each(batch_size, [&](size_type b) {
         auto input = inputs(b);
         auto mask = masks(b);
         auto result = results(b);
@@ -54,10 +53,10 @@ auto ts::max_pool_2d_hwc(ts::Tensor<float, 4> const &inputs, int kernel_size, in
 
                 // TODO copy seems unnecessary
                 //   something like this might be cool: image(i, j) = std::move(max_values);
-                std::copy(max_values.begin(), max_values.end(), result(i, j).begin());
+                result(i, j).assign(max_values);
             }
         }
-    }
+    });
     return std::make_pair(results, masks);
 }
 
@@ -84,8 +83,7 @@ auto ts::max_pool_2d(ts::Tensor<float, 4> const &inputs, int kernel_size, int st
     ts::fill_(results, -std::numeric_limits<float>::infinity());
     ts::Tensor<int, 4> masks(batch_size, C_in, dim_out_h, dim_out_w);
 
-#pragma omp parallel for
-    for (int b = 0; b < batch_size; ++b) {
+    ts::parallel_for_each(batch_size, [&](size_type b) {
         auto input = inputs(b);
         auto mask = masks(b);
         auto result = results(b);
@@ -114,7 +112,7 @@ auto ts::max_pool_2d(ts::Tensor<float, 4> const &inputs, int kernel_size, int st
                 }
             }
         }
-    }
+    });
     return std::make_pair(results, masks);
 }
 
@@ -142,8 +140,7 @@ auto ts::max_pool_2d_backward(ts::Tensor<float, 4> const &d_outputs, ts::Tensor<
 
     auto d_inputs = ts::Tensor<float, 4>(batch_size, C_in, dim_in, dim_in);
 
-#pragma omp parallel for
-    for (int b = 0; b < batch_size; ++b) {
+    ts::parallel_for_each(batch_size, [&](size_type b) {
         auto mask = masks(b);
         auto d_output = d_outputs(b);
         auto d_input = d_inputs(b);
@@ -155,7 +152,7 @@ auto ts::max_pool_2d_backward(ts::Tensor<float, 4> const &d_outputs, ts::Tensor<
                 }
             }
         }
-    }
+    });
     return d_inputs;
 }
 
@@ -166,8 +163,7 @@ auto ts::max_pool_2d_backward_hwc(ts::Tensor<float, 4> const &d_outputs, ts::Ten
     int dim_out = d_outputs.shape(1);
     int batch_size = masks.shape(0);
 
-#pragma omp parallel for
-    for (int b = 0; b < batch_size; ++b) {
+    ts::parallel_for_each(batch_size, [&](size_type b) {
         auto mask = masks(b);
         auto d_output = d_outputs(b);
         auto d_input = d_inputs(b);
@@ -180,6 +176,6 @@ auto ts::max_pool_2d_backward_hwc(ts::Tensor<float, 4> const &d_outputs, ts::Ten
                 _set_tile(d_input, d_input_tile, kernel_size, i * stride, j * stride);
             }
         }
-    }
+    });
     return d_inputs;
 }
@@ -0,0 +1,54 @@
+#include "mixed_precision.hpp"
+
+namespace ts {
+
+template <int Dim> auto SavedTensor<Dim>::save(Tensor<float, Dim> const &tensor, Precision precision) -> void
+{
+    if (!keep()) {
+        release();
+        return;
+    }
+    _precision = precision;
+    _float = precision == Precision::FLOAT ? tensor : Tensor<float, Dim>{};
+    _bf16 = precision == Precision::BF16 ? tensor.template cast<bf16>() : Tensor<bf16, Dim>{};
+    _fp16 = precision == Precision::FP16 ? tensor.template cast<fp16>() : Tensor<fp16, Dim>{};
+}
+
+template <int Dim> auto SavedTensor<Dim>::load() const -> Tensor<float, Dim>
+{
+    switch (_precision) {
+    case Precision::BF16:
+        return _bf16.template cast<float>();
+    case Precision::FP16:
+        return _fp16.template cast<float>();
+    default:
+        return _float;
+    }
+}
+
+template <int Dim> auto SavedTensor<Dim>::release() -> void
+{
+    _float = Tensor<float, Dim>{};
+    _bf16 = Tensor<bf16, Dim>{};
+    _fp16 = Tensor<fp16, Dim>{};
+}
+
+template <int Dim> auto round_to(Tensor<float, Dim> const &tensor, Precision precision) -> Tensor<float, Dim>
+{
+    switch (precision) {
+    case Precision::BF16:
+        return tensor.template cast<bf16>().template cast<float>();
+    case Precision::FP16:
+        return tensor.template cast<fp16>().template cast<float>();
+    default:
+        return tensor;
+    }
+}
+
+template class SavedTensor<2>;
+template class SavedTensor<4>;
+
+template auto round_to(Tensor<float, 2> const &, Precision) -> Tensor<float, 2>;
+template auto round_to(Tensor<float, 4> const &, Precision) -> Tensor<float, 4>;
+
+} // namespace ts
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "tensor/half.hpp"
+#include "tensor/nn/saving_scope.hpp"
+#include "tensor/tensor.hpp"
+
+// Mixed precision training. Layers switched to BF16 or FP16 with set_precision() keep the activations they need for
+// backward in half precision and round everything they pass on (activations in forward, gradients in backward) to it,
+// which halves the memory that grows with the batch size. Weights stay in float: Variables are the master copies the
+// optimizer updates and all products accumulate in float.
+//
+// FP16 gradients underflow for small values, so the loss is multiplied by a large scale before backward and the
+// gradients are divided by it before the update, see loss_scaler.hpp.
+
+namespace ts {
+
+enum class Precision { FLOAT, BF16, FP16 };
+
+// A tensor saved in forward for backward, in the given precision. Checkpoint can drop it (see saving_scope.hpp).
+template <int Dim> class SavedTensor : public detail::Saved {
+  public:
+    auto save(Tensor<float, Dim> const &tensor, Precision precision) -> void;
+
+    // Widened to float, the saved tensor itself for FLOAT
+    [[nodiscard]] auto load() const -> Tensor<float, Dim>;
+
+    auto release() -> void override;
+
+  private:
+    Precision _precision = Precision::FLOAT;
+    Tensor<float, Dim> _float{};
+    Tensor<bf16, Dim> _bf16{};
+    Tensor<fp16, Dim> _fp16{};
+};
+
+// Values of the tensor rounded to the precision (and kept in float), the same tensor for FLOAT
+template <int Dim> auto round_to(Tensor<float, Dim> const &tensor, Precision precision) -> Tensor<float, Dim>;
+
+} // namespace ts
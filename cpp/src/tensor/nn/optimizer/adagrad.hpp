@@ -23,40 +23,24 @@ template <typename T> class Adagrad : public Optimizer<T> {
 
     auto register_parameters(VectorRef variables) -> void override
     {
-        _register_in_memory(variables);
         Optimizer<T>::register_parameters(std::move(variables));
+        _memory.resize(Optimizer<T>::packed_size());
     }
 
     auto step() -> void override
     {
-        VectorRef params = Optimizer<T>::parameters();
-        for (int i = 0; i < _memory.size(); ++i) {
-            DataHolder<T> &tensor = params[i].get().tensor();
-            DataHolder<T> &grad = params[i].get().grad();
-            std::vector<T> &mem = _memory[i];
-
-            ts::clip_(grad, -5.0f, 5.0f);
-
-            for (int j = 0; j < mem.size(); ++j) {
-                mem[j] += grad.at(j) * grad.at(j);
-                tensor.at(j) += -_lr * grad.at(j) / std::sqrt(mem[j] + 1e-8);
-            }
-        }
+        std::vector<T> none;
+        simd::UpdateParameters parameters{_lr};
+        parameters.epsilon = 1e-8f;
+        Optimizer<T>::fused_update(simd::Update::ADAGRAD, parameters, _memory, none);
     }
 
   private:
     constexpr static double LEARNING_RATE = 1e-2;
 
     float _lr{};
-    std::vector<std::vector<T>> _memory;
-
-    auto _register_in_memory(VectorRef variables) -> void
-    {
-        for (GradHolder<T> &item : variables) {
-            auto size = std::distance(item.tensor().begin(), item.tensor().end());
-            _memory.push_back(std::vector<T>(size));
-        }
-    }
+    // in the layout of the registry
+    std::vector<T> _memory;
 };
 
 } // namespace ts
@@ -15,8 +15,7 @@ template <typename T> class Adam : public Optimizer<T> {
 
     Adam(VectorRef variables, float lr, float beta1, float beta2) : _lr(lr), _beta1(beta1), _beta2(beta2)
     {
-        _register_in_memory(variables);
-        Optimizer<T>::register_parameters(std::move(variables));
+        register_parameters(std::move(variables));
     }
 
     Adam(float lr, float beta1, float beta2) : _lr(lr), _beta1(beta1), _beta2(beta2) {}
@@ -31,8 +30,9 @@ template <typename T> class Adam : public Optimizer<T> {
 
     auto register_parameters(VectorRef variables) -> void override
     {
-        _register_in_memory(variables);
-        Optimizer<T>::register_parameters(variables);
+        Optimizer<T>::register_parameters(std::move(variables));
+        _grad_moving_average.resize(Optimizer<T>::packed_size());
+        _grad_squared_moving_average.resize(Optimizer<T>::packed_size());
     }
 
     auto step() -> void override
@@ -41,23 +41,10 @@ template <typename T> class Adam : public Optimizer<T> {
         float bias_correction1 = 1 - std::pow(_beta1, _step);
         float bias_correction2 = 1 - std::pow(_beta1, _step);
 
-        VectorRef params = Optimizer<T>::parameters();
-        for (int i = 0; i < _grad_moving_average.size(); ++i) {
-            ts::DataHolder<float> &tensor = params[i].get().tensor();
-            ts::DataHolder<float> &grad = params[i].get().grad();
-            std::vector<T> &grad_avg = _grad_moving_average[i];
-            std::vector<T> &grad2_avg = _grad_squared_moving_average[i];
-
-            ts::clip_(grad, -5.0f, 5.0f);
-
-            for (int j = 0; j < grad_avg.size(); ++j) {
-                grad_avg[j] = _beta1 * grad_avg[j] + (1 - _beta1) * grad.at(j);
-                grad2_avg[j] = _beta2 * grad2_avg[j] + (1 - _beta2) * std::pow(grad.at(j), 2);
-                float denom = std::sqrt(grad2_avg[j]) / (std::sqrt(bias_correction2) + 1e-8);
-                float step_size = _lr / bias_correction1;
-                tensor.at(j) -= step_size * grad_avg[j] / denom;
-            }
-        }
+        // epsilon outside of the square root like in PyTorch, a zero gradient must not give 0 / 0
+        simd::UpdateParameters parameters{_lr / bias_correction1, _beta1, _beta2, 1e-8f, std::sqrt(bias_correction2)};
+        Optimizer<T>::fused_update(simd::Update::ADAM, parameters, _grad_moving_average,
+                                   _grad_squared_moving_average);
         _step++;
     }
 
@@ -67,20 +54,12 @@ template <typename T> class Adam : public Optimizer<T> {
     constexpr static double BETA2 = 0.999;
 
     float _lr{};
-    std::vector<std::vector<T>> _grad_moving_average;
-    std::vector<std::vector<T>> _grad_squared_moving_average;
+    // in the layout of the registry
+    std::vector<T> _grad_moving_average;
+    std::vector<T> _grad_squared_moving_average;
     float _beta1{};
     float _beta2{};
     int _step = 1;
-
-    auto _register_in_memory(VectorRef variables) -> void
-    {
-        for (GradHolder<T> &item : variables) {
-            auto size = std::distance(item.tensor().begin(), item.tensor().end());
-            _grad_moving_average.push_back(std::vector<T>(size));
-            _grad_squared_moving_average.push_back(std::vector<T>(size));
-        }
-    }
 };
 
 } // namespace ts
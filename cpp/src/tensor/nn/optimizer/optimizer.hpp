@@ -1,20 +1,128 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
 #include "tensor/nn/parameters_registry.hpp"
 #include "tensor/ops_common.hpp"
+#include "tensor/parallel.hpp"
+#include "tensor/simd.hpp"
 
 namespace ts {
 
 template <typename T> class Optimizer : public ParameterRegistry<T> {
   public:
+    // Row-sparse gradients only drop their rows, a single memset covers the arena when there are none
     auto zero_gradients() -> void
     {
+        bool sparse = false;
         for (auto &item : ParameterRegistry<T>::parameters()) {
-            ts::fill_(item.get().grad(), T(0));
+            if (auto *grad = item.get().sparse_grad(); grad != nullptr) {
+                grad->clear();
+                sparse = true;
+            }
+        }
+        if (ParameterRegistry<T>::is_packed() && !sparse) {
+            std::memset(ParameterRegistry<T>::packed_gradients(), 0, ParameterRegistry<T>::packed_size() * sizeof(T));
+            return;
         }
+        for_each_slice([](T *, T *grad, size_type, size_type size) { std::memset(grad, 0, size * sizeof(T)); });
     }
 
     virtual auto step() -> void = 0;
+
+  protected:
+    // Clips the gradients and updates the parameters and the state in a single pass (see simd::Update), parameters
+    // are split between threads in chunks. m and v are in the layout of the registry, empty if not used. Parameters
+    // with a row-sparse gradient get the update on their rows only (see sparse_update).
+    auto fused_update(simd::Update update, simd::UpdateParameters const &parameters, std::vector<T> &m,
+                      std::vector<T> &v) -> void
+    {
+        static_assert(std::is_same_v<T, float>, "the optimizers update float parameters");
+        for_each_slice([&](T *tensor, T *grad, size_type offset, size_type size) {
+            T *m_slice = m.empty() ? nullptr : m.data() + offset;
+            T *v_slice = v.empty() ? nullptr : v.data() + offset;
+            parallel_for(
+                size,
+                [&](size_type begin, size_type end) {
+                    simd::kernels().update(update, parameters, tensor + begin, grad + begin,
+                                           m_slice != nullptr ? m_slice + begin : nullptr,
+                                           v_slice != nullptr ? v_slice + begin : nullptr, end - begin);
+                },
+                elements_per_cache_line<T>);
+        });
+        sparse_update(update, parameters, m, v);
+    }
+
+    // The same update for the rows of the row-sparse gradients. The other rows and their state aren't touched, they
+    // aren't decayed as a zero gradient would do (lazy, e.g. Adam moments of a row move only on steps which use it).
+    auto sparse_update(simd::Update update, simd::UpdateParameters const &parameters, std::vector<T> &m,
+                       std::vector<T> &v) -> void
+    {
+        auto &params = ParameterRegistry<T>::parameters();
+        for (size_type i = 0; i < params.size(); ++i) {
+            GradHolder<T> &param = params[i].get();
+            auto *grad = param.sparse_grad();
+            if (grad == nullptr || grad->empty()) {
+                continue;
+            }
+            // repeated rows are summed first, every row is then updated once and by a single thread
+            grad->coalesce();
+            size_type rows = grad->size();
+            size_type row_size = grad->row_size();
+            size_type offset = ParameterRegistry<T>::offset(i);
+            T *tensor = &*param.tensor().begin();
+            T *m_param = m.empty() ? nullptr : m.data() + offset;
+            T *v_param = v.empty() ? nullptr : v.data() + offset;
+            auto const &indices = grad->indices();
+            T *values = grad->values();
+            size_type chunks = std::min(detail::parallel_chunks(rows * row_size), rows);
+            detail::run_chunks(rows, chunks, 1, [&](size_type, size_type begin, size_type end) {
+                for (size_type r = begin; r < end; ++r) {
+                    size_type at = indices[r] * row_size;
+                    simd::kernels().update(update, parameters, tensor + at, values + r * row_size,
+                                           m_param != nullptr ? m_param + at : nullptr,
+                                           v_param != nullptr ? v_param + at : nullptr, row_size);
+                }
+            });
+        }
+    }
+
+    // Calls update(weight, grad, offset, size) for the whole arena when the parameters are packed and for every
+    // parameter otherwise, `offset` is where the slice starts in the layout of the registry (and of the state).
+    // Parameters with a row-sparse gradient are left out, the packed arena is then cut around them.
+    template <typename Update> auto for_each_slice(Update update) -> void
+    {
+        auto &params = ParameterRegistry<T>::parameters();
+        auto sparse = [&](size_type i) { return params[i].get().sparse_grad() != nullptr; };
+        if (ParameterRegistry<T>::is_packed()) {
+            for (size_type i = 0; i < params.size();) {
+                if (sparse(i)) {
+                    ++i;
+                    continue;
+                }
+                size_type next = i + 1;
+                while (next < params.size() && !sparse(next)) {
+                    ++next;
+                }
+                size_type begin = ParameterRegistry<T>::offset(i);
+                size_type end =
+                    next < params.size() ? ParameterRegistry<T>::offset(next) : ParameterRegistry<T>::packed_size();
+                update(ParameterRegistry<T>::packed_weights() + begin, ParameterRegistry<T>::packed_gradients() + begin,
+                       begin, end - begin);
+                i = next;
+            }
+            return;
+        }
+        for (size_type i = 0; i < params.size(); ++i) {
+            GradHolder<T> &param = params[i].get();
+            if (size_type size = param.size(); size > 0 && !sparse(i)) {
+                update(&*param.tensor().begin(), &*param.grad().begin(), ParameterRegistry<T>::offset(i), size);
+            }
+        }
+    }
 };
 
 } // namespace ts
@@ -27,25 +27,16 @@ template <typename T> class RMSProp : public Optimizer<T> {
 
     auto register_parameters(VectorRef variables) -> void override
     {
-        _register_in_memory(variables);
         Optimizer<T>::register_parameters(std::move(variables));
+        _grad_moving_average.resize(Optimizer<T>::packed_size());
     }
 
     auto step() -> void override
     {
-        VectorRef params = Optimizer<T>::parameters();
-        for (int i = 0; i < _grad_moving_average.size(); ++i) {
-            ts::DataHolder<float> &tensor = params[i].get().tensor();
-            ts::DataHolder<float> &grad = params[i].get().grad();
-            std::vector<T> &avg = _grad_moving_average[i];
-
-            ts::clip_(grad, -5.0f, 5.0f);
-
-            for (int j = 0; j < avg.size(); ++j) {
-                avg[j] = _alpha * avg[j] + (1 - _alpha) * std::pow(grad.at(j), 2);
-                tensor.at(j) -= _lr * grad.at(j) / (std::sqrt(avg[j]) + 1e-8);
-            }
-        }
+        std::vector<T> none;
+        simd::UpdateParameters parameters{_lr, _alpha};
+        parameters.epsilon = 1e-8f;
+        Optimizer<T>::fused_update(simd::Update::RMSPROP, parameters, _grad_moving_average, none);
     }
 
   private:
@@ -53,16 +44,9 @@ template <typename T> class RMSProp : public Optimizer<T> {
     constexpr static double ALPHA = 0.99;
 
     float _lr{};
-    std::vector<std::vector<T>> _grad_moving_average;
+    // in the layout of the registry
+    std::vector<T> _grad_moving_average;
     float _alpha{};
-
-    auto _register_in_memory(VectorRef const &variables) -> void
-    {
-        for (GradHolder<T> &item : variables) {
-            auto size = std::distance(item.tensor().begin(), item.tensor().end());
-            _grad_moving_average.push_back(std::vector<T>(size));
-        }
-    }
 };
 
 } // namespace ts
@@ -13,12 +13,7 @@ template <typename T> class SGD : public Optimizer<T> {
     using Optimizer<T>::register_parameters;
     using VectorRef = typename Optimizer<T>::VectorRef;
 
-    SGD(float lr, float momentum) : _lr(lr), _momentum(momentum)
-    {
-        if (_momentum > 0.0) {
-            _previous_updates = std::make_optional(std::vector<std::vector<T>>());
-        }
-    }
+    SGD(float lr, float momentum) : _lr(lr), _momentum(momentum) {}
 
     SGD(VectorRef variables, float lr, float momentum) : SGD(lr, momentum) { register_parameters(variables); }
 
@@ -32,32 +27,18 @@ template <typename T> class SGD : public Optimizer<T> {
 
     auto register_parameters(VectorRef variables) -> void override
     {
+        Optimizer<T>::register_parameters(std::move(variables));
         if (_momentum > 0) {
-            _update_momentum_buffer(variables);
+            _previous_updates.resize(Optimizer<T>::packed_size());
         }
-        Optimizer<T>::register_parameters(std::move(variables));
     }
 
     auto step() -> void
     {
-        auto params = Optimizer<T>::parameters();
-        for (int i = 0; i < params.size(); ++i) {
-            DataHolder<T> &tensor = params[i].get().tensor();
-            DataHolder<T> &grad = params[i].get().grad();
-
-            ts::clip_(grad, -5.0f, 5.0f);
-
-            if (_previous_updates) {
-                std::vector<T> &prev = _previous_updates.value()[i];
-                for (int j = 0; j < prev.size(); ++j) {
-                    prev[j] = _momentum * prev[j] + _lr * grad.at(j);
-                    tensor.at(j) += -prev[j];
-                }
-            } else {
-                std::transform(tensor.begin(), tensor.end(), grad.begin(), tensor.begin(),
-                               [&](T &w, T &d_w) { return w - (_lr * d_w); });
-            }
-        }
+        std::vector<T> none;
+        simd::UpdateParameters parameters{_lr, _momentum};
+        Optimizer<T>::fused_update(_momentum > 0 ? simd::Update::MOMENTUM : simd::Update::SGD, parameters,
+                                   _previous_updates, none);
     }
 
   private:
@@ -66,16 +47,8 @@ template <typename T> class SGD : public Optimizer<T> {
 
     float _lr{};
     float const _momentum{};
-    std::optional<std::vector<std::vector<T>>> _previous_updates = std::nullopt;
-
-    auto _update_momentum_buffer(VectorRef variables) -> void
-    {
-        assert(_previous_updates.has_value());
-        for (GradHolder<T> &item : variables) {
-            auto size = std::distance(item.tensor().begin(), item.tensor().end());
-            _previous_updates.value().push_back(std::vector<T>(size));
-        }
-    }
+    // in the layout of the registry, only with momentum
+    std::vector<T> _previous_updates;
 };
 
 } // namespace ts
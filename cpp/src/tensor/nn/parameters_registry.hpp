@@ -1,13 +1,24 @@
 #pragma once
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include "tensor/nn/grad_holder.hpp"
+#include "tensor/parallel.hpp"
 
 namespace ts {
 
+// Every registered parameter gets a slot of a flat layout: slots follow each other in the order of registration and
+// start at cache lines. pack() moves weights and gradients into two buffers with this layout (the arena), after that
+// zeroing gradients is one memset and an optimizer runs one pass over the whole model. Optimizer state is kept in the
+// same layout whether the parameters are packed or not.
 template <typename T> class ParameterRegistry {
   public:
     using Ref = std::reference_wrapper<GradHolder<T>>;
     using VectorRef = std::vector<Ref>;
+    using vector_t = typename DataHolder<T>::vector_t;
+    using data_ptr_t = typename DataHolder<T>::data_ptr_t;
 
     virtual auto register_parameters(GradHolder<T> &param) -> void
     {
@@ -18,13 +29,63 @@ template <typename T> class ParameterRegistry {
     {
         for (const auto &item : params) {
             _params.push_back(item);
+            _offsets.push_back(_size);
+            _size += (item.get().size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
         }
+        // new parameters live outside of the arena, the packed ones stay where they are
+        _weights = nullptr;
+        _grads = nullptr;
     }
 
     auto parameters() -> VectorRef & { return _params; }
 
+    // Moves all registered parameters into the arena, they become views of it. Returns false, with nothing moved, if
+    // one of them can't be moved. Parameters in the arena of another registry are refused too, that registry would go
+    // on zeroing and updating a buffer nobody uses anymore. Pack only the registry which covers all of them (the
+    // optimizer).
+    virtual auto pack() -> bool
+    {
+        for (auto const &param : _params) {
+            auto arena = param.get().arena();
+            if (!param.get().can_move() || (arena != nullptr && arena.get() != _arena)) {
+                return false;
+            }
+        }
+        auto weights = std::make_shared<vector_t>(_size);
+        auto grads = std::make_shared<vector_t>(_size);
+        std::memset(weights->data(), 0, _size * sizeof(T));
+        std::memset(grads->data(), 0, _size * sizeof(T));
+        for (size_type i = 0; i < _params.size(); ++i) {
+            _params[i].get().move_to(weights, grads, _offsets[i]);
+        }
+        _arena = weights.get();
+        _weights = std::move(weights);
+        _grads = std::move(grads);
+        return true;
+    }
+
+    [[nodiscard]] auto is_packed() const -> bool { return _weights != nullptr; }
+
+    // Elements of the layout, with the gaps between parameters
+    [[nodiscard]] auto packed_size() const -> size_type { return _size; }
+
+    [[nodiscard]] auto offset(size_type i) const -> size_type { return _offsets[i]; }
+
+    // nullptr unless packed, gaps between parameters are zeros
+    auto packed_weights() const -> T * { return _weights ? _weights->data() : nullptr; }
+
+    auto packed_gradients() const -> T * { return _grads ? _grads->data() : nullptr; }
+
   private:
+    static constexpr size_type ALIGNMENT = elements_per_cache_line<T>;
+
     VectorRef _params;
+    std::vector<size_type> _offsets;
+    size_type _size = 0;
+    data_ptr_t _weights = nullptr;
+    data_ptr_t _grads = nullptr;
+    // the last arena packed into, it stays ours after register_parameters()
+    vector_t const *_arena = nullptr;
 };
 
 } // namespace ts
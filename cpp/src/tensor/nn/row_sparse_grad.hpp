@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "tensor/tensor_forward.hpp"
+
+namespace ts {
+
+// Gradient of a few rows of a parameter, indices plus values: row indices()[i] gets values()[i * row_size(), (i + 1)
+// * row_size()). Rows can repeat until coalesce() sums them up. Optimizers update only these rows (see
+// Optimizer::fused_update), for parameters like embeddings where a step touches a handful of rows out of many.
+template <typename Element> class RowSparseGrad {
+  public:
+    explicit RowSparseGrad(size_type row_size) : _row_size(row_size) {}
+
+    // Adds row_size() values to row `index`
+    auto add(size_type index, Element const *values) -> void
+    {
+        _indices.push_back(index);
+        _values.insert(_values.end(), values, values + _row_size);
+    }
+
+    auto clear() -> void
+    {
+        _indices.clear();
+        _values.clear();
+    }
+
+    // Sorts the rows and sums up the repeated ones
+    auto coalesce() -> void
+    {
+        // already strictly increasing
+        if (std::adjacent_find(_indices.begin(), _indices.end(), std::greater_equal<>()) == _indices.end()) {
+            return;
+        }
+        std::vector<size_type> order(_indices.size());
+        std::iota(order.begin(), order.end(), size_type(0));
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_type a, size_type b) { return _indices[a] < _indices[b]; });
+
+        std::vector<size_type> indices;
+        std::vector<Element> values;
+        for (size_type i : order) {
+            Element const *row = _values.data() + i * _row_size;
+            if (!indices.empty() && indices.back() == _indices[i]) {
+                Element *sum = values.data() + (indices.size() - 1) * _row_size;
+                std::transform(sum, sum + _row_size, row, sum, std::plus<>());
+            } else {
+                indices.push_back(_indices[i]);
+                values.insert(values.end(), row, row + _row_size);
+            }
+        }
+        _indices = std::move(indices);
+        _values = std::move(values);
+    }
+
+    [[nodiscard]] auto row_size() const -> size_type { return _row_size; }
+
+    // Number of rows, repeated ones included
+    [[nodiscard]] auto size() const -> size_type { return _indices.size(); }
+
+    [[nodiscard]] auto empty() const -> bool { return _indices.empty(); }
+
+    [[nodiscard]] auto indices() const -> std::vector<size_type> const & { return _indices; }
+
+    auto values() -> Element * { return _values.data(); }
+
+    // Adds the rows to a dense gradient of the whole parameter
+    auto add_to(Element *dense) const -> void
+    {
+        for (size_type i = 0; i < _indices.size(); ++i) {
+            Element const *row = _values.data() + i * _row_size;
+            Element *out = dense + _indices[i] * _row_size;
+            std::transform(out, out + _row_size, row, out, std::plus<>());
+        }
+    }
+
+  private:
+    size_type _row_size;
+    std::vector<size_type> _indices{};
+    std::vector<Element> _values{};
+};
+
+} // namespace ts
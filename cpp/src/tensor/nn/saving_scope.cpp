@@ -0,0 +1,35 @@
+#include "saving_scope.hpp"
+
+namespace ts::detail {
+
+namespace {
+
+thread_local bool drop_saved = false;
+thread_local std::vector<Saved *> *record_saved = nullptr;
+
+} // namespace
+
+auto Saved::keep() -> bool
+{
+    if (drop_saved) {
+        return false;
+    }
+    if (record_saved != nullptr) {
+        record_saved->push_back(this);
+    }
+    return true;
+}
+
+SavingScope::SavingScope(bool drop, std::vector<Saved *> *record) : _drop(drop_saved), _record(record_saved)
+{
+    drop_saved = drop;
+    record_saved = record;
+}
+
+SavingScope::~SavingScope()
+{
+    drop_saved = _drop;
+    record_saved = _record;
+}
+
+} // namespace ts::detail
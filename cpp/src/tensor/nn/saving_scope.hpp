@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+// What layers save in forward for backward (SavedTensor, see mixed_precision.hpp) can be dropped or recorded for the
+// steps a Checkpoint runs (see checkpoint.hpp). The scope is per thread.
+
+namespace ts::detail {
+
+class Saved {
+  public:
+    virtual ~Saved() = default;
+
+    virtual auto release() -> void = 0;
+
+  protected:
+    // Called on save, false if the current scope drops saved values. Otherwise the value is added to its record.
+    auto keep() -> bool;
+};
+
+// How saved values behave on the current thread while the scope lives. With `drop` nothing is kept, otherwise every
+// saved value adds itself to `record` (when given) so it can be released after the backward of its steps.
+class SavingScope {
+  public:
+    SavingScope(bool drop, std::vector<Saved *> *record);
+
+    ~SavingScope();
+
+    SavingScope(SavingScope const &) = delete;
+
+    auto operator=(SavingScope const &) -> SavingScope & = delete;
+
+  private:
+    bool _drop;
+    std::vector<Saved *> *_record;
+};
+
+} // namespace ts::detail
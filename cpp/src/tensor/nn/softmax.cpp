@@ -1,5 +1,7 @@
 #include "softmax.hpp"
 
+#include "tensor/expression.hpp"
+
 using namespace ts;
 
 auto ts::softmax(MatrixF const &logits) -> MatrixF
@@ -7,27 +9,24 @@ auto ts::softmax(MatrixF const &logits) -> MatrixF
     constexpr float epsilon = 1e-7f;
     constexpr float almost_one = 1.0f - epsilon;
 
-    auto logits_clone = logits.clone();
-    float c = *std::max_element(logits_clone.begin(), logits_clone.end());
-    subtract_(logits_clone, c);
-
-    auto exp_logits = ts::exp(logits_clone);
-    auto sum_exp = ts::sum(exp_logits, 1);
-    auto probs = ts::divide(exp_logits, sum_exp);
+    // exp(x - logsumexp(x)) is exp(x) / sum(exp(x)) shifted by the maximum of every row, so nothing overflows
+    auto log_sum_exp = ts::logsumexp(logits, 1);
+    MatrixF probs(logits.shape(), uninitialized);
+    for (size_type i = 0; i < logits.shape(0); ++i) {
+        auto row = probs(i);
+        lazy::evaluate(lazy::exp(lazy::subtract(logits(i), log_sum_exp.at(i))), row);
+    }
     ts::clip_(probs, epsilon, almost_one);
     return probs;
 }
 
 auto ts::log_softmax(MatrixF const &logits) -> MatrixF
 {
-    auto logits_clone = logits.clone();
-    float c = *std::max_element(logits_clone.begin(), logits_clone.end());
-    subtract_(logits_clone, c);
-
-    auto exp_logits = exp(logits_clone);
-    auto sum_exp_logits = sum(exp_logits, 1);
-    auto log_sum_exp_logits = log(sum_exp_logits);
-    auto neg_log_sum_exp_logits = -log_sum_exp_logits;
-    MatrixF result = add(logits_clone, neg_log_sum_exp_logits);
+    auto log_sum_exp = ts::logsumexp(logits, 1);
+    MatrixF result(logits.shape(), uninitialized);
+    for (size_type i = 0; i < logits.shape(0); ++i) {
+        auto row = result(i);
+        lazy::evaluate(lazy::subtract(logits(i), log_sum_exp.at(i)), row);
+    }
     return result;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "grad_holder.hpp"
+#include <algorithm>
+#include <optional>
 #include <tensor/tensor.hpp>
 #include <utility>
 
@@ -24,7 +26,7 @@ template <typename Element, int Dim> class Variable : public GradHolder<Element>
         _grad = std::make_unique<Tensor<Element, Dim>>(Tensor<Element, Dim>(_weight->shape()));
     }
 
-    Variable(DataHolderPtr &&weight, DataHolderPtr &&grad) : Variable(weight, grad, "Variable") {}
+    Variable(DataHolderPtr &&weight, DataHolderPtr &&grad) : Variable(std::move(weight), std::move(grad), "Variable") {}
 
     Variable(DataHolderPtr &&weight, DataHolderPtr &&grad, std::string name)
         : _weight(std::move(weight)), _grad(std::move(grad)), _name(std::move(name))
@@ -33,14 +35,54 @@ template <typename Element, int Dim> class Variable : public GradHolder<Element>
 
     auto grad() -> DataHolderRef override { return *_grad; }
     auto tensor() -> DataHolderRef override { return *_weight; }
+    auto tensor() const -> Tensor<Element, Dim> const & { return *_weight; }
     auto name() -> std::string override { return _name; };
     auto set_grad(DataHolderPtr grad) -> void { _grad = std::move(grad); }
     auto set_weight(DataHolderPtr weight) -> void { _weight = std::move(weight); }
 
+    // Tensors are rebound in place, references to them stay valid
+    auto move_to(typename GradHolder<Element>::data_ptr_t weights, typename GradHolder<Element>::data_ptr_t grads,
+                 size_type offset) -> bool override
+    {
+        _arena = weights;
+        *_weight = _view(std::move(weights), offset, *_weight);
+        *_grad = _view(std::move(grads), offset, *_grad);
+        return true;
+    }
+
+    auto can_move() -> bool override { return true; }
+
+    auto arena() -> typename GradHolder<Element>::data_ptr_t override { return _arena; }
+
+    // Keeps the gradient as rows of the first dimension (see RowSparseGrad) rather than in grad(), layers which
+    // support it (Embedding) add to these and optimizers update only those rows. grad() isn't looked at then.
+    auto set_sparse_grad(bool sparse) -> void
+    {
+        if (sparse) {
+            _sparse_grad.emplace(_weight->data_size() / std::max<size_type>(_weight->shape(0), 1));
+        } else {
+            _sparse_grad.reset();
+        }
+    }
+
+    auto sparse_grad() -> RowSparseGrad<Element> * override { return _sparse_grad ? &*_sparse_grad : nullptr; }
+
   private:
+    static auto _view(typename GradHolder<Element>::data_ptr_t data, size_type offset,
+                      Tensor<Element, Dim> const &values) -> Tensor<Element, Dim>
+    {
+        auto begin = data->begin() + offset;
+        Tensor<Element, Dim> view(data, values.shape(), begin, begin + values.data_size());
+        view.assign(values);
+        return view;
+    }
+
+
     DataHolderPtr _weight;
     DataHolderPtr _grad;
     std::string _name;
+    std::optional<RowSparseGrad<Element>> _sparse_grad{};
+    typename GradHolder<Element>::data_ptr_t _arena = nullptr;
 };
 
 } // namespace ts
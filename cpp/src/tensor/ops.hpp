@@ -1,4 +1,7 @@
 #pragma once
 
+#include "ops_broadcast.hpp"
 #include "ops_common.hpp"
 #include "ops_dot.hpp"
+#include "ops_reduce.hpp"
+#include "random.hpp"
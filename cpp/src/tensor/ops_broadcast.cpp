@@ -0,0 +1,192 @@
+#include "ops_broadcast.hpp"
+#include "parallel.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+namespace ts {
+
+namespace {
+
+struct Axis {
+    size_type size;
+    size_type lhs;
+    size_type rhs;
+    size_type out;
+};
+
+template <typename Element, typename Op>
+auto binary_row(Op op, Element const *lhs, size_type lhs_step, Element const *rhs, size_type rhs_step, Element *out,
+                size_type out_step, size_type n) -> void
+{
+    if (out_step == 1 && lhs_step == 1 && rhs_step == 1) {
+        for (size_type i = 0; i < n; ++i) {
+            out[i] = op(lhs[i], rhs[i]);
+        }
+    } else if (out_step == 1 && lhs_step == 1 && rhs_step == 0) {
+        Element value = *rhs;
+        for (size_type i = 0; i < n; ++i) {
+            out[i] = op(lhs[i], value);
+        }
+    } else if (out_step == 1 && lhs_step == 0 && rhs_step == 1) {
+        Element value = *lhs;
+        for (size_type i = 0; i < n; ++i) {
+            out[i] = op(value, rhs[i]);
+        }
+    } else {
+        for (size_type i = 0; i < n; ++i) {
+            out[i * out_step] = op(lhs[i * lhs_step], rhs[i * rhs_step]);
+        }
+    }
+}
+
+template <typename Element>
+auto row(simd::Binary op, Element const *lhs, size_type lhs_step, Element const *rhs, size_type rhs_step, Element *out,
+         size_type out_step, size_type n) -> void
+{
+    if constexpr (std::is_same_v<Element, float>) {
+        if (out_step == 1 && lhs_step <= 1 && rhs_step <= 1 && lhs_step + rhs_step > 0) {
+            simd::kernels().binary(op, lhs, lhs_step, rhs, rhs_step, out, n);
+            return;
+        }
+    }
+    switch (op) {
+    case simd::Binary::ADD:
+        binary_row(std::plus<>(), lhs, lhs_step, rhs, rhs_step, out, out_step, n);
+        break;
+    case simd::Binary::SUBTRACT:
+        binary_row(std::minus<>(), lhs, lhs_step, rhs, rhs_step, out, out_step, n);
+        break;
+    case simd::Binary::MULTIPLY:
+        binary_row(std::multiplies<>(), lhs, lhs_step, rhs, rhs_step, out, out_step, n);
+        break;
+    case simd::Binary::DIVIDE:
+        binary_row(std::divides<>(), lhs, lhs_step, rhs, rhs_step, out, out_step, n);
+        break;
+    case simd::Binary::MAXIMUM:
+        binary_row([](Element a, Element b) { return a > b ? a : b; }, lhs, lhs_step, rhs, rhs_step, out, out_step, n);
+        break;
+    case simd::Binary::MINIMUM:
+        binary_row([](Element a, Element b) { return a < b ? a : b; }, lhs, lhs_step, rhs, rhs_step, out, out_step, n);
+        break;
+    }
+}
+
+auto print_shape(std::ostream &stream, size_type const *shape, int dim) -> void
+{
+    stream << "[";
+    for (int i = 0; i < dim; ++i) {
+        stream << (i > 0 ? ", " : "") << shape[i];
+    }
+    stream << "]";
+}
+
+} // namespace
+
+namespace detail {
+
+template <typename Element>
+auto broadcast(simd::Binary op, int dim, size_type const *shape, Element const *lhs, size_type const *lhs_strides,
+               Element const *rhs, size_type const *rhs_strides, Element *out, size_type const *out_strides) -> void
+{
+    // axes of size 1 are dropped, an axis is merged into the one before if that one just steps over it in every operand
+    std::vector<Axis> axes;
+    for (int i = 0; i < dim; ++i) {
+        if (shape[i] == 0) {
+            return;
+        }
+        if (shape[i] == 1) {
+            continue;
+        }
+        Axis axis{shape[i], lhs_strides[i], rhs_strides[i], out_strides[i]};
+        if (!axes.empty()) {
+            Axis &outer = axes.back();
+            if (outer.lhs == axis.lhs * axis.size && outer.rhs == axis.rhs * axis.size &&
+                outer.out == axis.out * axis.size) {
+                outer = {outer.size * axis.size, axis.lhs, axis.rhs, axis.out};
+                continue;
+            }
+        }
+        axes.push_back(axis);
+    }
+    if (axes.empty()) {
+        axes.push_back({1, 0, 0, 0});
+    }
+    Axis inner = axes.back();
+    axes.pop_back();
+    size_type rows = 1;
+    for (auto const &axis : axes) {
+        rows *= axis.size;
+    }
+
+    if (rows == 1) {
+        parallel_for(
+            inner.size,
+            [&](size_type begin, size_type end) {
+                row(op, lhs + begin * inner.lhs, inner.lhs, rhs + begin * inner.rhs, inner.rhs, out + begin * inner.out,
+                    inner.out, end - begin);
+            },
+            elements_per_cache_line<Element>);
+        return;
+    }
+
+    // rows [begin, end), the offsets of the first one are computed once and then moved like an odometer
+    auto run_rows = [&](size_type begin, size_type end) {
+        int outer_dim = static_cast<int>(axes.size());
+        std::vector<size_type> index(outer_dim);
+        size_type lhs_offset = 0;
+        size_type rhs_offset = 0;
+        size_type out_offset = 0;
+        size_type position = begin;
+        for (int a = outer_dim - 1; a >= 0; --a) {
+            index[a] = position % axes[a].size;
+            position /= axes[a].size;
+            lhs_offset += index[a] * axes[a].lhs;
+            rhs_offset += index[a] * axes[a].rhs;
+            out_offset += index[a] * axes[a].out;
+        }
+        for (size_type r = begin; r < end; ++r) {
+            row(op, lhs + lhs_offset, inner.lhs, rhs + rhs_offset, inner.rhs, out + out_offset, inner.out, inner.size);
+            for (int a = outer_dim - 1; a >= 0; --a) {
+                lhs_offset += axes[a].lhs;
+                rhs_offset += axes[a].rhs;
+                out_offset += axes[a].out;
+                if (++index[a] < axes[a].size) {
+                    break;
+                }
+                lhs_offset -= axes[a].lhs * axes[a].size;
+                rhs_offset -= axes[a].rhs * axes[a].size;
+                out_offset -= axes[a].out * axes[a].size;
+                index[a] = 0;
+            }
+        }
+    };
+
+    size_type chunks = std::min(parallel_chunks(rows * inner.size), rows);
+    if (chunks <= 1) {
+        run_rows(0, rows);
+        return;
+    }
+    run_chunks(rows, chunks, 1, [&](size_type, size_type begin, size_type end) { run_rows(begin, end); });
+}
+
+auto broadcast_error(size_type const *lhs, int lhs_dim, size_type const *rhs, int rhs_dim) -> void
+{
+    std::cerr << "broadcast: shapes ";
+    print_shape(std::cerr, lhs, lhs_dim);
+    std::cerr << " and ";
+    print_shape(std::cerr, rhs, rhs_dim);
+    std::cerr << " don't match" << std::endl;
+    exit(-1);
+}
+
+template auto broadcast(simd::Binary, int, size_type const *, float const *, size_type const *, float const *,
+                        size_type const *, float *, size_type const *) -> void;
+template auto broadcast(simd::Binary, int, size_type const *, int const *, size_type const *, int const *,
+                        size_type const *, int *, size_type const *) -> void;
+
+} // namespace detail
+} // namespace ts
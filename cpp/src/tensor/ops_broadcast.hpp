@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "allocator.hpp"
+#include "simd.hpp"
+#include "tensor_forward.hpp"
+
+// Elementwise ops with numpy broadcasting: shapes are aligned at the last axis, missing leading axes and axes of size 1
+// are repeated to match the other operand. [B, C, H, W] + [1, C, 1, 1] adds a value per channel, [N, M] * [M] scales
+// every row by the same vector. The result has the rank of the bigger operand.
+//
+// Repeated axes get a stride of 0 and axes which are contiguous in every operand are merged, so the innermost loop
+// ends up as one of: row with row, row with a single repeated value or a strided loop (views, permuted tensors). The
+// first two go through the SIMD kernels for floats. Views are read in place, nothing is copied.
+//
+// divide(MatrixF, VectorF) from ops_common.hpp predates this, it divides row i by vector(i) (and adds 1e-10). Reshape
+// the vector to [N, 1] to get the same thing from the broadcasting divide.
+
+namespace ts {
+
+namespace detail {
+
+// out = lhs op rhs over `shape`, strides are in elements (0 for repeated axes). out may be lhs or rhs if it has the
+// same strides
+template <typename Element>
+auto broadcast(simd::Binary op, int dim, size_type const *shape, Element const *lhs, size_type const *lhs_strides,
+               Element const *rhs, size_type const *rhs_strides, Element *out, size_type const *out_strides) -> void;
+
+[[noreturn]] auto broadcast_error(size_type const *lhs, int lhs_dim, size_type const *rhs, int rhs_dim) -> void;
+
+template <int Dim, std::size_t L, std::size_t R>
+auto broadcast_shape(std::array<size_type, L> const &lhs, std::array<size_type, R> const &rhs)
+    -> std::array<size_type, Dim>
+{
+    constexpr int LDim = L;
+    constexpr int RDim = R;
+    std::array<size_type, Dim> shape{};
+    for (int i = 0; i < Dim; ++i) {
+        size_type l = i < Dim - LDim ? 1 : lhs[i - (Dim - LDim)];
+        size_type r = i < Dim - RDim ? 1 : rhs[i - (Dim - RDim)];
+        if (l != r && l != 1 && r != 1) {
+            broadcast_error(lhs.data(), LDim, rhs.data(), RDim);
+        }
+        shape[i] = l == 1 ? r : l;
+    }
+    return shape;
+}
+
+// Strides of `tensor` aligned with a broadcast shape of rank Dim
+template <int Dim, typename Element, int TDim>
+auto broadcast_strides(Tensor<Element, TDim> const &tensor) -> std::array<size_type, Dim>
+{
+    std::array<size_type, Dim> strides{};
+    auto shape = tensor.shape();
+    auto tensor_strides = tensor.strides();
+    for (int i = 0; i < TDim; ++i) {
+        strides[Dim - TDim + i] = shape[i] == 1 ? 0 : tensor_strides[i];
+    }
+    return strides;
+}
+
+template <typename Element, int LDim, int RDim>
+auto broadcast(simd::Binary op, Tensor<Element, LDim> const &lhs, Tensor<Element, RDim> const &rhs)
+    -> Tensor<Element, std::max(LDim, RDim)>
+{
+    constexpr int Dim = std::max(LDim, RDim);
+    auto shape = broadcast_shape<Dim>(lhs.shape(), rhs.shape());
+    Tensor<Element, Dim> result(shape, uninitialized);
+    auto lhs_strides = broadcast_strides<Dim>(lhs);
+    auto rhs_strides = broadcast_strides<Dim>(rhs);
+    auto out_strides = result.strides();
+    broadcast(op, Dim, shape.data(), lhs.raw_data(), lhs_strides.data(), rhs.raw_data(), rhs_strides.data(),
+              result.raw_data_mutable(), out_strides.data());
+    return result;
+}
+
+// x = x op y, y is broadcast to the shape of x (and shouldn't overlap with it)
+template <typename Element, int Dim, int RDim>
+auto broadcast_(simd::Binary op, Tensor<Element, Dim> const &x, Tensor<Element, RDim> const &y) -> void
+{
+    static_assert(RDim <= Dim, "y can't have more axes than x");
+    auto shape = x.shape();
+    if (broadcast_shape<Dim>(shape, y.shape()) != shape) {
+        broadcast_error(shape.data(), Dim, y.shape().data(), RDim);
+    }
+    auto x_strides = broadcast_strides<Dim>(x);
+    auto y_strides = broadcast_strides<Dim>(y);
+    broadcast(op, Dim, shape.data(), x.raw_data(), x_strides.data(), y.raw_data(), y_strides.data(),
+              x.raw_data_mutable(), x_strides.data());
+}
+
+} // namespace detail
+
+template <typename Element, int LDim, int RDim>
+auto add(Tensor<Element, LDim> const &lhs, Tensor<Element, RDim> const &rhs) -> Tensor<Element, std::max(LDim, RDim)>
+{
+    return detail::broadcast(simd::Binary::ADD, lhs, rhs);
+}
+
+template <typename Element, int LDim, int RDim>
+auto subtract(Tensor<Element, LDim> const &lhs, Tensor<Element, RDim> const &rhs)
+    -> Tensor<Element, std::max(LDim, RDim)>
+{
+    return detail::broadcast(simd::Binary::SUBTRACT, lhs, rhs);
+}
+
+template <typename Element, int LDim, int RDim>
+auto multiply(Tensor<Element, LDim> const &lhs, Tensor<Element, RDim> const &rhs)
+    -> Tensor<Element, std::max(LDim, RDim)>
+{
+    return detail::broadcast(simd::Binary::MULTIPLY, lhs, rhs);
+}
+
+template <typename Element, int LDim, int RDim>
+auto divide(Tensor<Element, LDim> const &lhs, Tensor<Element, RDim> const &rhs)
+    -> Tensor<Element, std::max(LDim, RDim)>
+{
+    return detail::broadcast(simd::Binary::DIVIDE, lhs, rhs);
+}
+
+template <typename Element, int LDim, int RDim>
+auto maximum(Tensor<Element, LDim> const &lhs, Tensor<Element, RDim> const &rhs)
+    -> Tensor<Element, std::max(LDim, RDim)>
+{
+    return detail::broadcast(simd::Binary::MAXIMUM, lhs, rhs);
+}
+
+template <typename Element, int LDim, int RDim>
+auto minimum(Tensor<Element, LDim> const &lhs, Tensor<Element, RDim> const &rhs)
+    -> Tensor<Element, std::max(LDim, RDim)>
+{
+    return detail::broadcast(simd::Binary::MINIMUM, lhs, rhs);
+}
+
+template <typename Element, int Dim, int RDim>
+auto add_(Tensor<Element, Dim> const &x, Tensor<Element, RDim> const &y) -> void
+{
+    detail::broadcast_(simd::Binary::ADD, x, y);
+}
+
+template <typename Element, int Dim, int RDim>
+auto subtract_(Tensor<Element, Dim> const &x, Tensor<Element, RDim> const &y) -> void
+{
+    detail::broadcast_(simd::Binary::SUBTRACT, x, y);
+}
+
+template <typename Element, int Dim, int RDim>
+auto multiply_(Tensor<Element, Dim> const &x, Tensor<Element, RDim> const &y) -> void
+{
+    detail::broadcast_(simd::Binary::MULTIPLY, x, y);
+}
+
+template <typename Element, int Dim, int RDim>
+auto divide_(Tensor<Element, Dim> const &x, Tensor<Element, RDim> const &y) -> void
+{
+    detail::broadcast_(simd::Binary::DIVIDE, x, y);
+}
+
+} // namespace ts
@@ -1,4 +1,6 @@
 #include "ops_common.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
 #include "tensor.hpp"
 #include <algorithm>
 #include <cmath>
@@ -14,10 +16,12 @@ template auto mask<float, 4>(Tensor<float, 4> const &, std::function<bool(float)
 template auto add_(Tensor<float, 1> const &, Tensor<float, 1> const &) -> void;
 template auto add_(Tensor<float, 2> const &, Tensor<float, 2> const &) -> void;
 template auto add_(Tensor<float, 3> const &, Tensor<float, 3> const &) -> void;
+template auto add_(Tensor<float, 4> const &, Tensor<float, 4> const &) -> void;
 
 template auto add(Tensor<float, 1> const &, Tensor<float, 1> const &) -> Tensor<float, 1>;
 template auto add(Tensor<float, 2> const &, Tensor<float, 2> const &) -> Tensor<float, 2>;
 template auto add(Tensor<float, 3> const &, Tensor<float, 3> const &) -> Tensor<float, 3>;
+template auto add(Tensor<float, 4> const &, Tensor<float, 4> const &) -> Tensor<float, 4>;
 
 template auto add(Tensor<int, 1> const &, Tensor<int, 1> const &) -> Tensor<int, 1>;
 template auto add(Tensor<int, 2> const &, Tensor<int, 2> const &) -> Tensor<int, 2>;
@@ -47,10 +51,6 @@ template auto pow(Tensor<float, 1> const &, float) -> Tensor<float, 1>;
 template auto pow(Tensor<float, 2> const &, float) -> Tensor<float, 2>;
 template auto pow(Tensor<float, 3> const &, float) -> Tensor<float, 3>;
 
-template auto sum(Tensor<float, 1> const &) -> float;
-template auto sum(Tensor<float, 2> const &) -> float;
-template auto sum(Tensor<float, 3> const &) -> float;
-
 template auto assign_if(Tensor<float, 1> const &, Tensor<char, 1> const &, float) -> Tensor<float, 1>;
 template auto assign_if(Tensor<float, 2> const &, Tensor<char, 2> const &, float) -> Tensor<float, 2>;
 template auto assign_if(Tensor<float, 3> const &, Tensor<char, 3> const &, float) -> Tensor<float, 3>;
@@ -106,58 +106,156 @@ template auto slice(Tensor<int, 2> const &tensor, int from, int to, int axis) ->
 template auto argmax(Tensor<float, 2> const &) -> Tensor<int, 1>;
 template auto argmax(Tensor<int, 2> const &) -> Tensor<int, 1>;
 
+// Half precision storage, computed in float
+template auto add_(Tensor<bf16, 1> const &, Tensor<bf16, 1> const &) -> void;
+template auto add_(Tensor<bf16, 2> const &, Tensor<bf16, 2> const &) -> void;
+template auto add_(Tensor<fp16, 1> const &, Tensor<fp16, 1> const &) -> void;
+template auto add_(Tensor<fp16, 2> const &, Tensor<fp16, 2> const &) -> void;
+
+template auto add(Tensor<bf16, 1> const &, Tensor<bf16, 1> const &) -> Tensor<bf16, 1>;
+template auto add(Tensor<bf16, 2> const &, Tensor<bf16, 2> const &) -> Tensor<bf16, 2>;
+template auto add(Tensor<bf16, 3> const &, Tensor<bf16, 3> const &) -> Tensor<bf16, 3>;
+template auto add(Tensor<fp16, 1> const &, Tensor<fp16, 1> const &) -> Tensor<fp16, 1>;
+template auto add(Tensor<fp16, 2> const &, Tensor<fp16, 2> const &) -> Tensor<fp16, 2>;
+template auto add(Tensor<fp16, 3> const &, Tensor<fp16, 3> const &) -> Tensor<fp16, 3>;
+
+template auto add(Tensor<bf16, 2> const &, Tensor<bf16, 1> const &) -> Tensor<bf16, 2>;
+template auto add(Tensor<fp16, 2> const &, Tensor<fp16, 1> const &) -> Tensor<fp16, 2>;
+
+template auto maximum(bf16, Tensor<bf16, 1> const &) -> Tensor<bf16, 1>;
+template auto maximum(bf16, Tensor<bf16, 2> const &) -> Tensor<bf16, 2>;
+template auto maximum(fp16, Tensor<fp16, 1> const &) -> Tensor<fp16, 1>;
+template auto maximum(fp16, Tensor<fp16, 2> const &) -> Tensor<fp16, 2>;
+
+template auto log(Tensor<bf16, 2> const &) -> Tensor<bf16, 2>;
+template auto log(Tensor<fp16, 2> const &) -> Tensor<fp16, 2>;
+template auto exp(Tensor<bf16, 2> const &) -> Tensor<bf16, 2>;
+template auto exp(Tensor<fp16, 2> const &) -> Tensor<fp16, 2>;
+template auto pow(Tensor<bf16, 2> const &, float) -> Tensor<bf16, 2>;
+template auto pow(Tensor<fp16, 2> const &, float) -> Tensor<fp16, 2>;
+
+template auto multiply(Tensor<bf16, 1> const &tensor, bf16 value) -> Tensor<bf16, 1>;
+template auto multiply(Tensor<bf16, 2> const &tensor, bf16 value) -> Tensor<bf16, 2>;
+template auto multiply(Tensor<fp16, 1> const &tensor, fp16 value) -> Tensor<fp16, 1>;
+template auto multiply(Tensor<fp16, 2> const &tensor, fp16 value) -> Tensor<fp16, 2>;
+
+template auto multiply(Tensor<bf16, 1> const &, Tensor<bf16, 1> const &) -> Tensor<bf16, 1>;
+template auto multiply(Tensor<bf16, 2> const &, Tensor<bf16, 2> const &) -> Tensor<bf16, 2>;
+template auto multiply(Tensor<fp16, 1> const &, Tensor<fp16, 1> const &) -> Tensor<fp16, 1>;
+template auto multiply(Tensor<fp16, 2> const &, Tensor<fp16, 2> const &) -> Tensor<fp16, 2>;
+
+namespace {
+
+constexpr size_type HALF_BLOCK = 256;
+
+// Half precision tensors go through the float kernels, blocks of the inputs are widened into buffers on the stack and
+// the results are rounded once on the way back. kernel(x, out, n) works on floats.
+template <typename Half, typename Kernel> auto map_half(Half const *x, Half *out, size_type size, Kernel kernel) -> void
+{
+    parallel_for(
+        size,
+        [&](size_type begin, size_type end) {
+            float buffer[HALF_BLOCK];
+            for (size_type i = begin; i < end; i += HALF_BLOCK) {
+                size_type n = std::min(HALF_BLOCK, end - i);
+                convert(x + i, buffer, n);
+                kernel(buffer, buffer, n);
+                convert(buffer, out + i, n);
+            }
+        },
+        elements_per_cache_line<Half>);
+}
+
+// kernel(x, y, out, n)
+template <typename Half, typename Kernel>
+auto map_half(Half const *x, Half const *y, Half *out, size_type size, Kernel kernel) -> void
+{
+    parallel_for(
+        size,
+        [&](size_type begin, size_type end) {
+            float buffer_x[HALF_BLOCK];
+            float buffer_y[HALF_BLOCK];
+            for (size_type i = begin; i < end; i += HALF_BLOCK) {
+                size_type n = std::min(HALF_BLOCK, end - i);
+                convert(x + i, buffer_x, n);
+                convert(y + i, buffer_y, n);
+                kernel(buffer_x, buffer_y, buffer_x, n);
+                convert(buffer_x, out + i, n);
+            }
+        },
+        elements_per_cache_line<Half>);
+}
+
+} // namespace
+
 template <typename Element, int Dim> auto add_(Tensor<Element, Dim> const &x, Tensor<Element, Dim> const &y) -> void
 {
-    std::transform(x.begin(), x.end(), y.begin(), x.begin(), std::plus<>());
+    if constexpr (!is_half_v<Element>) {
+        detail::broadcast_(simd::Binary::ADD, x, y);
+    } else {
+        assert(x.shape() == y.shape());
+        if (!x.is_contiguous()) {
+            x.assign(ts::add(x, y));
+            return;
+        }
+        auto values = y.contiguous();
+        map_half(x.raw_data(), values.raw_data(), x.raw_data_mutable(), x.data_size(), simd::kernels().add);
+    }
 }
 
 template <typename Element, int Dim>
 auto add(Tensor<Element, Dim> const &t1, Tensor<Element, Dim> const &t2) -> Tensor<Element, Dim>
 {
-    Tensor<Element, Dim> result(t1);
-    std::transform(t1.begin(), t1.end(), t2.begin(), result.begin(), std::plus<>());
-    return result;
+    if constexpr (!is_half_v<Element>) {
+        return detail::broadcast(simd::Binary::ADD, t1, t2);
+    } else {
+        assert(t1.shape() == t2.shape());
+        if (!t1.is_contiguous() || !t2.is_contiguous()) {
+            return ts::add(t1.contiguous(), t2.contiguous());
+        }
+        Tensor<Element, Dim> result(t1.shape(), uninitialized);
+        map_half(t1.raw_data(), t2.raw_data(), result.raw_data_mutable(), result.data_size(), simd::kernels().add);
+        return result;
+    }
 }
 
 template <typename Element> auto add(Matrix<Element> const &matrix, Vector<Element> const &vector) -> Matrix<Element>
 {
-    Matrix<Element> result(matrix.shape());
-    for (size_type i = 0; i < matrix.shape(0); ++i) {
-        Vector<Element> input_row = matrix(i);
-        Vector<Element> result_row = result(i);
-        std::transform(input_row.begin(), input_row.end(), vector.begin(), result_row.begin(), std::plus());
+    if constexpr (!is_half_v<Element>) {
+        return detail::broadcast(simd::Binary::ADD, matrix, vector);
+    } else {
+        if (!matrix.is_contiguous() || !vector.is_contiguous()) {
+            return ts::add(matrix.contiguous(), vector.contiguous());
+        }
+        Matrix<Element> result(matrix.shape(), uninitialized);
+        for (size_type i = 0; i < matrix.shape(0); ++i) {
+            Vector<Element> input_row = matrix(i);
+            Vector<Element> result_row = result(i);
+            std::transform(input_row.begin(), input_row.end(), vector.begin(), result_row.begin(), std::plus());
+        }
+        return result;
     }
-    return result;
 }
 
 template <typename Element>
 auto add(Tensor<Element, 3> const &tensor, Vector<Element> const &vector) -> Tensor<Element, 3>
 {
-    Tensor<Element, 3> result(tensor.shape());
-    for (size_type i = 0; i < tensor.shape(0); ++i) {
-        for (size_type j = 0; j < tensor.shape(1); ++j) {
-            Vector<Element> values = tensor(i, j);
-            std::transform(values.begin(), values.end(), vector.begin(), result(i, j).begin(), std::plus());
-        }
-    }
-    return result;
+    return detail::broadcast(simd::Binary::ADD, tensor, vector);
 }
 
 template <typename Element> auto add_(Tensor<Element, 3> const &tensor, Vector<Element> const &vector) -> void
 {
-    for (size_type i = 0; i < tensor.shape(0); ++i) {
-        for (size_type j = 0; j < tensor.shape(1); ++j) {
-            Vector<Element> values = tensor(i, j);
-            std::transform(values.begin(), values.end(), vector.begin(), values.begin(), std::plus());
-        }
-    }
+    detail::broadcast_(simd::Binary::ADD, tensor, vector);
 }
 
 auto divide(MatrixF const &matrix, VectorF const &vector) -> MatrixF
 {
     constexpr float epsilon = 1e-10;
     // TODO: divide(matrix, vector, axis=1)?
-    MatrixF result(matrix.shape());
+    if (!matrix.is_contiguous()) {
+        return ts::divide(matrix.contiguous(), vector);
+    }
+    MatrixF result(matrix.shape(), uninitialized);
     for (size_type i = 0; i < vector.shape(0); ++i) {
         auto row = matrix(i);
         std::transform(row.begin(), row.end(), result.begin() + (i * row.data_size()),
@@ -169,124 +267,105 @@ auto divide(MatrixF const &matrix, VectorF const &vector) -> MatrixF
 template <typename Element, int Dim>
 auto maximum(Element value, Tensor<Element, Dim> const &tensor) -> Tensor<Element, Dim>
 {
-    Tensor<Element, Dim> result(tensor.shape());
-    std::transform(tensor.begin(), tensor.end(), result.begin(), [&](Element &e) { return e < value ? value : e; });
+    if (!tensor.is_contiguous()) {
+        return ts::maximum(value, tensor.contiguous());
+    }
+    Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+    if constexpr (std::is_same_v<Element, float>) {
+        float const *input = tensor.raw_data();
+        float *output = result.raw_data_mutable();
+        parallel_for(
+            result.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().maximum(value, input + begin, output + begin, end - begin);
+            },
+            elements_per_cache_line<float>);
+    } else if constexpr (is_half_v<Element>) {
+        float threshold = value;
+        map_half(tensor.raw_data(), result.raw_data_mutable(), result.data_size(),
+                 [threshold](float const *x, float *out, size_type n) {
+                     simd::kernels().maximum(threshold, x, out, n);
+                 });
+    } else {
+        std::transform(tensor.begin(), tensor.end(), result.begin(),
+                       [&](Element &e) { return e < value ? value : e; });
+    }
     return result;
 }
 
 template <typename Element, int Dim>
 auto mask(Tensor<Element, Dim> const &tensor, std::function<bool(Element)> fn) -> Tensor<char, Dim>
 {
-    Tensor<char, Dim> mask(tensor.shape());
-    std::transform(tensor.begin(), tensor.end(), mask.begin(), fn);
-    return mask;
+    return ts::mask<Element, Dim, std::function<bool(Element)>>(tensor, fn);
 }
 
 template <typename Element, int Dim>
 auto assign_if(Tensor<Element, Dim> const &tensor, Tensor<char, Dim> const &predicate, Element value)
     -> Tensor<Element, Dim>
 {
-    return apply_if(
-        tensor, predicate, (std::function<float(float)>)[&](float) { return value; });
+    return ts::apply_if(tensor, predicate, [value](Element) { return value; });
 }
 
 template <typename Element, int Dim>
 auto apply_if(Tensor<Element, Dim> tensor, Tensor<char, Dim> predicate, std::function<Element(Element)> fn)
     -> Tensor<Element, Dim>
 {
-    Tensor<Element, Dim> result(tensor.shape());
-    std::transform(tensor.begin(), tensor.end(), predicate.begin(), result.begin(),
-                   [&](Element &e, bool pred) { return pred ? fn(e) : e; });
-    return result;
+    return ts::apply_if<Element, Dim, Fn<Element>>(tensor, predicate, fn);
 }
 
 template <typename Element, int Dim>
 auto multiply(Tensor<Element, Dim> const &tensor, Element value) -> Tensor<Element, Dim>
 {
-    auto result = tensor.clone();
-    std::transform(tensor.begin(), tensor.end(), result.begin(), [&](Element &e) { return e * value; });
+    if (!tensor.is_contiguous()) {
+        return ts::multiply(tensor.contiguous(), value);
+    }
+    Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+    if constexpr (std::is_same_v<Element, float>) {
+        float const *input = tensor.raw_data();
+        float *output = result.raw_data_mutable();
+        parallel_for(
+            result.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().multiply_scalar(input + begin, value, output + begin, end - begin);
+            },
+            elements_per_cache_line<float>);
+    } else if constexpr (is_half_v<Element>) {
+        float factor = value;
+        map_half(tensor.raw_data(), result.raw_data_mutable(), result.data_size(),
+                 [factor](float const *x, float *out, size_type n) {
+                     simd::kernels().multiply_scalar(x, factor, out, n);
+                 });
+    } else {
+        std::transform(tensor.begin(), tensor.end(), result.begin(), [&](Element &e) { return e * value; });
+    }
     return result;
 }
 
 template <typename Element, int Dim>
 auto multiply(Tensor<Element, Dim> const &t1, Tensor<Element, Dim> const &t2) -> Tensor<Element, Dim>
 {
-    auto result = t1.clone();
-    std::transform(t1.begin(), t1.end(), t2.begin(), result.begin(), [&](Element &e1, Element &e2) { return e1 * e2; });
-    return result;
-}
-
-auto transpose(MatrixF const &matrix) -> MatrixF
-{
-    int m = matrix.shape(1);
-    int n = matrix.shape(0);
-    MatrixF transposed(m, n);
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
-            transposed(i, j) = matrix(j, i);
-        }
-    }
-    return transposed;
-}
-
-auto sum(MatrixF const &matrix, int axis) -> VectorF
-{
-    if (axis == 0) {
-        // np.sum(matrix, axis=0, keepdims=True);
-
-        VectorF result(matrix.shape(1));
-        for (size_type j = 0; j < matrix.shape(1); ++j) {
-            for (size_type i = 0; i < matrix.shape(0); ++i) {
-                result(j) += matrix(i, j);
-            }
-        }
-        return result;
-    } else if (axis == 1) {
-        // np.sum(matrix, axis=1, keepdims=True)
-
-        VectorF result(matrix.shape(0));
-        for (size_type i = 0; i < matrix.shape(0); ++i) {
-            result(i) = ts::sum(matrix(i));
+    if constexpr (!is_half_v<Element>) {
+        return detail::broadcast(simd::Binary::MULTIPLY, t1, t2);
+    } else {
+        assert(t1.shape() == t2.shape());
+        if (!t1.is_contiguous() || !t2.is_contiguous()) {
+            return ts::multiply(t1.contiguous(), t2.contiguous());
         }
+        Tensor<Element, Dim> result(t1.shape(), uninitialized);
+        map_half(t1.raw_data(), t2.raw_data(), result.raw_data_mutable(), result.data_size(),
+                 simd::kernels().multiply);
         return result;
     }
-    assert(false);
-    return VectorF{}; // silencing gcc warning
 }
 
-auto sum_v2(MatrixF const &matrix, int axis) -> VectorF
-{
-    if (axis == 0) {
-        // np.sum(matrix, axis=0, keepdims=True);
-
-        VectorF result(matrix.shape(1));
-        for (size_type j = 0; j < matrix.shape(1); ++j) {
-            for (size_type i = 0; i < matrix.shape(0); ++i) {
-                result(j) += matrix(i, j);
-            }
-        }
-        return result;
-    } else if (axis == 1) {
-        // np.sum(matrix, axis=1, keepdims=True)
-
-        VectorF result(matrix.shape(0));
-        for (size_type i = 0; i < matrix.shape(0); ++i) {
-            result(i) = ts::sum(matrix(i));
-        }
-        return result;
-    }
-    assert(false);
-    return VectorF{}; // silencing gcc warning
-}
+auto transpose(MatrixF const &matrix) -> MatrixF { return matrix.permute({1, 0}); }
 
-template <typename Element, int Dim> auto sum(Tensor<Element, Dim> const &tensor) -> Element
-{
-    return std::accumulate(tensor.begin(), tensor.end(), Element());
-}
+auto sum_v2(MatrixF const &matrix, int axis) -> VectorF { return ts::sum(matrix, axis); }
 
 auto to_one_hot(Tensor<int, 1> const &vector) -> Tensor<char, 2>
 {
-    int max_index = *std::max_element(vector.begin(), vector.end());
+    auto values = vector.contiguous();
+    int max_index = *std::max_element(values.begin(), values.end());
     return to_one_hot(vector, max_index);
 }
 
@@ -311,30 +390,45 @@ auto get(MatrixF const &matrix, Tensor<int, 1> const &indices) -> VectorF
 template <typename Element, int Dim>
 auto apply(Tensor<Element, Dim> const &tensor, Fn<Element> fn) -> Tensor<Element, Dim>
 {
-    Tensor<Element, Dim> result(tensor.shape());
-    std::transform(tensor.begin(), tensor.end(), result.begin(), fn);
-    return result;
+    return ts::apply<Element, Dim, Fn<Element>>(tensor, fn);
 }
 
 template <typename Element, int Dim>
 auto apply_(Tensor<Element, Dim> const &tensor, Fn<Element> fn) -> void
 {
-    std::transform(tensor.begin(), tensor.end(), tensor.begin(), fn);
+    ts::apply_<Element, Dim, Fn<Element>>(tensor, fn);
 }
 
 template <typename Element, int Dim>
 auto apply(Tensor<Element, Dim> const &t1, Tensor<Element, Dim> const &t2, std::function<Element(Element, Element)> fn) -> Tensor<Element, Dim>
 {
-    Tensor<Element, Dim> result(t1.shape());
-    std::transform(t1.begin(), t1.end(), t2.begin(), result.begin(), fn);
-    return result;
+    return ts::apply<Element, Dim, std::function<Element(Element, Element)>>(t1, t2, fn);
 }
 
 template <typename Element, int Dim> auto log(Tensor<Element, Dim> const &tensor) -> Tensor<Element, Dim>
 {
     constexpr float epsilon = 1e-10;
-    Fn<float> log = [](Element e) { return std::log(e + epsilon); };
-    return ts::apply(tensor, log);
+    if constexpr (std::is_same_v<Element, float>) {
+        auto input = tensor.contiguous();
+        Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+        float const *input_data = input.raw_data();
+        float *output = result.raw_data_mutable();
+        parallel_for(
+            result.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().log(input_data + begin, epsilon, output + begin, end - begin);
+            },
+            elements_per_cache_line<float>);
+        return result;
+    } else if constexpr (is_half_v<Element>) {
+        auto input = tensor.contiguous();
+        Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+        map_half(input.raw_data(), result.raw_data_mutable(), result.data_size(),
+                 [](float const *x, float *out, size_type n) { simd::kernels().log(x, epsilon, out, n); });
+        return result;
+    } else {
+        return ts::apply(tensor, [](Element e) { return std::log(e + epsilon); });
+    }
 }
 
 template <typename Element, int Dim>
@@ -342,33 +436,67 @@ template <typename Element, int Dim>
 auto exp(Tensor<Element, Dim> const &tensor) -> Tensor<Element, Dim>
 {
     constexpr float epsilon = 1e-10;
-    Fn<float> exp = [](Element e) { return std::exp(e) + epsilon; };
-    return ts::apply(tensor, exp);
+    if constexpr (std::is_same_v<Element, float>) {
+        auto input = tensor.contiguous();
+        Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+        float const *input_data = input.raw_data();
+        float *output = result.raw_data_mutable();
+        parallel_for(
+            result.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().exp(input_data + begin, epsilon, output + begin, end - begin);
+            },
+            elements_per_cache_line<float>);
+        return result;
+    } else if constexpr (is_half_v<Element>) {
+        auto input = tensor.contiguous();
+        Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+        map_half(input.raw_data(), result.raw_data_mutable(), result.data_size(),
+                 [](float const *x, float *out, size_type n) { simd::kernels().exp(x, epsilon, out, n); });
+        return result;
+    } else {
+        return ts::apply(tensor, [](Element e) { return std::exp(e) + epsilon; });
+    }
 }
 
 template <typename Element, int Dim> auto pow(Tensor<Element, Dim> const &tensor, float value) -> Tensor<Element, Dim>
 {
-    Fn<float> pow = [&value](Element e) { return std::pow(e, value); };
-    return ts::apply(tensor, pow);
+    if constexpr (std::is_same_v<Element, float>) {
+        auto input = tensor.contiguous();
+        Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+        float const *input_data = input.raw_data();
+        float *output = result.raw_data_mutable();
+        parallel_for(
+            result.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().pow(input_data + begin, value, output + begin, end - begin);
+            },
+            elements_per_cache_line<float>);
+        return result;
+    } else if constexpr (is_half_v<Element>) {
+        auto input = tensor.contiguous();
+        Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+        map_half(input.raw_data(), result.raw_data_mutable(), result.data_size(),
+                 [value](float const *x, float *out, size_type n) { simd::kernels().pow(x, value, out, n); });
+        return result;
+    } else {
+        return ts::apply(tensor, [value](Element e) { return std::pow(e, value); });
+    }
 }
 
 template <int Dim> auto randint(int low, int high, std::vector<int> const &shape) -> Tensor<int, Dim>
 {
-    std::random_device rd;
-    std::mt19937 mt(rd());
-    std::uniform_int_distribution<int> dist(low, high);
-
     // TODO: this is weird :P
     std::array<size_type, Dim> _shape;
     std::copy(shape.begin(), shape.end(), _shape.begin());
-    Tensor<int, Dim> tensor(_shape);
-    std::generate(tensor.begin(), tensor.end(), [&]() { return dist(mt); });
+    Tensor<int, Dim> tensor(_shape, uninitialized);
+    randint_(tensor, low, high);
     return tensor;
 }
 
 template <typename Element> auto from_vector(std::vector<Element> vector) -> Tensor<Element, 1>
 {
-    Tensor<Element, 1> array(vector.size());
+    Tensor<Element, 1> array({vector.size()}, uninitialized);
     std::copy(vector.begin(), vector.end(), array.begin());
     return array;
 }
@@ -378,7 +506,7 @@ template <typename Element> auto argmax(Tensor<Element, 2> const &tensor) -> Ten
     int rows = tensor.shape(0);
     Tensor<int, 1> indexes(rows);
     for (int i = 0; i < rows; ++i) {
-        Tensor<Element, 1> row = tensor(i);
+        Tensor<Element, 1> row = tensor(i).contiguous();
         int index = std::max_element(row.begin(), row.end()) - row.begin();
         indexes[i] = index;
     }
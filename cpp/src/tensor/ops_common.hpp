@@ -1,11 +1,12 @@
 #pragma once
+#include "allocator.hpp"
+#include "half.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
 #include "tensor_forward.hpp"
 #include <cassert>
 #include <functional>
-
-#ifdef USE_BLAS
-#include "cblas.h"
-#endif
+#include <type_traits>
 
 namespace ts {
 
@@ -40,12 +41,9 @@ template <typename Element, int Dim> auto multiply(Tensor<Element, Dim> const &,
 template <typename Element, int Dim>
 auto multiply(Tensor<Element, Dim> const &, Tensor<Element, Dim> const &) -> Tensor<Element, Dim>;
 
+// Returns a view, no data is copied
 auto transpose(MatrixF const &) -> MatrixF;
 
-template <typename Element, int Dim> auto sum(Tensor<Element, Dim> const &) -> Element;
-
-auto sum(MatrixF const &, int) -> VectorF;
-
 auto sum_v2(MatrixF const &, int) -> VectorF;
 
 auto to_one_hot(Tensor<int, 1> const &, int) -> Tensor<char, 2>;
@@ -74,14 +72,124 @@ template <typename Element> auto argmax(Tensor<Element, 2> const &tensor) -> Ten
 
 template <typename Element, int axis> auto concatenate(std::vector<Tensor<Element, 1>>) -> decltype(auto);
 
+// Elementwise kernels taking any callable. Unlike the std::function overloads above (kept for the python bindings)
+// the callable is a template parameter, so it gets inlined into the loop and the loop can be vectorized.
+// Big tensors are split between threads, so fn shouldn't have side effects.
+template <typename Element, int Dim, typename Function>
+auto apply(Tensor<Element, Dim> const &tensor, Function fn) -> Tensor<Element, Dim>
+{
+    if (!tensor.is_contiguous()) {
+        return ts::apply(tensor.contiguous(), fn);
+    }
+    Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+    Element const *input = tensor.raw_data();
+    Element *output = result.raw_data_mutable();
+    parallel_for(
+        tensor.data_size(),
+        [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                output[i] = fn(input[i]);
+            }
+        },
+        elements_per_cache_line<Element>);
+    return result;
+}
+
+template <typename Element, int Dim, typename Function>
+auto apply(Tensor<Element, Dim> const &t1, Tensor<Element, Dim> const &t2, Function fn) -> Tensor<Element, Dim>
+{
+    assert(t1.shape() == t2.shape());
+    if (!t1.is_contiguous() || !t2.is_contiguous()) {
+        return ts::apply(t1.contiguous(), t2.contiguous(), fn);
+    }
+    Tensor<Element, Dim> result(t1.shape(), uninitialized);
+    Element const *lhs = t1.raw_data();
+    Element const *rhs = t2.raw_data();
+    Element *output = result.raw_data_mutable();
+    parallel_for(
+        t1.data_size(),
+        [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                output[i] = fn(lhs[i], rhs[i]);
+            }
+        },
+        elements_per_cache_line<Element>);
+    return result;
+}
+
+template <typename Element, int Dim, typename Function>
+auto apply_(Tensor<Element, Dim> const &tensor, Function fn) -> void
+{
+    if (!tensor.is_contiguous()) {
+        tensor.assign(ts::apply(tensor, fn));
+        return;
+    }
+    Element *data = tensor.raw_data_mutable();
+    parallel_for(
+        tensor.data_size(),
+        [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                data[i] = fn(data[i]);
+            }
+        },
+        elements_per_cache_line<Element>);
+}
+
+template <typename Element, int Dim, typename Function>
+auto apply_if(Tensor<Element, Dim> const &tensor, Tensor<char, Dim> const &predicate, Function fn)
+    -> Tensor<Element, Dim>
+{
+    assert(tensor.shape() == predicate.shape());
+    if (!tensor.is_contiguous() || !predicate.is_contiguous()) {
+        return ts::apply_if(tensor.contiguous(), predicate.contiguous(), fn);
+    }
+    Tensor<Element, Dim> result(tensor.shape(), uninitialized);
+    Element const *input = tensor.raw_data();
+    char const *pred = predicate.raw_data();
+    Element *output = result.raw_data_mutable();
+    parallel_for(
+        tensor.data_size(),
+        [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                output[i] = pred[i] ? fn(input[i]) : input[i];
+            }
+        },
+        elements_per_cache_line<Element>);
+    return result;
+}
+
+template <typename Element, int Dim, typename Predicate>
+auto mask(Tensor<Element, Dim> const &tensor, Predicate fn) -> Tensor<char, Dim>
+{
+    if (!tensor.is_contiguous()) {
+        return ts::mask(tensor.contiguous(), fn);
+    }
+    Tensor<char, Dim> result(tensor.shape(), uninitialized);
+    Element const *input = tensor.raw_data();
+    char *output = result.raw_data_mutable();
+    parallel_for(
+        tensor.data_size(),
+        [&](size_type begin, size_type end) {
+            for (size_type i = begin; i < end; ++i) {
+                output[i] = static_cast<char>(fn(input[i]));
+            }
+        },
+        elements_per_cache_line<char>);
+    return result;
+}
+
 // for some unknown reasons this couldn't be in .cpp file :(
 template <typename Element, int axis> auto concatenate(std::vector<Tensor<Element, 1>> list) -> decltype(auto)
 {
     using vec_size_type = typename std::vector<Tensor<Element, 1>>::size_type;
 
+    for (auto &v : list) {
+        v = v.contiguous();
+    }
+
     if constexpr (axis == 1) {
         ts::size_type vector_size = list[0].shape(0);
-        Tensor<Element, 2> tensor(vector_size, list.size());
+        Tensor<Element, 2> tensor({vector_size, list.size()}, uninitialized);
         for (size_type i = 0; i < vector_size; ++i) {
             for (vec_size_type j = 0; j < list.size(); ++j) {
                 tensor(i, j) = list[j][i];
@@ -94,7 +202,7 @@ template <typename Element, int axis> auto concatenate(std::vector<Tensor<Elemen
             rows += v.shape(0);
         }
 
-        Tensor<Element, 1> tensor(rows);
+        Tensor<Element, 1> tensor({static_cast<size_type>(rows)}, uninitialized);
         int offset = 0;
         for (auto const &v : list) {
             std::copy(v.begin(), v.end(), tensor.begin() + offset);
@@ -110,6 +218,10 @@ template <typename Element> auto concatenate(std::vector<Tensor<Element, 2>> lis
 {
     using vec_size_type = typename std::vector<Tensor<Element, 1>>::size_type;
 
+    for (auto &v : list) {
+        v = v.contiguous();
+    }
+
     if (axis == 1) {
         int rows = list[0].shape(0);
         int columns = 0;
@@ -118,7 +230,7 @@ template <typename Element> auto concatenate(std::vector<Tensor<Element, 2>> lis
             columns += v.shape(1);
         }
 
-        Tensor<Element, 2> output(rows, columns);
+        Tensor<Element, 2> output({static_cast<size_type>(rows), static_cast<size_type>(columns)}, uninitialized);
         for (size_type i = 0; i < rows; ++i) {
             auto output_row = output(i);
             int offset = 0;
@@ -137,7 +249,7 @@ template <typename Element> auto concatenate(std::vector<Tensor<Element, 2>> lis
             rows += v.shape(0);
         }
 
-        Tensor<Element, 2> output(rows, columns);
+        Tensor<Element, 2> output({static_cast<size_type>(rows), static_cast<size_type>(columns)}, uninitialized);
         int offset = 0;
         for (Tensor<Element, 2> const &v : list) {
             std::copy(v.begin(), v.end(), std::next(output.begin(), offset));
@@ -148,37 +260,23 @@ template <typename Element> auto concatenate(std::vector<Tensor<Element, 2>> lis
     return ts::Tensor<Element, 2>();
 }
 
+// Slices are views sharing data with the sliced tensor, call clone() for a copy
 template <typename Element> auto slice(Tensor<Element, 2> const &tensor, int from, int to, int axis) -> Tensor<Element, 2>
 {
-    if (axis == 0) {
-        std::array<size_type, 2> shape(tensor.shape());
-        shape[0] = to - from;
-        int row_size = tensor.shape(1);
-
-        Tensor<Element, 2> slice(shape);
-        int begin_offset = from * row_size;
-        int end_offset = to * row_size;
-        std::copy(tensor.begin() + begin_offset, tensor.begin() + end_offset, slice.begin());
-        return slice;
-    } else if (axis == 1) {
-        int rows = tensor.shape(0);
-        int columns = to - from;
-        Tensor<Element, 2> output(rows, columns);
-        for (int i = 0; i < rows; ++i) {
-            auto vec = slice(tensor(i), from, to);
-            auto out_vec = output(i);
-            std::copy(vec.begin(), vec.end(), out_vec.begin());
-        }
-        return output;
+    if (axis != 0 && axis != 1) {
+        return ts::Tensor<Element, 2>();
     }
-    return ts::Tensor<Element, 2>();
+    std::array<size_type, 2> shape(tensor.shape());
+    shape[axis] = to - from;
+    auto strides = tensor.strides();
+    return Tensor<Element, 2>(tensor.data(), shape, strides, std::next(tensor.begin(), from * strides[axis]));
 }
 
 template <typename Element> auto slice(Tensor<Element, 1> tensor, int from, int to) -> Tensor<Element, 1>
 {
-    Tensor<Element, 1> slice(to - from);
-    std::copy(std::next(tensor.begin(), from), std::next(tensor.begin(), to), slice.begin());
-    return slice;
+    auto strides = tensor.strides();
+    return Tensor<Element, 1>(tensor.data(), {static_cast<size_type>(to - from)}, strides,
+                              std::next(tensor.begin(), from * strides[0]));
 }
 
 template <typename T> auto swap(T &t1, T &t2)
@@ -188,9 +286,20 @@ template <typename T> auto swap(T &t1, T &t2)
     t2 = std::move(temp);
 }
 
-template <typename Element> auto clip_(DataHolder<Element> &data, Element min, Element max) -> void
+namespace detail {
+
+template <typename Element> auto clip(Element *values, size_type size, Element min, Element max) -> void
 {
-    std::transform(data.begin(), data.end(), data.begin(), [min, max](auto &value) {
+    if constexpr (std::is_same_v<Element, float>) {
+        parallel_for(
+            size,
+            [&](size_type begin, size_type end) {
+                simd::kernels().clip(values + begin, min, max, values + begin, end - begin);
+            },
+            elements_per_cache_line<Element>);
+        return;
+    }
+    std::transform(values, values + size, values, [min, max](auto &value) {
         if (value < min)
             return min;
         else if (value > max)
@@ -200,60 +309,137 @@ template <typename Element> auto clip_(DataHolder<Element> &data, Element min, E
     });
 }
 
+template <typename Element> auto fill(Element *values, size_type size, Element value) -> void
+{
+    if constexpr (std::is_same_v<Element, float>) {
+        parallel_for(
+            size,
+            [&](size_type begin, size_type end) { simd::kernels().fill(values + begin, value, end - begin); },
+            elements_per_cache_line<Element>);
+        return;
+    }
+    std::fill(values, values + size, value);
+}
+
+} // namespace detail
+
+// The elements of a holder are taken as one flat range (parameters and gradients), the Tensor overloads handle views
+template <typename Element> auto clip_(DataHolder<Element> &data, Element min, Element max) -> void
+{
+    if (auto size = std::distance(data.begin(), data.end()); size > 0) {
+        detail::clip(&*data.begin(), static_cast<size_type>(size), min, max);
+    }
+}
+
+template <typename Element, int Dim> auto clip_(Tensor<Element, Dim> const &tensor, Element min, Element max) -> void
+{
+    if (!tensor.is_contiguous()) {
+        ts::apply_(tensor, [min, max](Element e) { return e < min ? min : (e > max ? max : e); });
+        return;
+    }
+    detail::clip(tensor.raw_data_mutable(), tensor.data_size(), min, max);
+}
+
 template <typename Element, int Dim> auto clip_max_(Tensor<Element, Dim> &tensor, Element max) -> void
 {
-    std::transform(tensor.begin(), tensor.end(), tensor.begin(),
-                   [max](auto &value) { return value > max ? max : value; });
+    ts::apply_(tensor, [max](Element e) { return e > max ? max : e; });
 }
 
 template <typename Element, int Dim> auto clip_min_(Tensor<Element, Dim> &tensor, Element min) -> void
 {
-    std::transform(tensor.begin(), tensor.end(), tensor.begin(),
-                   [min](auto &value) { return value < min ? min : value; });
+    ts::apply_(tensor, [min](Element e) { return e < min ? min : e; });
 }
 
 template <typename Element, int Dim> auto add_(Tensor<Element, Dim> &tensor, Element value) -> void
 {
-    std::transform(tensor.begin(), tensor.end(), tensor.begin(), [value](Element e) { return e + value; });
+    ts::apply_(tensor, [value](Element e) { return e + value; });
 }
 
 template <typename Element, int Dim> auto subtract_(Tensor<Element, Dim> const &tensor, Element value) -> void
 {
-    std::transform(tensor.begin(), tensor.end(), tensor.begin(), [value](Element e) { return e - value; });
+    ts::apply_(tensor, [value](Element e) { return e - value; });
 }
 
 
 template <typename Element, int Dim> auto add(Tensor<Element, Dim> &tensor, Element value) -> Tensor<Element, Dim>
 {
-    auto output = tensor.clone();
-    std::transform(tensor.begin(), tensor.end(), output.begin(), [value](Element e) { return e + value; });
+    auto input = tensor.contiguous();
+    Tensor<Element, Dim> output(tensor.shape(), uninitialized);
+    if constexpr (std::is_same_v<Element, float>) {
+        float const *input_data = input.raw_data();
+        float *output_data = output.raw_data_mutable();
+        parallel_for(
+            output.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().add_scalar(input_data + begin, value, output_data + begin, end - begin);
+            },
+            elements_per_cache_line<Element>);
+    } else {
+        std::transform(input.begin(), input.end(), output.begin(), [value](Element e) { return e + value; });
+    }
     return output;
 }
 
 template <typename Element, int Dim> auto subtract(Tensor<Element, Dim> const &tensor, Element value) -> Tensor<Element, Dim>
 {
-    auto output = tensor.clone();
-    std::transform(tensor.begin(), tensor.end(), output.begin(), [value](Element e) { return e - value; });
+    auto input = tensor.contiguous();
+    Tensor<Element, Dim> output(tensor.shape(), uninitialized);
+    if constexpr (std::is_same_v<Element, float>) {
+        float const *input_data = input.raw_data();
+        float *output_data = output.raw_data_mutable();
+        parallel_for(
+            output.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().add_scalar(input_data + begin, -value, output_data + begin, end - begin);
+            },
+            elements_per_cache_line<Element>);
+    } else {
+        std::transform(input.begin(), input.end(), output.begin(), [value](Element e) { return e - value; });
+    }
     return output;
 }
 
 
 template <typename Element, int Dim> auto saxpy_(Tensor<Element, Dim> const &x, Tensor<Element, Dim> const &y) -> void
 {
-#ifdef USE_BLAS
-    auto x_data = x.data()->data() + std::distance(x.data().get()->begin(), x.begin());
-    auto y_data = y.data()->data() + std::distance(y.data().get()->begin(), y.begin());
-    cblas_saxpy(x.data_size(), 1.0f, y_data, 1, x_data, 1);
-#else
-    std::transform(x.begin(), x.end(), y.begin(), x.begin(), std::plus<>());
-#endif
+    if (!x.is_contiguous()) {
+        auto sum = x.contiguous();
+        saxpy_(sum, y);
+        x.assign(sum);
+        return;
+    }
+    if (!y.is_contiguous()) {
+        saxpy_(x, y.contiguous());
+        return;
+    }
+    if constexpr (std::is_same_v<Element, float>) {
+        float const *y_data = y.raw_data();
+        float *x_data = x.raw_data_mutable();
+        parallel_for(
+            x.data_size(),
+            [&](size_type begin, size_type end) {
+                simd::kernels().axpy(1.0f, y_data + begin, x_data + begin, end - begin);
+            },
+            elements_per_cache_line<Element>);
+    } else {
+        std::transform(x.begin(), x.end(), y.begin(), x.begin(), std::plus<>());
+    }
 }
 
 template <typename Element> auto fill_(DataHolder<Element> &x, Element value) -> void
 {
-    for (auto &v : x) {
-        v = value;
+    if (auto size = std::distance(x.begin(), x.end()); size > 0) {
+        detail::fill(&*x.begin(), static_cast<size_type>(size), value);
+    }
+}
+
+template <typename Element, int Dim> auto fill_(Tensor<Element, Dim> const &tensor, Element value) -> void
+{
+    if (!tensor.is_contiguous()) {
+        ts::apply_(tensor, [value](Element) { return value; });
+        return;
     }
+    detail::fill(tensor.raw_data_mutable(), tensor.data_size(), value);
 }
 
 } // namespace ts
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "ops_dot.hpp"
+#include "tensor.hpp"
+
+// Every product goes to the backend detail::select_backend() picks for its size. Builds without BLAS always take the
+// native one.
+
+namespace ts::dispatch {
+
+#ifdef USE_BLAS
+namespace {
+
+auto use_blas(size_type m, size_type n, size_type k) -> bool
+{
+    return detail::select_backend(m, n, k) == Backend::BLAS;
+}
+
+} // namespace
+#endif
+
+auto outer_product(VectorF const &x, VectorF const &y) -> MatrixF
+{
+#ifdef USE_BLAS
+    if (use_blas(x.data_size(), y.data_size(), 1)) {
+        return blas::outer_product(x, y);
+    }
+#endif
+    return naive::outer_product(x, y);
+}
+
+auto dot(VectorF const &a, VectorF const &b) -> float
+{
+#ifdef USE_BLAS
+    if (use_blas(1, 1, a.data_size())) {
+        return blas::dot(a, b);
+    }
+#endif
+    return naive::dot(a, b);
+}
+
+auto dot(MatrixF const &A, VectorF const &x, bool A_T) -> VectorF
+{
+#ifdef USE_BLAS
+    if (use_blas(A.shape(0), 1, A.shape(1))) {
+        return blas::dot(A, x, A_T);
+    }
+#endif
+    return naive::dot(A, x, A_T);
+}
+
+auto dot(MatrixF const &A, MatrixF const &B, bool A_T, bool B_T) -> MatrixF
+{
+#ifdef USE_BLAS
+    if (use_blas(A_T ? A.shape(1) : A.shape(0), B_T ? B.shape(0) : B.shape(1), B_T ? B.shape(1) : B.shape(0))) {
+        return blas::dot(A, B, A_T, B_T);
+    }
+#endif
+    return naive::dot(A, B, A_T, B_T);
+}
+
+auto dot(MatrixF const &A, MatrixF const &B, MatrixF &C, bool A_T, bool B_T, float beta) -> void
+{
+#ifdef USE_BLAS
+    if (use_blas(C.shape(0), C.shape(1), B_T ? B.shape(1) : B.shape(0))) {
+        return blas::dot(A, B, C, A_T, B_T, beta);
+    }
+#endif
+    naive::dot(A, B, C, A_T, B_T, beta);
+}
+
+auto dot(Tensor<float, 3> const &A, MatrixF const &B) -> Tensor<float, 3>
+{
+#ifdef USE_BLAS
+    if (use_blas(A.shape(0) * A.shape(1), B.shape(1), B.shape(0))) {
+        return blas::dot(A, B);
+    }
+#endif
+    return naive::dot(A, B);
+}
+
+auto dot(Tensor<float, 3> const &A, MatrixF const &B, Tensor<float, 3> &C, bool B_T, float beta) -> void
+{
+#ifdef USE_BLAS
+    if (use_blas(C.shape(0) * C.shape(1), C.shape(2), B_T ? B.shape(1) : B.shape(0))) {
+        return blas::dot(A, B, C, B_T, beta);
+    }
+#endif
+    naive::dot(A, B, C, B_T, beta);
+}
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, bool A_T, bool B_T) -> Tensor<float, 3>
+{
+    // samples are separate calls, each of them has to be worth a BLAS call on its own
+#ifdef USE_BLAS
+    if (use_blas(A_T ? A.shape(2) : A.shape(1), B_T ? B.shape(1) : B.shape(2), B_T ? B.shape(2) : B.shape(1))) {
+        return blas::dot(A, B, A_T, B_T);
+    }
+#endif
+    return naive::dot(A, B, A_T, B_T);
+}
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, Tensor<float, 3> &C, bool A_T, bool B_T, float beta)
+    -> void
+{
+#ifdef USE_BLAS
+    if (use_blas(C.shape(1), C.shape(2), B_T ? B.shape(2) : B.shape(1))) {
+        return blas::dot(A, B, C, A_T, B_T, beta);
+    }
+#endif
+    naive::dot(A, B, C, A_T, B_T, beta);
+}
+
+} // namespace ts::dispatch
@@ -2,18 +2,45 @@
 #include "tensor_forward.hpp"
 #include <vector>
 
+// Both backends are declared, ts::dot picks one of them on every call (see backend.hpp). ts::blas is only there in
+// builds with BLAS.
+#include "backend.hpp"
 #ifdef USE_BLAS
 #include "ops_dot_blas.hpp"
-namespace ts {
-using namespace blas;
-}
-#else
+#endif
 #include "ops_dot_naive.hpp"
+
+namespace ts::dispatch {
+
+auto outer_product(VectorF const &, VectorF const &) -> MatrixF;
+
+auto dot(VectorF const &, VectorF const &) -> float;
+
+auto dot(MatrixF const &, VectorF const &, bool A_T = false) -> VectorF;
+
+auto dot(MatrixF const &A, MatrixF const &B, bool A_T = false, bool B_T = false) -> MatrixF;
+
+auto dot(MatrixF const &A, MatrixF const &B, MatrixF &C, bool A_T = false, bool B_T = false, float beta = 0.0f) -> void;
+
+auto dot(Tensor<float, 3> const &A, MatrixF const &B) -> Tensor<float, 3>;
+
+auto dot(Tensor<float, 3> const &A, MatrixF const &B, Tensor<float, 3> &C, bool B_T = false, float beta = 0.0f)
+    -> void;
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, bool A_T = false, bool B_T = false)
+    -> Tensor<float, 3>;
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, Tensor<float, 3> &C, bool A_T = false,
+         bool B_T = false, float beta = 0.0f) -> void;
+
+} // namespace ts::dispatch
+
 namespace ts {
-using namespace naive;
+using namespace dispatch;
 }
-#endif
 
-#if BUILD_BENCHMARK
-#include "ops_dot_naive.hpp"
-#endif
+// mixed precision products work with either of them
+#include "ops_dot_mixed.hpp"
+namespace ts {
+using namespace mixed;
+}
@@ -1,8 +1,41 @@
 #define OPENBLAS_CONST
 #include "ops_dot_blas.hpp"
 #include "tensor.hpp"
+#include <algorithm>
 #include <cblas.h>
 
+namespace {
+
+// BLAS takes a matrix as a pointer, leading dimension and a transpose flag, which is enough to describe any view
+// with one unit-strided dimension. A transposed view is just the same storage with the flag flipped. Anything
+// else (e.g. a view of every other column) gets copied first.
+struct Operand {
+    ts::MatrixF storage;
+    CBLAS_TRANSPOSE trans;
+    ts::size_type ld;
+    // shape of the matrix as it lies in memory
+    ts::size_type rows;
+    ts::size_type columns;
+};
+
+auto as_operand(ts::MatrixF const &A, bool transpose) -> Operand
+{
+    auto strides = A.strides();
+    ts::size_type rows = A.shape(0);
+    ts::size_type columns = A.shape(1);
+    if (strides[1] == 1 && (rows == 1 || strides[0] >= columns)) {
+        return {A, transpose ? CblasTrans : CblasNoTrans, std::max<ts::size_type>({strides[0], columns, 1}), rows,
+                columns};
+    }
+    if (strides[0] == 1 && (columns == 1 || strides[1] >= rows)) {
+        return {A, transpose ? CblasNoTrans : CblasTrans, std::max<ts::size_type>({strides[1], rows, 1}), columns,
+                rows};
+    }
+    return {A.contiguous(), transpose ? CblasTrans : CblasNoTrans, std::max<ts::size_type>(columns, 1), rows, columns};
+}
+
+} // namespace
+
 namespace ts::blas {
 
 auto outer_product(VectorF const &x, VectorF const &y) -> MatrixF
@@ -13,8 +46,8 @@ auto outer_product(VectorF const &x, VectorF const &y) -> MatrixF
     auto y_data = y.data()->data() + std::distance(y.data().get()->begin(), y.begin());
 
     MatrixF result(x.data_size(), y.data_size());
-    cblas_sger(CBLAS_ORDER::CblasRowMajor, x.data_size(), y.data_size(), 1.0, x_data, 1, y_data, 1,
-               result.data()->data(), y.data_size());
+    cblas_sger(CBLAS_ORDER::CblasRowMajor, x.data_size(), y.data_size(), 1.0, x_data, x.strides()[0], y_data,
+               y.strides()[0], result.data()->data(), y.data_size());
 
     return result;
 }
@@ -25,27 +58,22 @@ auto dot(VectorF const &A, VectorF const &X) -> float
     // underlining data I have to take that into account
     auto A_data = A.data()->data() + std::distance(A.data().get()->begin(), A.begin());
     auto X_data = X.data()->data() + std::distance(X.data().get()->begin(), X.begin());
-    return cblas_sdot(A.data_size(), A_data, 1, X_data, 1);
+    return cblas_sdot(A.data_size(), A_data, A.strides()[0], X_data, X.strides()[0]);
 }
 
 auto dot(MatrixF const &A, VectorF const &X, bool A_T) -> VectorF
 {
-    CBLAS_TRANSPOSE trans_A = CBLAS_TRANSPOSE::CblasNoTrans;
-    size_type lda = A.shape(1);
-    size_type dim_out = A.shape(0);
-    if (A_T) {
-        trans_A = CBLAS_TRANSPOSE::CblasTrans;
-        dim_out = A.shape(1);
-    }
+    size_type dim_out = A_T ? A.shape(1) : A.shape(0);
+    auto a = as_operand(A, A_T);
 
     // A or X could be just view on higher dimensional tensor, if I want to use raw pointer to
     // underlining data I have to take that into account
-    auto A_data = A.data()->data() + std::distance(A.data().get()->begin(), A.begin());
+    auto A_data = a.storage.raw_data_mutable();
     auto X_data = X.data()->data() + std::distance(X.data().get()->begin(), X.begin());
 
-    VectorF Y(dim_out);
-    cblas_sgemv(CBLAS_ORDER::CblasRowMajor, trans_A, A.shape(0), A.shape(1), 1.0f, A_data, lda, X_data, 1, 0.0f,
-                Y.data()->data(), 1);
+    VectorF Y({dim_out}, uninitialized);
+    cblas_sgemv(CBLAS_ORDER::CblasRowMajor, a.trans, a.rows, a.columns, 1.0f, A_data, a.ld, X_data, X.strides()[0],
+                0.0f, Y.data()->data(), 1);
 
     return Y;
 }
@@ -61,55 +89,97 @@ auto dot(MatrixF const &A, MatrixF const &B, bool A_T, bool B_T) -> MatrixF
         n = B.shape(0);
     }
 
-    MatrixF C(m, n);
+    MatrixF C({m, n}, uninitialized);
     dot(A, B, C, A_T, B_T);
     return C;
 }
 
 auto dot(MatrixF const &A, MatrixF const &B, MatrixF &C, bool A_T, bool B_T, float beta) -> void
 {
-    size_type m = A.shape(0);
-    size_type n = B.shape(1);
-    size_type k = A.shape(1);
-    size_type lda = k;
-    size_type ldb = n;
-    CBLAS_TRANSPOSE trans_A = CBLAS_TRANSPOSE::CblasNoTrans;
-    CBLAS_TRANSPOSE trans_B = CBLAS_TRANSPOSE::CblasNoTrans;
+    size_type m = A_T ? A.shape(1) : A.shape(0);
+    size_type n = B_T ? B.shape(0) : B.shape(1);
+    size_type k = A_T ? A.shape(0) : A.shape(1);
 
-    if (A_T) {
-        trans_A = CBLAS_TRANSPOSE::CblasTrans;
-        m = A.shape(1);
-        k = A.shape(0);
-        lda = m;
+    if (C.shape() != std::array<ts::size_type, 2>{m, n}) {
+        return;
     }
-    if (B_T) {
-        trans_B = CBLAS_TRANSPOSE::CblasTrans;
-        n = B.shape(0);
-        ldb = k;
+    // output has to be row-major, computing into a transposed view would need a temporary anyway
+    if (C.strides()[1] != 1 && n > 1) {
+        MatrixF C_contiguous = C.contiguous();
+        dot(A, B, C_contiguous, A_T, B_T, beta);
+        C.assign(C_contiguous);
+        return;
     }
 
+    // views (transposed or sliced) are passed as they are, with leading dimensions and transpose flags
+    auto a = as_operand(A, A_T);
+    auto b = as_operand(B, B_T);
+    size_type ldc = std::max<size_type>({C.strides()[0], n, 1});
+
     // A, B or C could be just view on higher dimensional tensor, if I want to use raw pointer to
     // underlining data I have to take that into account
-    auto A_data = A.data()->data() + std::distance(A.data().get()->begin(), A.begin());
-    auto B_data = B.data()->data() + std::distance(B.data().get()->begin(), B.begin());
+    auto A_data = a.storage.raw_data_mutable();
+    auto B_data = b.storage.raw_data_mutable();
     auto C_data = C.data()->data() + std::distance(C.data().get()->begin(), C.begin());
 
-    if (C.shape() != std::array<ts::size_type, 2>{m, n}) {
+    cblas_sgemm(CBLAS_ORDER::CblasRowMajor, a.trans, b.trans, m, n, k, 1.0f, A_data, a.ld, B_data, b.ld, beta, C_data,
+                ldc);
+}
+
+auto dot(Tensor<float, 3> const &A, MatrixF const &B) -> Tensor<float, 3>
+{
+    Tensor<float, 3> C({A.shape(0), A.shape(1), B.shape(1)}, uninitialized);
+    dot(A, B, C);
+    return C;
+}
+
+auto dot(Tensor<float, 3> const &A, MatrixF const &B, Tensor<float, 3> &C, bool B_T, float beta) -> void
+{
+    auto [batch_size, m, k] = A.shape();
+    size_type n = B_T ? B.shape(0) : B.shape(1);
+    assert(C.shape(0) == batch_size && C.shape(1) == m && C.shape(2) == n);
+    if (batch_size == 0) {
+        return;
+    }
+
+    // rows of A and C evenly spaced across the samples make one product of batch_size * m rows, B is passed once
+    auto a = A.strides();
+    auto c = C.strides();
+    if (a[2] == 1 && a[0] == m * a[1] && c[2] == 1 && c[0] == m * c[1]) {
+        auto b = as_operand(B, B_T);
+        cblas_sgemm(CBLAS_ORDER::CblasRowMajor, CblasNoTrans, b.trans, batch_size * m, n, k, 1.0f,
+                    A.raw_data_mutable(), std::max<size_type>({a[1], k, 1}), b.storage.raw_data_mutable(), b.ld, beta,
+                    C.raw_data_mutable(), std::max<size_type>({c[1], n, 1}));
         return;
     }
-    cblas_sgemm(CBLAS_ORDER::CblasRowMajor, trans_A, trans_B, m, n, k, 1.0f, A_data, lda, B_data, ldb, beta, C_data,
-                C.shape(1));
+    // otherwise every sample is a product written straight into its part of C
+    for (size_type i = 0; i < batch_size; ++i) {
+        auto C_i = C(i);
+        dot(A(i), B, C_i, false, B_T, beta);
+    }
 }
 
-auto dot(Tensor<float, 3> const &A, MatrixF const &B) -> Tensor<float, 3>
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, bool A_T, bool B_T) -> Tensor<float, 3>
+{
+    size_type m = A_T ? A.shape(2) : A.shape(1);
+    size_type n = B_T ? B.shape(1) : B.shape(2);
+
+    Tensor<float, 3> C({A.shape(0), m, n}, uninitialized);
+    dot(A, B, C, A_T, B_T);
+    return C;
+}
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, Tensor<float, 3> &C, bool A_T, bool B_T, float beta)
+    -> void
 {
     size_type batch_size = A.shape(0);
-    std::vector<Tensor<float, 2>> partial;
-    partial.push_back(blas::dot(A(0), B));
-    for (int i = 1; i < batch_size; ++i) {
-        partial.push_back(blas::dot(A(i), B));
+    assert(B.shape(0) == batch_size && C.shape(0) == batch_size && C.shape(1) == (A_T ? A.shape(2) : A.shape(1)) &&
+           C.shape(2) == (B_T ? B.shape(1) : B.shape(2)));
+    // strided batch, one sgemm per sample reading and writing through views
+    for (size_type i = 0; i < batch_size; ++i) {
+        auto C_i = C(i);
+        dot(A(i), B(i), C_i, A_T, B_T, beta);
     }
-    return Tensor<float, 3>(partial);
 }
 
-} // namespace ts::blas
\ No newline at end of file
+} // namespace ts::blas
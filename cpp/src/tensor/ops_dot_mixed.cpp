@@ -0,0 +1,76 @@
+#include "ops_dot_mixed.hpp"
+#include "ops_dot.hpp"
+#include "tensor.hpp"
+
+namespace ts::mixed {
+
+namespace {
+
+// A panel of B is PANEL_K x PANEL_N floats (512KB), it stays in cache while it's multiplied
+constexpr size_type PANEL_K = 256;
+constexpr size_type PANEL_N = 512;
+
+// View of rows [row, row_end) and columns [column, column_end)
+template <typename Element>
+auto block(Matrix<Element> const &A, size_type row, size_type row_end, size_type column, size_type column_end)
+    -> Matrix<Element>
+{
+    auto strides = A.strides();
+    return Matrix<Element>(A.data(), {row_end - row, column_end - column}, strides,
+                           A.begin() + row * strides[0] + column * strides[1]);
+}
+
+template <typename Element> auto widen(Matrix<Element> const &A) -> MatrixF
+{
+    if constexpr (std::is_same_v<Element, float>) {
+        return A;
+    } else {
+        return A.template cast<float>();
+    }
+}
+
+template <typename AElement, typename BElement>
+auto dot_panels(Matrix<AElement> const &A, Matrix<BElement> const &B, bool A_T, bool B_T) -> MatrixF
+{
+    // C(m, n) = A(m, k) * B(k, n), accumulated over panels of k
+    size_type m = A_T ? A.shape(1) : A.shape(0);
+    size_type n = B_T ? B.shape(0) : B.shape(1);
+    size_type k = A_T ? A.shape(0) : A.shape(1);
+
+    MatrixF C(m, n);
+    for (size_type p = 0; p < k; p += PANEL_K) {
+        size_type p_end = std::min(k, p + PANEL_K);
+        MatrixF A_panel = widen(A_T ? block(A, p, p_end, 0, m) : block(A, 0, m, p, p_end));
+        for (size_type j = 0; j < n; j += PANEL_N) {
+            size_type j_end = std::min(n, j + PANEL_N);
+            MatrixF B_panel = widen(B_T ? block(B, j, j_end, p, p_end) : block(B, p, p_end, j, j_end));
+            MatrixF C_panel = block(C, 0, m, j, j_end);
+            ts::dot(A_panel, B_panel, C_panel, A_T, B_T, 1.0f);
+        }
+    }
+    return C;
+}
+
+} // namespace
+
+auto dot(MatrixF const &A, Matrix<bf16> const &B, bool A_T, bool B_T) -> MatrixF
+{
+    return dot_panels(A, B, A_T, B_T);
+}
+
+auto dot(MatrixF const &A, Matrix<fp16> const &B, bool A_T, bool B_T) -> MatrixF
+{
+    return dot_panels(A, B, A_T, B_T);
+}
+
+auto dot(Matrix<bf16> const &A, Matrix<bf16> const &B, bool A_T, bool B_T) -> MatrixF
+{
+    return dot_panels(A, B, A_T, B_T);
+}
+
+auto dot(Matrix<fp16> const &A, Matrix<fp16> const &B, bool A_T, bool B_T) -> MatrixF
+{
+    return dot_panels(A, B, A_T, B_T);
+}
+
+} // namespace ts::mixed
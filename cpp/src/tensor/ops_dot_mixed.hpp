@@ -0,0 +1,18 @@
+#pragma once
+#include "tensor_forward.hpp"
+
+namespace ts::mixed {
+
+// Products with bf16/fp16 operands, accumulated in float. Half precision operands are widened panel by panel into
+// small float buffers and multiplied with the regular float dot (BLAS or naive), so a half precision weight matrix is
+// read from memory in half the bytes and never gets a full float copy.
+
+auto dot(MatrixF const &A, Matrix<bf16> const &B, bool A_T = false, bool B_T = false) -> MatrixF;
+
+auto dot(MatrixF const &A, Matrix<fp16> const &B, bool A_T = false, bool B_T = false) -> MatrixF;
+
+auto dot(Matrix<bf16> const &A, Matrix<bf16> const &B, bool A_T = false, bool B_T = false) -> MatrixF;
+
+auto dot(Matrix<fp16> const &A, Matrix<fp16> const &B, bool A_T = false, bool B_T = false) -> MatrixF;
+
+} // namespace ts::mixed
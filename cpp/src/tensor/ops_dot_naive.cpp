@@ -1,6 +1,34 @@
 #include "ops_dot_naive.hpp"
+#include "gemm.hpp"
 #include "tensor.hpp"
 
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// A, or A^T if transpose, read through the strides of the view
+auto as_operand(ts::MatrixF const &A, bool transpose) -> ts::detail::MatrixRef
+{
+    auto strides = A.strides();
+    if (transpose) {
+        return {A.raw_data(), strides[1], strides[0]};
+    }
+    return {A.raw_data(), strides[0], strides[1]};
+}
+
+// the first sample of A, or its transpose, other samples are strides()[0] further
+auto as_operand(ts::Tensor<float, 3> const &A, bool transpose) -> ts::detail::MatrixRef
+{
+    auto strides = A.strides();
+    if (transpose) {
+        return {A.raw_data(), strides[2], strides[1]};
+    }
+    return {A.raw_data(), strides[1], strides[2]};
+}
+
+} // namespace
+
 namespace ts::naive {
 
 auto outer_product(VectorF const &x, VectorF const &y) -> MatrixF
@@ -16,75 +44,106 @@ auto outer_product(VectorF const &x, VectorF const &y) -> MatrixF
 
 auto dot(VectorF const &a, VectorF const &b) -> float
 {
+    if (!a.is_contiguous() || !b.is_contiguous()) {
+        return dot(a.contiguous(), b.contiguous());
+    }
     return std::inner_product(a.begin(), a.end(), b.begin(), 0.0f);
 }
 
 auto dot(MatrixF const &A, VectorF const &x, bool A_T) -> VectorF
 {
-    // C(m) = A(m, k) * x(k)
-    int m = A_T ? A.shape(1) : A.shape(0);
-    int k = A_T ? A.shape(0) : A.shape(1);
-
-    VectorF y(m);
-
-    for (int i = 0; i < m; i++) {
-        for (int p = 0; p < k; p++) {
-            float value;
-            if (A_T)
-                value = A(p, i) * x(p);
-            else
-                value = A(i, p) * x(p);
-            y(i) += value;
-        }
-    }
+    // y(m) = A(m, k) * x(k)
+    size_type m = A_T ? A.shape(1) : A.shape(0);
+    size_type k = A_T ? A.shape(0) : A.shape(1);
+
+    VectorF y({m}, uninitialized);
+    detail::gemv(m, k, as_operand(A, A_T), x.raw_data(), x.strides()[0], y.raw_data_mutable());
     return y;
 }
 
 auto dot(MatrixF const &A, MatrixF const &B, bool A_T, bool B_T) -> MatrixF
 {
     // C(m, n) = A(m, k) * B(k, n)
-    int m = A_T ? A.shape(1) : A.shape(0);
-    int n = B_T ? B.shape(0) : B.shape(1);
+    size_type m = A_T ? A.shape(1) : A.shape(0);
+    size_type n = B_T ? B.shape(0) : B.shape(1);
 
-    MatrixF C(m, n);
+    MatrixF C({m, n}, uninitialized);
     dot(A, B, C, A_T, B_T);
     return C;
 }
 
-
 auto dot(MatrixF const &A, MatrixF const &B, MatrixF &C, bool A_T, bool B_T, float beta) -> void
 {
     // C(m, n) = A(m, k) * B(k, n) + beta * C(m, n)
-    int m = A_T ? A.shape(1) : A.shape(0);
-    int n = B_T ? B.shape(0) : B.shape(1);
-    int k = A_T ? A.shape(0) : A.shape(1);
-
-    for (int i = 0; i < m; i++) {
-        for (int j = 0; j < n; j++) {
-            float acc = 0;
-            for (int p = 0; p < k; p++) {
-                if (A_T) {
-                    acc += A(p, i) * B(p, j);
-                } else if (B_T) {
-                    acc += A(i, p) * B(j, p);
-                } else {
-                    acc += A(i, p) * B(p, j);
-                }
-            }
-            C(i, j) = acc + beta * C(i, j);
-        }
+    size_type m = A_T ? A.shape(1) : A.shape(0);
+    size_type n = B_T ? B.shape(0) : B.shape(1);
+    size_type k = A_T ? A.shape(0) : A.shape(1);
+    assert(C.shape(0) == m && C.shape(1) == n);
+
+    // output has to be row-major, computing into a transposed view would need a temporary anyway
+    if (C.strides()[1] != 1 && n > 1) {
+        MatrixF C_contiguous = beta == 0.0f ? MatrixF({m, n}, uninitialized) : C.contiguous();
+        dot(A, B, C_contiguous, A_T, B_T, beta);
+        C.assign(C_contiguous);
+        return;
     }
+    detail::gemm(m, n, k, as_operand(A, A_T), as_operand(B, B_T), beta, C.raw_data_mutable(),
+                 std::max<size_type>(C.strides()[0], 1));
 }
 
 auto dot(Tensor<float, 3> const &A, MatrixF const &B) -> Tensor<float, 3>
 {
-    int batch_size = A.shape(0);
-    std::vector<Tensor<float, 2>> partial;
-    partial.push_back(naive::dot(A(0), B));
-    for (int i = 1; i < batch_size; ++i) {
-        partial.push_back(naive::dot(A(i), B));
+    Tensor<float, 3> C({A.shape(0), A.shape(1), B.shape(1)}, uninitialized);
+    dot(A, B, C);
+    return C;
+}
+
+auto dot(Tensor<float, 3> const &A, MatrixF const &B, Tensor<float, 3> &C, bool B_T, float beta) -> void
+{
+    // C(b, m, n) = A(b, m, k) * B(k, n) + beta * C(b, m, n)
+    auto [batch_size, m, k] = A.shape();
+    size_type n = B_T ? B.shape(0) : B.shape(1);
+    assert(C.shape(0) == batch_size && C.shape(1) == m && C.shape(2) == n);
+
+    if (C.strides()[2] != 1 && n > 1) {
+        Tensor<float, 3> C_contiguous = beta == 0.0f ? Tensor<float, 3>(C.shape(), uninitialized) : C.contiguous();
+        dot(A, B, C_contiguous, B_T, beta);
+        C.assign(C_contiguous);
+        return;
+    }
+    // a contiguous A is a single product with the samples stacked, anything else is done sample by sample
+    detail::gemm_batched(batch_size, m, n, k, as_operand(A, false), A.strides()[0], as_operand(B, B_T), 0, beta,
+                         C.raw_data_mutable(), std::max<size_type>(C.strides()[1], 1), C.strides()[0]);
+}
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, bool A_T, bool B_T) -> Tensor<float, 3>
+{
+    size_type m = A_T ? A.shape(2) : A.shape(1);
+    size_type n = B_T ? B.shape(1) : B.shape(2);
+
+    Tensor<float, 3> C({A.shape(0), m, n}, uninitialized);
+    dot(A, B, C, A_T, B_T);
+    return C;
+}
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, Tensor<float, 3> &C, bool A_T, bool B_T, float beta)
+    -> void
+{
+    // C(b, m, n) = A(b, m, k) * B(b, k, n) + beta * C(b, m, n)
+    size_type batch_size = A.shape(0);
+    size_type m = A_T ? A.shape(2) : A.shape(1);
+    size_type n = B_T ? B.shape(1) : B.shape(2);
+    size_type k = A_T ? A.shape(1) : A.shape(2);
+    assert(B.shape(0) == batch_size && C.shape(0) == batch_size && C.shape(1) == m && C.shape(2) == n);
+
+    if (C.strides()[2] != 1 && n > 1) {
+        Tensor<float, 3> C_contiguous = beta == 0.0f ? Tensor<float, 3>(C.shape(), uninitialized) : C.contiguous();
+        dot(A, B, C_contiguous, A_T, B_T, beta);
+        C.assign(C_contiguous);
+        return;
     }
-    return Tensor<float, 3>(partial);
+    detail::gemm_batched(batch_size, m, n, k, as_operand(A, A_T), A.strides()[0], as_operand(B, B_T), B.strides()[0],
+                         beta, C.raw_data_mutable(), std::max<size_type>(C.strides()[1], 1), C.strides()[0]);
 }
 
-} // namespace ts::naive
\ No newline at end of file
+} // namespace ts::naive
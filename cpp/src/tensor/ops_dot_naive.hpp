@@ -16,4 +16,15 @@ auto dot(MatrixF const &A, MatrixF const &B, MatrixF &C, bool A_T = false, bool
 
 auto dot(Tensor<float, 3> const &A, MatrixF const &B) -> Tensor<float, 3>;
 
+// C(b) = A(b) * B + beta * C(b) for every sample b, written into C
+auto dot(Tensor<float, 3> const &A, MatrixF const &B, Tensor<float, 3> &C, bool B_T = false, float beta = 0.0f)
+    -> void;
+
+// C(b) = A(b) * B(b), every sample is a separate product
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, bool A_T = false, bool B_T = false)
+    -> Tensor<float, 3>;
+
+auto dot(Tensor<float, 3> const &A, Tensor<float, 3> const &B, Tensor<float, 3> &C, bool A_T = false,
+         bool B_T = false, float beta = 0.0f) -> void;
+
 } // namespace ts::naive
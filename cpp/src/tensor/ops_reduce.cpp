@@ -0,0 +1,393 @@
+#include "ops_reduce.hpp"
+#include "half.hpp"
+#include "parallel.hpp"
+#include "tensor.hpp"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ts {
+
+namespace {
+
+// half precision is reduced in float, a bf16 accumulator stops growing at 256 when adding ones
+template <typename Element> using Accumulator = std::conditional_t<is_half_v<Element>, float, Element>;
+
+template <typename T> struct Add {
+    static auto identity() -> T { return T(0); }
+    static auto apply(T a, T b) -> T { return a + b; }
+};
+
+template <typename T> struct Max {
+    static auto identity() -> T
+    {
+        return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                    : std::numeric_limits<T>::lowest();
+    }
+    static auto apply(T a, T b) -> T { return a < b ? b : a; }
+};
+
+template <typename T> struct Min {
+    static auto identity() -> T
+    {
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                    : std::numeric_limits<T>::max();
+    }
+    static auto apply(T a, T b) -> T { return b < a ? b : a; }
+};
+
+// A contiguous tensor seen as [outer, n, inner] where n is the reduced axis, the result is [outer, inner]
+struct Layout {
+    size_type outer;
+    size_type n;
+    size_type inner;
+};
+
+struct Range {
+    size_type begin;
+    size_type end;
+};
+
+// contiguous runs are split in halves down to this size
+constexpr size_type PAIRWISE_BLOCK = 128;
+// independent accumulators of a run, they let the compiler vectorize the loop
+constexpr size_type LANES = 8;
+// rows added into a zeroed block of partial results before it is added to the result
+constexpr size_type ROW_BLOCK = 64;
+
+template <typename Op, typename Acc, typename Load>
+auto reduce_run(size_type begin, size_type end, Load const &load) -> Acc
+{
+    if (end - begin > PAIRWISE_BLOCK) {
+        size_type middle = begin + (end - begin) / 2 / LANES * LANES;
+        return Op::apply(reduce_run<Op, Acc>(begin, middle, load), reduce_run<Op, Acc>(middle, end, load));
+    }
+    std::array<Acc, LANES> lanes;
+    lanes.fill(Op::identity());
+    size_type i = begin;
+    for (; i + LANES <= end; i += LANES) {
+        for (size_type lane = 0; lane < LANES; ++lane) {
+            lanes[lane] = Op::apply(lanes[lane], load(i + lane));
+        }
+    }
+    for (; i < end; ++i) {
+        lanes[0] = Op::apply(lanes[0], load(i));
+    }
+    for (size_type width = LANES / 2; width > 0; width /= 2) {
+        for (size_type lane = 0; lane < width; ++lane) {
+            lanes[lane] = Op::apply(lanes[lane], lanes[lane + width]);
+        }
+    }
+    return lanes[0];
+}
+
+// Reduces the part of x given by the ranges into out, which is indexed like the whole result. map(value, index)
+// turns an element into what gets reduced, index is the position of its result.
+template <typename Op, typename Acc, typename Element, typename Map>
+auto reduce_block(Element const *x, Layout const &layout, Range outer, Range rows, Range columns, Acc *out,
+                  Map const &map) -> void
+{
+    size_type width = columns.end - columns.begin;
+    std::vector<Acc> partial(layout.inner == 1 ? 0 : width);
+    for (size_type o = outer.begin; o < outer.end; ++o) {
+        Element const *plane = x + o * layout.n * layout.inner;
+        if (layout.inner == 1) {
+            out[o] = reduce_run<Op, Acc>(rows.begin, rows.end, [&](size_type i) { return map(plane[i], o); });
+            continue;
+        }
+        Acc *result = out + o * layout.inner + columns.begin;
+        size_type index = o * layout.inner + columns.begin;
+        std::fill(result, result + width, Op::identity());
+        for (size_type block = rows.begin; block < rows.end; block += ROW_BLOCK) {
+            std::fill(partial.begin(), partial.end(), Op::identity());
+            for (size_type i = block; i < std::min(rows.end, block + ROW_BLOCK); ++i) {
+                Element const *row = plane + i * layout.inner + columns.begin;
+                for (size_type j = 0; j < width; ++j) {
+                    partial[j] = Op::apply(partial[j], map(row[j], index + j));
+                }
+            }
+            for (size_type j = 0; j < width; ++j) {
+                result[j] = Op::apply(result[j], partial[j]);
+            }
+        }
+    }
+}
+
+// Fills out[outer * inner], splitting the work between threads by outer slices, by columns or (when there are few
+// results) by parts of the reduced axis whose partial results are combined in chunk order
+template <typename Op, typename Acc, typename Element, typename Map>
+auto reduce(Element const *x, Layout const &layout, Acc *out, Map const &map) -> void
+{
+    Range all_outer{0, layout.outer};
+    Range all_rows{0, layout.n};
+    Range all_columns{0, layout.inner};
+    size_type outputs = layout.outer * layout.inner;
+    size_type chunks = detail::parallel_chunks(outputs * layout.n);
+
+    if (chunks <= 1) {
+        reduce_block<Op>(x, layout, all_outer, all_rows, all_columns, out, map);
+    } else if (layout.outer >= chunks) {
+        detail::run_chunks(layout.outer, chunks, 1, [&](size_type, size_type begin, size_type end) {
+            reduce_block<Op>(x, layout, Range{begin, end}, all_rows, all_columns, out, map);
+        });
+    } else if (layout.inner >= chunks * elements_per_cache_line<Acc>) {
+        detail::run_chunks(layout.inner, chunks, elements_per_cache_line<Acc>,
+                           [&](size_type, size_type begin, size_type end) {
+                               reduce_block<Op>(x, layout, all_outer, all_rows, Range{begin, end}, out, map);
+                           });
+    } else {
+        std::vector<Acc> partials(chunks * outputs, Op::identity());
+        detail::run_chunks(layout.n, chunks, 1, [&](size_type chunk, size_type begin, size_type end) {
+            reduce_block<Op>(x, layout, all_outer, Range{begin, end}, all_columns, partials.data() + chunk * outputs,
+                             map);
+        });
+        for (size_type i = 0; i < outputs; ++i) {
+            Acc result = partials[i];
+            for (size_type chunk = 1; chunk < chunks; ++chunk) {
+                result = Op::apply(result, partials[chunk * outputs + i]);
+            }
+            out[i] = result;
+        }
+    }
+}
+
+template <typename Element> auto widen(Element value, size_type) -> Accumulator<Element>
+{
+    return static_cast<Accumulator<Element>>(value);
+}
+
+template <typename Element> auto reduce_sum(Element const *x, Layout const &layout, Accumulator<Element> *out) -> void
+{
+    reduce<Add<Accumulator<Element>>>(x, layout, out, widen<Element>);
+}
+
+template <typename Element> auto reduce_mean(Element const *x, Layout const &layout, Accumulator<Element> *out) -> void
+{
+    reduce_sum(x, layout, out);
+    auto scale = Accumulator<Element>(1) / static_cast<Accumulator<Element>>(layout.n);
+    for (size_type i = 0; i < layout.outer * layout.inner; ++i) {
+        out[i] *= scale;
+    }
+}
+
+template <typename Element> auto reduce_max(Element const *x, Layout const &layout, Accumulator<Element> *out) -> void
+{
+    reduce<Max<Accumulator<Element>>>(x, layout, out, widen<Element>);
+}
+
+template <typename Element> auto reduce_min(Element const *x, Layout const &layout, Accumulator<Element> *out) -> void
+{
+    reduce<Min<Accumulator<Element>>>(x, layout, out, widen<Element>);
+}
+
+template <typename Element>
+auto reduce_logsumexp(Element const *x, Layout const &layout, Accumulator<Element> *out) -> void
+{
+    using Acc = Accumulator<Element>;
+    size_type outputs = layout.outer * layout.inner;
+    reduce_max(x, layout, out);
+    // exponents are shifted by the maximum so the biggest one is exp(0)
+    std::vector<Acc> shifts(out, out + outputs);
+    for (auto &shift : shifts) {
+        shift = std::isfinite(shift) ? shift : Acc(0);
+    }
+    reduce<Add<Acc>>(x, layout, out, [&](Element value, size_type i) { return std::exp(Acc(value) - shifts[i]); });
+    for (size_type i = 0; i < outputs; ++i) {
+        out[i] = shifts[i] + std::log(out[i]);
+    }
+}
+
+template <typename Element>
+auto reduce_variance(Element const *x, Layout const &layout, Accumulator<Element> *out) -> void
+{
+    using Acc = Accumulator<Element>;
+    size_type outputs = layout.outer * layout.inner;
+    // two passes, the textbook E[x^2] - E[x]^2 cancels catastrophically when the mean is big
+    reduce_mean(x, layout, out);
+    std::vector<Acc> means(out, out + outputs);
+    reduce<Add<Acc>>(x, layout, out, [&](Element value, size_type i) {
+        Acc centered = Acc(value) - means[i];
+        return centered * centered;
+    });
+    auto scale = Acc(1) / static_cast<Acc>(layout.n);
+    for (size_type i = 0; i < outputs; ++i) {
+        out[i] *= scale;
+    }
+}
+
+template <typename Element, int Dim, typename Function>
+auto reduce_all(Tensor<Element, Dim> const &tensor, Function fn) -> Element
+{
+    auto source = tensor.contiguous();
+    Accumulator<Element> result{};
+    fn(source.raw_data(), Layout{1, source.data_size(), 1}, &result);
+    return static_cast<Element>(result);
+}
+
+template <typename Element, int Dim, typename Function>
+auto reduce_axis(Tensor<Element, Dim> const &tensor, int axis, Function fn) -> Tensor<Element, Dim - 1>
+{
+    static_assert(Dim > 1, "reducing the only axis gives a scalar, use the reduction of the whole tensor");
+    axis = axis < 0 ? axis + Dim : axis;
+    assert(axis >= 0 && axis < Dim);
+
+    auto shape = tensor.shape();
+    Layout layout{1, shape[axis], 1};
+    std::array<size_type, Dim - 1> result_shape{};
+    for (int i = 0, j = 0; i < Dim; ++i) {
+        if (i < axis) {
+            layout.outer *= shape[i];
+        } else if (i > axis) {
+            layout.inner *= shape[i];
+        }
+        if (i != axis) {
+            result_shape[j++] = shape[i];
+        }
+    }
+
+    auto source = tensor.contiguous();
+    Tensor<Element, Dim - 1> result(result_shape, uninitialized);
+    if constexpr (std::is_same_v<Accumulator<Element>, Element>) {
+        fn(source.raw_data(), layout, result.raw_data_mutable());
+    } else {
+        std::vector<Accumulator<Element>> values(result.data_size());
+        fn(source.raw_data(), layout, values.data());
+        std::copy(values.begin(), values.end(), result.raw_data_mutable());
+    }
+    return result;
+}
+
+} // namespace
+
+template <typename Element, int Dim> auto sum(Tensor<Element, Dim> const &tensor) -> Element
+{
+    return reduce_all(tensor, reduce_sum<Element>);
+}
+
+template <typename Element, int Dim> auto mean(Tensor<Element, Dim> const &tensor) -> Element
+{
+    return reduce_all(tensor, reduce_mean<Element>);
+}
+
+template <typename Element, int Dim> auto max(Tensor<Element, Dim> const &tensor) -> Element
+{
+    return reduce_all(tensor, reduce_max<Element>);
+}
+
+template <typename Element, int Dim> auto min(Tensor<Element, Dim> const &tensor) -> Element
+{
+    return reduce_all(tensor, reduce_min<Element>);
+}
+
+template <typename Element, int Dim> auto logsumexp(Tensor<Element, Dim> const &tensor) -> Element
+{
+    return reduce_all(tensor, reduce_logsumexp<Element>);
+}
+
+template <typename Element, int Dim> auto variance(Tensor<Element, Dim> const &tensor) -> Element
+{
+    return reduce_all(tensor, reduce_variance<Element>);
+}
+
+template <typename Element, int Dim> auto sum(Tensor<Element, Dim> const &tensor, int axis) -> Tensor<Element, Dim - 1>
+{
+    return reduce_axis(tensor, axis, reduce_sum<Element>);
+}
+
+template <typename Element, int Dim>
+auto mean(Tensor<Element, Dim> const &tensor, int axis) -> Tensor<Element, Dim - 1>
+{
+    return reduce_axis(tensor, axis, reduce_mean<Element>);
+}
+
+template <typename Element, int Dim> auto max(Tensor<Element, Dim> const &tensor, int axis) -> Tensor<Element, Dim - 1>
+{
+    return reduce_axis(tensor, axis, reduce_max<Element>);
+}
+
+template <typename Element, int Dim> auto min(Tensor<Element, Dim> const &tensor, int axis) -> Tensor<Element, Dim - 1>
+{
+    return reduce_axis(tensor, axis, reduce_min<Element>);
+}
+
+template <typename Element, int Dim>
+auto logsumexp(Tensor<Element, Dim> const &tensor, int axis) -> Tensor<Element, Dim - 1>
+{
+    return reduce_axis(tensor, axis, reduce_logsumexp<Element>);
+}
+
+template <typename Element, int Dim>
+auto variance(Tensor<Element, Dim> const &tensor, int axis) -> Tensor<Element, Dim - 1>
+{
+    return reduce_axis(tensor, axis, reduce_variance<Element>);
+}
+
+template auto sum(Tensor<float, 1> const &) -> float;
+template auto sum(Tensor<float, 2> const &) -> float;
+template auto sum(Tensor<float, 3> const &) -> float;
+template auto sum(Tensor<float, 4> const &) -> float;
+template auto sum(Tensor<int, 1> const &) -> int;
+template auto sum(Tensor<int, 2> const &) -> int;
+template auto sum(Tensor<bf16, 1> const &) -> bf16;
+template auto sum(Tensor<bf16, 2> const &) -> bf16;
+template auto sum(Tensor<fp16, 1> const &) -> fp16;
+template auto sum(Tensor<fp16, 2> const &) -> fp16;
+
+template auto mean(Tensor<float, 1> const &) -> float;
+template auto mean(Tensor<float, 2> const &) -> float;
+template auto mean(Tensor<float, 3> const &) -> float;
+template auto mean(Tensor<float, 4> const &) -> float;
+
+template auto max(Tensor<float, 1> const &) -> float;
+template auto max(Tensor<float, 2> const &) -> float;
+template auto max(Tensor<float, 3> const &) -> float;
+template auto max(Tensor<float, 4> const &) -> float;
+template auto max(Tensor<int, 1> const &) -> int;
+template auto max(Tensor<int, 2> const &) -> int;
+
+template auto min(Tensor<float, 1> const &) -> float;
+template auto min(Tensor<float, 2> const &) -> float;
+template auto min(Tensor<float, 3> const &) -> float;
+template auto min(Tensor<float, 4> const &) -> float;
+template auto min(Tensor<int, 1> const &) -> int;
+template auto min(Tensor<int, 2> const &) -> int;
+
+template auto logsumexp(Tensor<float, 1> const &) -> float;
+template auto logsumexp(Tensor<float, 2> const &) -> float;
+
+template auto variance(Tensor<float, 1> const &) -> float;
+template auto variance(Tensor<float, 2> const &) -> float;
+template auto variance(Tensor<float, 3> const &) -> float;
+template auto variance(Tensor<float, 4> const &) -> float;
+
+template auto sum(Tensor<float, 2> const &, int) -> Tensor<float, 1>;
+template auto sum(Tensor<float, 3> const &, int) -> Tensor<float, 2>;
+template auto sum(Tensor<float, 4> const &, int) -> Tensor<float, 3>;
+template auto sum(Tensor<int, 2> const &, int) -> Tensor<int, 1>;
+template auto sum(Tensor<int, 3> const &, int) -> Tensor<int, 2>;
+
+template auto mean(Tensor<float, 2> const &, int) -> Tensor<float, 1>;
+template auto mean(Tensor<float, 3> const &, int) -> Tensor<float, 2>;
+template auto mean(Tensor<float, 4> const &, int) -> Tensor<float, 3>;
+
+template auto max(Tensor<float, 2> const &, int) -> Tensor<float, 1>;
+template auto max(Tensor<float, 3> const &, int) -> Tensor<float, 2>;
+template auto max(Tensor<float, 4> const &, int) -> Tensor<float, 3>;
+template auto max(Tensor<int, 2> const &, int) -> Tensor<int, 1>;
+
+template auto min(Tensor<float, 2> const &, int) -> Tensor<float, 1>;
+template auto min(Tensor<float, 3> const &, int) -> Tensor<float, 2>;
+template auto min(Tensor<float, 4> const &, int) -> Tensor<float, 3>;
+template auto min(Tensor<int, 2> const &, int) -> Tensor<int, 1>;
+
+template auto logsumexp(Tensor<float, 2> const &, int) -> Tensor<float, 1>;
+template auto logsumexp(Tensor<float, 3> const &, int) -> Tensor<float, 2>;
+
+template auto variance(Tensor<float, 2> const &, int) -> Tensor<float, 1>;
+template auto variance(Tensor<float, 3> const &, int) -> Tensor<float, 2>;
+template auto variance(Tensor<float, 4> const &, int) -> Tensor<float, 3>;
+
+} // namespace ts
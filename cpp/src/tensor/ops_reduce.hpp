@@ -0,0 +1,43 @@
+#pragma once
+
+#include "tensor_forward.hpp"
+
+// Reductions of whole tensors and along one axis of a tensor of any rank. The reduced axis is dropped from the shape
+// (like numpy without keepdims), negative axes count from the end.
+//
+// Memory is always read in order: rows of the reduced axis are added one by one into a row of partial results, so
+// reducing axis 0 of a matrix streams through it the same way reducing axis 1 does. Sums are accumulated pairwise
+// (along a contiguous run) or in blocks of rows, which keeps the rounding error way below the one of a running sum.
+// Big reductions are split between threads, partial results are combined in a fixed order.
+
+namespace ts {
+
+template <typename Element, int Dim> auto sum(Tensor<Element, Dim> const &) -> Element;
+
+template <typename Element, int Dim> auto mean(Tensor<Element, Dim> const &) -> Element;
+
+template <typename Element, int Dim> auto max(Tensor<Element, Dim> const &) -> Element;
+
+template <typename Element, int Dim> auto min(Tensor<Element, Dim> const &) -> Element;
+
+// log(sum(exp(x))) without overflowing
+template <typename Element, int Dim> auto logsumexp(Tensor<Element, Dim> const &) -> Element;
+
+// Population variance (divided by the number of elements)
+template <typename Element, int Dim> auto variance(Tensor<Element, Dim> const &) -> Element;
+
+template <typename Element, int Dim> auto sum(Tensor<Element, Dim> const &, int axis) -> Tensor<Element, Dim - 1>;
+
+template <typename Element, int Dim> auto mean(Tensor<Element, Dim> const &, int axis) -> Tensor<Element, Dim - 1>;
+
+template <typename Element, int Dim> auto max(Tensor<Element, Dim> const &, int axis) -> Tensor<Element, Dim - 1>;
+
+template <typename Element, int Dim> auto min(Tensor<Element, Dim> const &, int axis) -> Tensor<Element, Dim - 1>;
+
+template <typename Element, int Dim>
+auto logsumexp(Tensor<Element, Dim> const &, int axis) -> Tensor<Element, Dim - 1>;
+
+template <typename Element, int Dim>
+auto variance(Tensor<Element, Dim> const &, int axis) -> Tensor<Element, Dim - 1>;
+
+} // namespace ts
@@ -0,0 +1,242 @@
+#include "parallel.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <thread>
+
+namespace ts {
+
+namespace {
+
+struct Task {
+    std::function<void()> fn;
+    TaskGroup *group;
+    int limit;
+};
+
+// innermost ThreadLimit of the current thread, 0 means no limit
+thread_local int thread_limit = 0;
+
+auto default_num_threads() -> int
+{
+    if (char const *value = std::getenv("TENSOR_NUM_THREADS"); value != nullptr && std::atoi(value) > 0) {
+        return std::atoi(value);
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::atomic<int> threads{default_num_threads()};
+std::atomic<size_type> grain{size_type(1) << 15};
+
+} // namespace
+
+namespace detail {
+
+// Every worker owns a deque, it pushes and pops tasks at the back (the most recent ones have the hottest data) while
+// idle workers steal from the front of other deques. Tasks submitted from threads outside of the pool go to
+// a shared queue.
+class Scheduler {
+  public:
+    explicit Scheduler(int threads) : _queues(static_cast<size_type>(threads))
+    {
+        for (int i = 1; i < threads; ++i) {
+            _workers.emplace_back([this, i]() { work(static_cast<size_type>(i)); });
+        }
+    }
+
+    ~Scheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto &worker : _workers) {
+            worker.join();
+        }
+    }
+
+    auto size() const -> int { return static_cast<int>(_queues.size()); }
+
+    auto submit(Task *task) -> void
+    {
+        // queue 0 is the shared one, workers are numbered from 1
+        size_type index = current == this ? current_index : 0;
+        {
+            std::lock_guard<std::mutex> lock(_queues[index].mutex);
+            _queues[index].tasks.push_back(task);
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_queued;
+        }
+        _wake.notify_one();
+    }
+
+    // Runs one queued task if there is any
+    auto run_one() -> bool
+    {
+        Task *task = take();
+        if (task == nullptr) {
+            return false;
+        }
+        int previous_limit = thread_limit;
+        thread_limit = task->limit;
+        task->fn();
+        thread_limit = previous_limit;
+        task->group->finish_task();
+        delete task;
+        return true;
+    }
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task *> tasks;
+    };
+
+    auto take() -> Task *
+    {
+        size_type own = current == this ? current_index : 0;
+        if (Task *task = pop(own, true); task != nullptr) {
+            return task;
+        }
+        for (size_type i = 1; i <= _queues.size(); ++i) {
+            if (Task *task = pop((own + i) % _queues.size(), false); task != nullptr) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    auto pop(size_type index, bool back) -> Task *
+    {
+        Queue &queue = _queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return nullptr;
+        }
+        Task *task = back ? queue.tasks.back() : queue.tasks.front();
+        if (back) {
+            queue.tasks.pop_back();
+        } else {
+            queue.tasks.pop_front();
+        }
+        {
+            std::lock_guard<std::mutex> count_lock(_mutex);
+            --_queued;
+        }
+        return task;
+    }
+
+    auto work(size_type index) -> void
+    {
+        current = this;
+        current_index = index;
+        while (true) {
+            if (run_one()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this]() { return _stop || _queued > 0; });
+            if (_stop) {
+                return;
+            }
+        }
+    }
+
+    static thread_local Scheduler *current;
+    static thread_local size_type current_index;
+
+    std::vector<Queue> _queues;
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    size_type _queued = 0;
+    bool _stop = false;
+};
+
+thread_local Scheduler *Scheduler::current = nullptr;
+thread_local size_type Scheduler::current_index = 0;
+
+namespace {
+
+std::mutex scheduler_mutex;
+std::shared_ptr<Scheduler> scheduler;
+
+auto get_scheduler() -> std::shared_ptr<Scheduler>
+{
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    if (scheduler == nullptr || scheduler->size() != threads.load()) {
+        // running groups keep the old scheduler alive until they are done
+        scheduler = std::make_shared<Scheduler>(threads.load());
+    }
+    return scheduler;
+}
+
+} // namespace
+
+auto parallel_chunks(size_type size) -> size_type
+{
+    size_type chunks = std::min(static_cast<size_type>(max_threads()), size / grain_size());
+    return std::max(size_type(1), chunks);
+}
+
+} // namespace detail
+
+auto num_threads() -> int { return threads.load(); }
+
+auto set_num_threads(int value) -> void { threads.store(std::max(1, value)); }
+
+auto max_threads() -> int { return thread_limit > 0 ? std::min(thread_limit, num_threads()) : num_threads(); }
+
+auto grain_size() -> size_type { return grain.load(); }
+
+auto set_grain_size(size_type size) -> void { grain.store(std::max(size_type(1), size)); }
+
+ThreadLimit::ThreadLimit(int threads) : _previous(thread_limit)
+{
+    thread_limit = std::max(1, _previous > 0 ? std::min(_previous, threads) : threads);
+}
+
+ThreadLimit::~ThreadLimit() { thread_limit = _previous; }
+
+TaskGroup::TaskGroup() : _scheduler(detail::get_scheduler()) {}
+
+TaskGroup::~TaskGroup() { wait(); }
+
+auto TaskGroup::run(std::function<void()> task) -> void
+{
+    if (_scheduler->size() == 1) {
+        task();
+        return;
+    }
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    _scheduler->submit(new Task{std::move(task), this, max_threads()});
+}
+
+auto TaskGroup::wait() -> void
+{
+    while (_pending.load(std::memory_order_acquire) > 0) {
+        // help with whatever is queued instead of blocking, this is what makes nested parallel regions safe
+        if (_scheduler->run_one()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait_for(lock, std::chrono::microseconds(100),
+                       [this]() { return _pending.load(std::memory_order_acquire) == 0; });
+    }
+    // the last finish_task() may still hold the mutex, the group can't be destroyed before it lets it go
+    std::lock_guard<std::mutex> lock(_mutex);
+}
+
+auto TaskGroup::finish_task() -> void
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        _done.notify_all();
+    }
+}
+
+} // namespace ts
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tensor/tensor_forward.hpp"
+
+// Parallel runtime of the library: a work-stealing pool of num_threads() - 1 workers (the thread waiting for results
+// works too). Ops split big tensors with parallel_for/parallel_reduce, independent work (e.g. two models) can be run
+// concurrently with a TaskGroup. Nested parallel regions are fine, a thread waiting for its tasks runs other queued
+// tasks in the meantime.
+//
+// The thread count defaults to std::thread::hardware_concurrency() and can be set with TENSOR_NUM_THREADS or
+// set_num_threads(), a ThreadLimit narrows it down for a scope. Work below grain_size() elements stays on the calling
+// thread, so small tensors (e.g. in RNN steps) don't pay for synchronization.
+
+namespace ts {
+
+inline constexpr std::size_t CACHE_LINE = 64;
+
+template <typename Element>
+inline constexpr size_type elements_per_cache_line = CACHE_LINE > sizeof(Element) ? CACHE_LINE / sizeof(Element) : 1;
+
+auto num_threads() -> int;
+
+// Pass 1 to run everything serially
+auto set_num_threads(int threads) -> void;
+
+// Threads parallel ops started from this thread may use, num_threads() capped by the innermost ThreadLimit
+auto max_threads() -> int;
+
+// Minimal number of elements per thread
+auto grain_size() -> size_type;
+
+auto set_grain_size(size_type size) -> void;
+
+// Caps max_threads() of the current thread (and of the tasks it spawns) until the end of the scope, e.g. several
+// models sharing a process can each get a part of the cores instead of all of them fighting for every core
+class ThreadLimit {
+  public:
+    explicit ThreadLimit(int threads);
+
+    ~ThreadLimit();
+
+    ThreadLimit(ThreadLimit const &) = delete;
+
+    auto operator=(ThreadLimit const &) -> ThreadLimit & = delete;
+
+  private:
+    int _previous;
+};
+
+namespace detail {
+class Scheduler;
+}
+
+// Runs tasks concurrently on the pool, wait() returns after all of them are done
+class TaskGroup {
+  public:
+    TaskGroup();
+
+    // Waits for the remaining tasks
+    ~TaskGroup();
+
+    TaskGroup(TaskGroup const &) = delete;
+
+    auto operator=(TaskGroup const &) -> TaskGroup & = delete;
+
+    auto run(std::function<void()> task) -> void;
+
+    auto wait() -> void;
+
+  private:
+    friend class detail::Scheduler;
+
+    auto finish_task() -> void;
+
+    std::shared_ptr<detail::Scheduler> _scheduler;
+    std::atomic<size_type> _pending{0};
+    std::mutex _mutex;
+    std::condition_variable _done;
+};
+
+namespace detail {
+
+// Number of chunks worth running in parallel
+auto parallel_chunks(size_type size) -> size_type;
+
+// Calls fn(chunk, begin, end) for `chunks` parts of [0, size), chunk 0 on the calling thread
+template <typename Function>
+auto run_chunks(size_type size, size_type chunks, size_type alignment, Function const &fn) -> void
+{
+    size_type chunk = (size + chunks - 1) / chunks;
+    chunk = (chunk + alignment - 1) / alignment * alignment;
+    auto run = [&](size_type i) {
+        size_type begin = std::min(size, i * chunk);
+        size_type end = std::min(size, begin + chunk);
+        if (begin < end) {
+            fn(i, begin, end);
+        }
+    };
+    TaskGroup group;
+    for (size_type i = 1; i < chunks; ++i) {
+        group.run([&run, i]() { run(i); });
+    }
+    run(0);
+    group.wait();
+}
+
+} // namespace detail
+
+// Calls fn(begin, end) on disjoint chunks of [0, size). Chunks are static and their borders are multiples of
+// `alignment`, with alignment = elements_per_cache_line<Element> threads writing to an aligned buffer never share
+// a cache line.
+template <typename Function> auto parallel_for(size_type size, Function fn, size_type alignment = 1) -> void
+{
+    size_type chunks = detail::parallel_chunks(size);
+    if (chunks <= 1) {
+        if (size > 0) {
+            fn(size_type(0), size);
+        }
+        return;
+    }
+    detail::run_chunks(size, chunks, alignment, [&](size_type, size_type begin, size_type end) { fn(begin, end); });
+}
+
+// Calls fn(i) for every i in [0, count), for loops over coarse items (batch samples, channels) where every single
+// item is worth sending to another thread
+template <typename Function> auto parallel_for_each(size_type count, Function fn) -> void
+{
+    size_type chunks = std::min(count, static_cast<size_type>(max_threads()));
+    if (chunks <= 1) {
+        for (size_type i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+    detail::run_chunks(count, chunks, 1, [&](size_type, size_type begin, size_type end) {
+        for (size_type i = begin; i < end; ++i) {
+            fn(i);
+        }
+    });
+}
+
+// map(begin, end) reduces a chunk, partial results are combined in chunk order so for a given number of threads
+// the result is always the same
+template <typename T, typename Map, typename Combine>
+auto parallel_reduce(size_type size, T identity, Map map, Combine combine) -> T
+{
+    size_type chunks = detail::parallel_chunks(size);
+    if (chunks <= 1) {
+        return size > 0 ? combine(identity, map(size_type(0), size)) : identity;
+    }
+    std::vector<T> partials(chunks, identity);
+    detail::run_chunks(size, chunks, 1,
+                       [&](size_type chunk, size_type begin, size_type end) { partials[chunk] = map(begin, end); });
+    T result = identity;
+    for (auto const &partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+} // namespace ts
@@ -0,0 +1,179 @@
+#include "quantization.hpp"
+#include "parallel.hpp"
+#include "quantization_kernels.hpp"
+#include "simd.hpp"
+#include "tensor.hpp"
+
+#include <cmath>
+
+namespace ts {
+
+namespace {
+
+auto quantize_value(float value, float inverse_scale) -> std::int8_t
+{
+    float q = std::nearbyint(value * inverse_scale);
+    return static_cast<std::int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+}
+
+auto qgemm_scalar(detail::QGemm const &args, size_type row_begin, size_type row_end, size_type block_begin,
+                  size_type block_end) -> void
+{
+    using detail::QGEMM_BLOCK;
+    using detail::QGEMM_GROUP;
+    size_type const row_size = args.k_groups * QGEMM_GROUP;
+    for (size_type block = block_begin; block < block_end; ++block) {
+        std::int8_t const *w = args.w + block * args.k_groups * QGEMM_BLOCK * QGEMM_GROUP;
+        for (size_type row = row_begin; row < row_end; ++row) {
+            std::int8_t const *x = args.x + row * row_size;
+            for (size_type j = 0; j < QGEMM_BLOCK && block * QGEMM_BLOCK + j < args.n; ++j) {
+                std::int32_t acc = 0;
+                for (size_type group = 0; group < args.k_groups; ++group) {
+                    for (size_type i = 0; i < QGEMM_GROUP; ++i) {
+                        acc += x[group * QGEMM_GROUP + i] * w[(group * QGEMM_BLOCK + j) * QGEMM_GROUP + i];
+                    }
+                }
+                size_type column = block * QGEMM_BLOCK + j;
+                float y = static_cast<float>(acc) * args.scales[column] + args.bias[column];
+                args.out[row * args.ldo + column] = args.relu ? std::max(y, 0.0f) : y;
+            }
+        }
+    }
+}
+
+auto select_kernel() -> detail::QGemmKernel
+{
+#ifdef TENSOR_SIMD_X86
+    // follows the ISA picked for the float kernels, so TENSOR_FORCE_ISA works here too
+    simd::Isa isa = simd::kernels().isa;
+    if (isa == simd::Isa::AVX512 && __builtin_cpu_supports("avx512vnni")) {
+        return detail::qgemm_vnni;
+    }
+    if (isa == simd::Isa::AVX2 || isa == simd::Isa::AVX512) {
+        return detail::qgemm_avx2;
+    }
+#endif
+    return qgemm_scalar;
+}
+
+auto kernel() -> detail::QGemmKernel
+{
+    static detail::QGemmKernel const selected = select_kernel();
+    return selected;
+}
+
+} // namespace
+
+template <int Dim> auto RangeObserver::observe(Tensor<float, Dim> const &tensor) -> void
+{
+    auto values = tensor.contiguous();
+    for (float value : values) {
+        _max_abs = std::max(_max_abs, std::abs(value));
+    }
+}
+
+template auto RangeObserver::observe(Tensor<float, 2> const &) -> void;
+template auto RangeObserver::observe(Tensor<float, 4> const &) -> void;
+
+auto RangeObserver::max_abs() const -> float { return _max_abs; }
+
+auto RangeObserver::scale() const -> float { return _max_abs > 0.0f ? _max_abs / 127.0f : 1.0f; }
+
+auto quantize_weights(MatrixF const &weight) -> QuantizedMatrix
+{
+    using detail::QGEMM_BLOCK;
+    using detail::QGEMM_GROUP;
+    size_type k = weight.shape(0);
+    size_type n = weight.shape(1);
+    size_type k_groups = (k + QGEMM_GROUP - 1) / QGEMM_GROUP;
+    size_type blocks = (n + QGEMM_BLOCK - 1) / QGEMM_BLOCK;
+
+    QuantizedMatrix result;
+    result.rows = k;
+    result.columns = n;
+    result.data.assign(blocks * k_groups * QGEMM_BLOCK * QGEMM_GROUP, 0);
+    result.scales.assign(blocks * QGEMM_BLOCK, 0.0f);
+    result.column_sums.assign(blocks * QGEMM_BLOCK, 0);
+
+    for (size_type column = 0; column < n; ++column) {
+        float max_abs = 0.0f;
+        for (size_type row = 0; row < k; ++row) {
+            max_abs = std::max(max_abs, std::abs(weight(row, column)));
+        }
+        float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+        result.scales[column] = scale;
+
+        size_type block = column / QGEMM_BLOCK;
+        size_type j = column % QGEMM_BLOCK;
+        for (size_type row = 0; row < k; ++row) {
+            std::int8_t q = quantize_value(weight(row, column), 1.0f / scale);
+            size_type group = row / QGEMM_GROUP;
+            result.data[((block * k_groups + group) * QGEMM_BLOCK + j) * QGEMM_GROUP + row % QGEMM_GROUP] = q;
+            result.column_sums[column] += q;
+        }
+    }
+    return result;
+}
+
+auto quantized_dot(MatrixF const &x, float x_scale, QuantizedMatrix const &weight, std::optional<VectorF> const &bias,
+                   bool relu) -> MatrixF
+{
+    using detail::QGEMM_BLOCK;
+    using detail::QGEMM_GROUP;
+    size_type m = x.shape(0);
+    size_type k = x.shape(1);
+    assert(k == weight.rows);
+    size_type k_groups = (k + QGEMM_GROUP - 1) / QGEMM_GROUP;
+    size_type row_size = k_groups * QGEMM_GROUP;
+    size_type blocks = (weight.columns + QGEMM_BLOCK - 1) / QGEMM_BLOCK;
+
+    std::vector<std::int8_t, Allocator<std::int8_t>> x_quantized(m * row_size, 0);
+    auto x_strides = x.strides();
+    float const *x_data = x.raw_data();
+    float inverse_scale = 1.0f / x_scale;
+    for (size_type row = 0; row < m; ++row) {
+        for (size_type i = 0; i < k; ++i) {
+            float value = x_data[row * x_strides[0] + i * x_strides[1]];
+            x_quantized[row * row_size + i] = quantize_value(value, inverse_scale);
+        }
+    }
+
+    // dequantization scales of the products and the bias, padded like the weight columns
+    std::vector<float> scales(blocks * QGEMM_BLOCK, 0.0f);
+    std::vector<float> bias_values(blocks * QGEMM_BLOCK, 0.0f);
+    for (size_type column = 0; column < weight.columns; ++column) {
+        scales[column] = x_scale * weight.scales[column];
+        bias_values[column] = bias.has_value() ? bias.value()(column) : 0.0f;
+    }
+
+    MatrixF result({m, weight.columns}, uninitialized);
+    detail::QGemm args{};
+    args.x = x_quantized.data();
+    args.m = m;
+    args.k_groups = k_groups;
+    args.w = weight.data.data();
+    args.column_sums = weight.column_sums.data();
+    args.scales = scales.data();
+    args.bias = bias_values.data();
+    args.relu = relu;
+    args.out = result.raw_data_mutable();
+    args.n = weight.columns;
+    args.ldo = weight.columns;
+
+    // column blocks are independent and every thread reads only its part of the weights, small batches with few
+    // blocks are split by rows instead
+    auto run = kernel();
+    size_type chunks = detail::parallel_chunks(m * k * weight.columns);
+    if (chunks <= 1) {
+        run(args, 0, m, 0, blocks);
+    } else if (blocks >= chunks) {
+        detail::run_chunks(blocks, chunks, 1,
+                           [&](size_type, size_type begin, size_type end) { run(args, 0, m, begin, end); });
+    } else {
+        detail::run_chunks(m, std::min(chunks, m), 4,
+                           [&](size_type, size_type begin, size_type end) { run(args, begin, end, 0, blocks); });
+    }
+    return result;
+}
+
+} // namespace ts
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "tensor/tensor.hpp"
+
+// Symmetric int8 quantization for inference. Weights get a scale per output column, activations a single scale
+// taken from calibration batches. Products are accumulated in int32 by VNNI (AVX-512) or AVX2 kernels and turned
+// back into floats in the same pass, together with the bias and ReLU.
+
+namespace ts {
+
+// Keeps track of the range of values seen in calibration batches
+class RangeObserver {
+  public:
+    template <int Dim> auto observe(Tensor<float, Dim> const &tensor) -> void;
+
+    auto max_abs() const -> float;
+
+    // Maps [-max_abs(), max_abs()] onto [-127, 127]
+    auto scale() const -> float;
+
+  private:
+    float _max_abs = 0.0f;
+};
+
+// Weight matrix (k, n) in int8, packed for the GEMM kernels
+struct QuantizedMatrix {
+    size_type rows = 0;
+    size_type columns = 0;
+    std::vector<std::int8_t, Allocator<std::int8_t>> data;
+    // per column, padded to full blocks of columns
+    std::vector<float> scales;
+    std::vector<std::int32_t> column_sums;
+};
+
+auto quantize_weights(MatrixF const &weight) -> QuantizedMatrix;
+
+// max(x * weight + bias, 0) with relu, x is quantized with x_scale on the way in. Works with views of x.
+auto quantized_dot(MatrixF const &x, float x_scale, QuantizedMatrix const &weight,
+                   std::optional<VectorF> const &bias = std::nullopt, bool relu = false) -> MatrixF;
+
+} // namespace ts
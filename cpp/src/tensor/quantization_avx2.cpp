@@ -0,0 +1,82 @@
+#include "quantization_kernels.hpp"
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace ts::detail {
+
+namespace {
+
+// Epilogue of 8 columns of a row, the last block of a row may be partial
+auto store(QGemm const &args, __m256i acc, size_type row, size_type column) -> void
+{
+    if (column >= args.n) {
+        return;
+    }
+    __m256 y = _mm256_fmadd_ps(_mm256_cvtepi32_ps(acc), _mm256_loadu_ps(args.scales + column),
+                               _mm256_loadu_ps(args.bias + column));
+    if (args.relu) {
+        y = _mm256_max_ps(y, _mm256_setzero_ps());
+    }
+    float *out = args.out + row * args.ldo + column;
+    if (column + 8 <= args.n) {
+        _mm256_storeu_ps(out, y);
+    } else {
+        float buffer[8];
+        _mm256_storeu_ps(buffer, y);
+        std::memcpy(out, buffer, (args.n - column) * sizeof(float));
+    }
+}
+
+// There is no signed x signed byte multiply, vpmaddubsw takes unsigned * signed. |x| * (w * sign(x)) is the same
+// product and as x and w are in [-127, 127] the pairwise sums in int16 can't saturate.
+template <int ROWS> auto tile(QGemm const &args, size_type row, size_type block) -> void
+{
+    __m256i const ones = _mm256_set1_epi16(1);
+    size_type const row_size = args.k_groups * QGEMM_GROUP;
+    std::int8_t const *w = args.w + block * args.k_groups * QGEMM_BLOCK * QGEMM_GROUP;
+
+    __m256i acc[ROWS][2];
+    for (int r = 0; r < ROWS; ++r) {
+        acc[r][0] = _mm256_setzero_si256();
+        acc[r][1] = _mm256_setzero_si256();
+    }
+    for (size_type group = 0; group < args.k_groups; ++group) {
+        auto const *w_group = reinterpret_cast<__m256i const *>(w + group * QGEMM_BLOCK * QGEMM_GROUP);
+        __m256i w_low = _mm256_loadu_si256(w_group);
+        __m256i w_high = _mm256_loadu_si256(w_group + 1);
+        for (int r = 0; r < ROWS; ++r) {
+            std::int32_t values;
+            std::memcpy(&values, args.x + (row + r) * row_size + group * QGEMM_GROUP, sizeof(values));
+            __m256i x = _mm256_set1_epi32(values);
+            __m256i x_abs = _mm256_abs_epi8(x);
+            __m256i low = _mm256_maddubs_epi16(x_abs, _mm256_sign_epi8(w_low, x));
+            __m256i high = _mm256_maddubs_epi16(x_abs, _mm256_sign_epi8(w_high, x));
+            acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_madd_epi16(low, ones));
+            acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_madd_epi16(high, ones));
+        }
+    }
+    for (int r = 0; r < ROWS; ++r) {
+        store(args, acc[r][0], row + r, block * QGEMM_BLOCK);
+        store(args, acc[r][1], row + r, block * QGEMM_BLOCK + 8);
+    }
+}
+
+} // namespace
+
+auto qgemm_avx2(QGemm const &args, size_type row_begin, size_type row_end, size_type block_begin, size_type block_end)
+    -> void
+{
+    // a block of weights stays in cache while it's multiplied with all the rows, four rows share every load
+    for (size_type block = block_begin; block < block_end; ++block) {
+        size_type row = row_begin;
+        for (; row + 4 <= row_end; row += 4) {
+            tile<4>(args, row, block);
+        }
+        for (; row < row_end; ++row) {
+            tile<1>(args, row, block);
+        }
+    }
+}
+
+} // namespace ts::detail
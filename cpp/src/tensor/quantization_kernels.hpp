@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "tensor/tensor_forward.hpp"
+
+// int8 GEMM kernels behind quantized_dot(). Every ISA has its own translation unit built with its own flags.
+//
+// Weights are packed in blocks of QGEMM_BLOCK columns, inside a block every column holds QGEMM_GROUP consecutive
+// values of k next to each other: w[((block * k_groups + group) * QGEMM_BLOCK + column) * QGEMM_GROUP + i] is
+// w(group * QGEMM_GROUP + i, block * QGEMM_BLOCK + column). One group of a block is a single AVX-512 register
+// (two AVX2 ones) and maps directly onto vpdpbusd.
+
+namespace ts::detail {
+
+inline constexpr size_type QGEMM_BLOCK = 16;
+inline constexpr size_type QGEMM_GROUP = 4;
+
+struct QGemm {
+    // m rows of k_groups * QGEMM_GROUP values, zero padded
+    std::int8_t const *x;
+    size_type m;
+    size_type k_groups;
+    // packed weights with sums of their columns
+    std::int8_t const *w;
+    std::int32_t const *column_sums;
+    // epilogue: out = acc * scales + bias, max(out, 0) if relu. Both arrays are padded to full blocks
+    float const *scales;
+    float const *bias;
+    bool relu;
+    // m x n row-major output
+    float *out;
+    size_type n;
+    size_type ldo;
+};
+
+// Computes rows [row_begin, row_end) of the column blocks [block_begin, block_end)
+using QGemmKernel = void (*)(QGemm const &, size_type row_begin, size_type row_end, size_type block_begin,
+                             size_type block_end);
+
+auto qgemm_avx2(QGemm const &, size_type row_begin, size_type row_end, size_type block_begin, size_type block_end)
+    -> void;
+
+auto qgemm_vnni(QGemm const &, size_type row_begin, size_type row_end, size_type block_begin, size_type block_end)
+    -> void;
+
+} // namespace ts::detail
@@ -0,0 +1,62 @@
+#include "quantization_kernels.hpp"
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace ts::detail {
+
+namespace {
+
+// vpdpbusd multiplies unsigned by signed bytes, x goes in shifted by 128 (a flip of the sign bit) and
+// 128 * sum(w) is subtracted in the epilogue
+template <int ROWS> auto tile(QGemm const &args, size_type row, size_type block) -> void
+{
+    size_type const row_size = args.k_groups * QGEMM_GROUP;
+    std::int8_t const *w = args.w + block * args.k_groups * QGEMM_BLOCK * QGEMM_GROUP;
+
+    __m512i acc[ROWS];
+    for (int r = 0; r < ROWS; ++r) {
+        acc[r] = _mm512_setzero_si512();
+    }
+    for (size_type group = 0; group < args.k_groups; ++group) {
+        __m512i w_group = _mm512_loadu_si512(w + group * QGEMM_BLOCK * QGEMM_GROUP);
+        for (int r = 0; r < ROWS; ++r) {
+            std::int32_t values;
+            std::memcpy(&values, args.x + (row + r) * row_size + group * QGEMM_GROUP, sizeof(values));
+            __m512i x = _mm512_set1_epi32(values ^ static_cast<std::int32_t>(0x80808080u));
+            acc[r] = _mm512_dpbusd_epi32(acc[r], x, w_group);
+        }
+    }
+
+    size_type column = block * QGEMM_BLOCK;
+    size_type valid = args.n - column < QGEMM_BLOCK ? args.n - column : QGEMM_BLOCK;
+    __mmask16 mask = static_cast<__mmask16>((1u << valid) - 1u);
+    __m512i correction = _mm512_slli_epi32(_mm512_loadu_si512(args.column_sums + column), 7);
+    __m512 scales = _mm512_loadu_ps(args.scales + column);
+    __m512 bias = _mm512_loadu_ps(args.bias + column);
+    for (int r = 0; r < ROWS; ++r) {
+        __m512 y = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_sub_epi32(acc[r], correction)), scales, bias);
+        if (args.relu) {
+            y = _mm512_max_ps(y, _mm512_setzero_ps());
+        }
+        _mm512_mask_storeu_ps(args.out + (row + r) * args.ldo + column, mask, y);
+    }
+}
+
+} // namespace
+
+auto qgemm_vnni(QGemm const &args, size_type row_begin, size_type row_end, size_type block_begin, size_type block_end)
+    -> void
+{
+    for (size_type block = block_begin; block < block_end; ++block) {
+        size_type row = row_begin;
+        for (; row + 4 <= row_end; row += 4) {
+            tile<4>(args, row, block);
+        }
+        for (; row < row_end; ++row) {
+            tile<1>(args, row, block);
+        }
+    }
+}
+
+} // namespace ts::detail
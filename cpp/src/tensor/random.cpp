@@ -0,0 +1,185 @@
+#include "random.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include "tensor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace ts {
+
+namespace {
+
+// values of one call of the philox kernel per counter group, draws always take whole groups
+constexpr size_type GROUP = 4 * simd::PHILOX_LANES;
+// groups generated at once, 4 KiB of bits on the stack
+constexpr size_type BATCH = 16;
+
+// 24 random bits scaled to [0, 1), every value is exactly representable
+constexpr float UNIT = 1.0f / 16777216.0f;
+constexpr float TWO_PI = 6.28318530717958647692f;
+
+auto default_seed() -> std::uint64_t
+{
+    char const *value = std::getenv("TENSOR_SEED");
+    if (value == nullptr || *value == '\0') {
+        return Generator::DEFAULT_SEED;
+    }
+    char *end = nullptr;
+    std::uint64_t seed = std::strtoull(value, &end, 0);
+    if (*end != '\0') {
+        std::cerr << "TENSOR_SEED: '" << value << "' is not a number, using " << Generator::DEFAULT_SEED << std::endl;
+        return Generator::DEFAULT_SEED;
+    }
+    return seed;
+}
+
+// Calls convert(bits, i, count) for consecutive runs of values [i, i + count), bits holds whole groups of them.
+// Chunk borders are multiples of a group so value i comes from the same counter at any thread count.
+template <typename Convert> auto generate(Generator &generator, size_type n, Convert const &convert) -> void
+{
+    std::uint64_t first = generator.advance(n);
+    std::uint64_t key = generator.seed();
+    std::uint64_t stream = generator.stream();
+    auto const &kernels = simd::kernels();
+    parallel_for(
+        n,
+        [&](size_type begin, size_type end) {
+            std::uint32_t bits[BATCH * GROUP];
+            for (size_type i = begin; i < end; i += BATCH * GROUP) {
+                size_type count = std::min(end - i, BATCH * GROUP);
+                size_type groups = (count + GROUP - 1) / GROUP;
+                kernels.philox(key, stream, first + i / GROUP * simd::PHILOX_LANES, bits, groups);
+                convert(bits, i, count);
+            }
+        },
+        GROUP);
+}
+
+template <typename Element, int Dim, typename Convert>
+auto fill(Tensor<Element, Dim> &tensor, Generator &generator, Convert const &convert) -> void
+{
+    if (!tensor.is_contiguous()) {
+        Tensor<Element, Dim> values(tensor.shape(), uninitialized);
+        fill(values, generator, convert);
+        tensor.assign(values);
+        return;
+    }
+    Element *out = tensor.raw_data_mutable();
+    generate(generator, tensor.data_size(), [&](std::uint32_t const *bits, size_type i, size_type count) {
+        convert(bits, out + i, count);
+    });
+}
+
+} // namespace
+
+Generator::Generator(std::uint64_t seed, std::uint64_t stream) : _seed(seed), _stream(stream) {}
+
+Generator::Generator(Generator const &other) : _seed(other._seed), _stream(other._stream), _offset(other.offset()) {}
+
+auto Generator::operator=(Generator const &other) -> Generator &
+{
+    _seed = other._seed;
+    _stream = other._stream;
+    _offset.store(other.offset(), std::memory_order_relaxed);
+    return *this;
+}
+
+auto Generator::manual_seed(std::uint64_t seed) -> void
+{
+    _seed = seed;
+    _offset.store(0, std::memory_order_relaxed);
+}
+
+auto Generator::set_offset(std::uint64_t offset) -> void { _offset.store(offset, std::memory_order_relaxed); }
+
+auto Generator::advance(size_type count) -> std::uint64_t
+{
+    std::uint64_t counters = (count + GROUP - 1) / GROUP * simd::PHILOX_LANES;
+    return _offset.fetch_add(counters, std::memory_order_relaxed);
+}
+
+auto default_generator() -> Generator &
+{
+    static Generator generator(default_seed());
+    return generator;
+}
+
+auto manual_seed(std::uint64_t seed) -> void { default_generator().manual_seed(seed); }
+
+template <typename Element, int Dim>
+auto uniform_(Tensor<Element, Dim> &tensor, Element low, Element high, Generator &generator) -> void
+{
+    float scale = static_cast<float>(high - low) * UNIT;
+    fill(tensor, generator, [&](std::uint32_t const *bits, Element *out, size_type count) {
+        for (size_type i = 0; i < count; ++i) {
+            out[i] = static_cast<Element>(low + static_cast<float>(bits[i] >> 8) * scale);
+        }
+    });
+}
+
+// Box-Muller, values j and j + GROUP / 2 of a group are the two outputs of one pair of uniforms
+template <typename Element, int Dim>
+auto normal_(Tensor<Element, Dim> &tensor, Element mean, Element std, Generator &generator) -> void
+{
+    fill(tensor, generator, [&](std::uint32_t const *bits, Element *out, size_type count) {
+        for (size_type g = 0; g < count; g += GROUP) {
+            size_type size = std::min(count - g, GROUP);
+            for (size_type j = 0; j < GROUP / 2 && j < size; ++j) {
+                // (0, 1], log stays finite
+                float u1 = static_cast<float>((bits[g + j] >> 8) + 1) * UNIT;
+                float u2 = static_cast<float>(bits[g + j + GROUP / 2] >> 8) * UNIT;
+                float radius = std::sqrt(-2.0f * std::log(u1));
+                float theta = TWO_PI * u2;
+                out[g + j] = static_cast<Element>(mean + std * radius * std::cos(theta));
+                if (j + GROUP / 2 < size) {
+                    out[g + j + GROUP / 2] = static_cast<Element>(mean + std * radius * std::sin(theta));
+                }
+            }
+        }
+    });
+}
+
+template <typename Element, int Dim>
+auto bernoulli_(Tensor<Element, Dim> &tensor, float p, Generator &generator) -> void
+{
+    fill(tensor, generator, [&](std::uint32_t const *bits, Element *out, size_type count) {
+        for (size_type i = 0; i < count; ++i) {
+            out[i] = static_cast<float>(bits[i] >> 8) * UNIT < p ? Element(1) : Element(0);
+        }
+    });
+}
+
+template <int Dim> auto randint_(Tensor<int, Dim> &tensor, int low, int high, Generator &generator) -> void
+{
+    // multiply-shift instead of a modulo, the bias is below 2^-32 * range
+    std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(high) - low + 1);
+    fill(tensor, generator, [&](std::uint32_t const *bits, int *out, size_type count) {
+        for (size_type i = 0; i < count; ++i) {
+            out[i] = static_cast<int>(low + static_cast<std::int64_t>((bits[i] * range) >> 32));
+        }
+    });
+}
+
+template auto uniform_(Tensor<float, 1> &, float, float, Generator &) -> void;
+template auto uniform_(Tensor<float, 2> &, float, float, Generator &) -> void;
+template auto uniform_(Tensor<float, 3> &, float, float, Generator &) -> void;
+template auto uniform_(Tensor<float, 4> &, float, float, Generator &) -> void;
+
+template auto normal_(Tensor<float, 1> &, float, float, Generator &) -> void;
+template auto normal_(Tensor<float, 2> &, float, float, Generator &) -> void;
+template auto normal_(Tensor<float, 3> &, float, float, Generator &) -> void;
+template auto normal_(Tensor<float, 4> &, float, float, Generator &) -> void;
+
+template auto bernoulli_(Tensor<float, 1> &, float, Generator &) -> void;
+template auto bernoulli_(Tensor<float, 2> &, float, Generator &) -> void;
+template auto bernoulli_(Tensor<float, 3> &, float, Generator &) -> void;
+template auto bernoulli_(Tensor<float, 4> &, float, Generator &) -> void;
+
+template auto randint_(Tensor<int, 1> &, int, int, Generator &) -> void;
+template auto randint_(Tensor<int, 2> &, int, int, Generator &) -> void;
+template auto randint_(Tensor<int, 3> &, int, int, Generator &) -> void;
+
+} // namespace ts
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "tensor/tensor_forward.hpp"
+
+// Counter-based random numbers (Philox4x32-10). Value i of a draw is a pure function of (seed, stream, counter of
+// the draw + i), so tensors are filled in parallel and with SIMD and the result is bit-identical at any thread count
+// and on any ISA. A Generator only keeps a counter: every draw reserves whole groups of 64 values and moves it on,
+// the next draw gets fresh numbers.
+//
+// Generators with the same seed and different streams are independent, e.g. one per data loader worker. Everything
+// without an explicit generator uses default_generator(), seeded with TENSOR_SEED (69 by default).
+
+namespace ts {
+
+class Generator {
+  public:
+    static constexpr std::uint64_t DEFAULT_SEED = 69;
+
+    explicit Generator(std::uint64_t seed = DEFAULT_SEED, std::uint64_t stream = 0);
+
+    Generator(Generator const &other);
+
+    auto operator=(Generator const &other) -> Generator &;
+
+    [[nodiscard]] auto seed() const -> std::uint64_t { return _seed; }
+
+    [[nodiscard]] auto stream() const -> std::uint64_t { return _stream; }
+
+    // Counter of the next draw
+    [[nodiscard]] auto offset() const -> std::uint64_t { return _offset.load(std::memory_order_relaxed); }
+
+    // Starts over with a new seed, the stream stays
+    auto manual_seed(std::uint64_t seed) -> void;
+
+    auto set_offset(std::uint64_t offset) -> void;
+
+    // Reserves counters for `count` values and returns the first one, safe to call from many threads
+    auto advance(size_type count) -> std::uint64_t;
+
+  private:
+    std::uint64_t _seed;
+    std::uint64_t _stream;
+    std::atomic<std::uint64_t> _offset{0};
+};
+
+auto default_generator() -> Generator &;
+
+// Reseeds the default generator
+auto manual_seed(std::uint64_t seed) -> void;
+
+// In-place fills, views are fine. Values don't depend on the strides, only on the order of elements.
+
+// Uniform in [low, high)
+template <typename Element, int Dim>
+auto uniform_(Tensor<Element, Dim> &tensor, Element low, Element high, Generator &generator = default_generator())
+    -> void;
+
+template <typename Element, int Dim>
+auto normal_(Tensor<Element, Dim> &tensor, Element mean, Element std, Generator &generator = default_generator())
+    -> void;
+
+// 1 with probability p, 0 otherwise
+template <typename Element, int Dim>
+auto bernoulli_(Tensor<Element, Dim> &tensor, float p, Generator &generator = default_generator()) -> void;
+
+// Uniform integers in [low, high], both ends included
+template <int Dim>
+auto randint_(Tensor<int, Dim> &tensor, int low, int high, Generator &generator = default_generator()) -> void;
+
+} // namespace ts
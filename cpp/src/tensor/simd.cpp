@@ -0,0 +1,296 @@
+#include "simd.hpp"
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace ts::simd {
+
+namespace {
+
+void add(float const *x, float const *y, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i] + y[i];
+    }
+}
+
+void multiply(float const *x, float const *y, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i] * y[i];
+    }
+}
+
+void add_scalar(float const *x, float value, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i] + value;
+    }
+}
+
+void multiply_scalar(float const *x, float value, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i] * value;
+    }
+}
+
+void maximum(float value, float const *x, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i] < value ? value : x[i];
+    }
+}
+
+void exp(float const *x, float epsilon, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = std::exp(x[i]) + epsilon;
+    }
+}
+
+void log(float const *x, float epsilon, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = std::log(x[i] + epsilon);
+    }
+}
+
+void pow(float const *x, float value, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = std::pow(x[i], value);
+    }
+}
+
+void clip(float const *x, float min, float max, float *out, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = x[i] < min ? min : (x[i] > max ? max : x[i]);
+    }
+}
+
+void fill(float *out, float value, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = value;
+    }
+}
+
+void axpy(float alpha, float const *x, float *y, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        y[i] += alpha * x[i];
+    }
+}
+
+template <typename Op>
+void map_broadcast(float const *x, size_type x_step, float const *y, size_type y_step, float *out, size_type n, Op op)
+{
+    for (size_type i = 0; i < n; ++i) {
+        out[i] = op(x[i * x_step], y[i * y_step]);
+    }
+}
+
+void binary(Binary op, float const *x, size_type x_step, float const *y, size_type y_step, float *out, size_type n)
+{
+    switch (op) {
+    case Binary::ADD:
+        map_broadcast(x, x_step, y, y_step, out, n, [](float a, float b) { return a + b; });
+        break;
+    case Binary::SUBTRACT:
+        map_broadcast(x, x_step, y, y_step, out, n, [](float a, float b) { return a - b; });
+        break;
+    case Binary::MULTIPLY:
+        map_broadcast(x, x_step, y, y_step, out, n, [](float a, float b) { return a * b; });
+        break;
+    case Binary::DIVIDE:
+        map_broadcast(x, x_step, y, y_step, out, n, [](float a, float b) { return a / b; });
+        break;
+    case Binary::MAXIMUM:
+        map_broadcast(x, x_step, y, y_step, out, n, [](float a, float b) { return a > b ? a : b; });
+        break;
+    case Binary::MINIMUM:
+        map_broadcast(x, x_step, y, y_step, out, n, [](float a, float b) { return a < b ? a : b; });
+        break;
+    }
+}
+
+constexpr size_type GEMM_ROWS = 4;
+constexpr size_type GEMM_COLUMNS = 4;
+
+void gemm(size_type k, float const *a, float const *b, float *c, size_type ldc, bool accumulate)
+{
+    float acc[GEMM_ROWS][GEMM_COLUMNS] = {};
+    for (size_type p = 0; p < k; ++p, a += GEMM_ROWS, b += GEMM_COLUMNS) {
+        for (size_type r = 0; r < GEMM_ROWS; ++r) {
+            for (size_type j = 0; j < GEMM_COLUMNS; ++j) {
+                acc[r][j] += a[r] * b[j];
+            }
+        }
+    }
+    for (size_type r = 0; r < GEMM_ROWS; ++r) {
+        for (size_type j = 0; j < GEMM_COLUMNS; ++j) {
+            c[r * ldc + j] = accumulate ? c[r * ldc + j] + acc[r][j] : acc[r][j];
+        }
+    }
+}
+
+void philox(std::uint64_t key, std::uint64_t stream, std::uint64_t first, std::uint32_t *out, size_type groups)
+{
+    using namespace detail;
+    for (size_type g = 0; g < groups; ++g) {
+        for (size_type lane = 0; lane < PHILOX_LANES; ++lane) {
+            std::uint64_t counter = first + g * PHILOX_LANES + lane;
+            std::uint32_t c[4] = {static_cast<std::uint32_t>(counter), static_cast<std::uint32_t>(counter >> 32),
+                                  static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)};
+            auto k0 = static_cast<std::uint32_t>(key);
+            auto k1 = static_cast<std::uint32_t>(key >> 32);
+            for (int round = 0; round < PHILOX_ROUNDS; ++round, k0 += PHILOX_W0, k1 += PHILOX_W1) {
+                std::uint64_t product0 = static_cast<std::uint64_t>(PHILOX_M0) * c[0];
+                std::uint64_t product1 = static_cast<std::uint64_t>(PHILOX_M1) * c[2];
+                c[0] = static_cast<std::uint32_t>(product1 >> 32) ^ c[1] ^ k0;
+                c[1] = static_cast<std::uint32_t>(product1);
+                c[2] = static_cast<std::uint32_t>(product0 >> 32) ^ c[3] ^ k1;
+                c[3] = static_cast<std::uint32_t>(product0);
+            }
+            for (size_type w = 0; w < 4; ++w) {
+                out[(4 * g + w) * PHILOX_LANES + lane] = c[w];
+            }
+        }
+    }
+}
+
+void update(Update update, UpdateParameters const &p, float *w, float *g, float *m, float *v, size_type n)
+{
+    for (size_type i = 0; i < n; ++i) {
+        float grad = std::min(std::max(g[i], -p.clip), p.clip);
+        g[i] = grad;
+        switch (update) {
+        case Update::SGD:
+            w[i] -= p.lr * grad;
+            break;
+        case Update::MOMENTUM:
+            m[i] = p.beta1 * m[i] + p.lr * grad;
+            w[i] -= m[i];
+            break;
+        case Update::ADAGRAD:
+            m[i] += grad * grad;
+            w[i] -= p.lr * grad / std::sqrt(m[i] + p.epsilon);
+            break;
+        case Update::RMSPROP:
+            m[i] = p.beta1 * m[i] + (1.0f - p.beta1) * (grad * grad);
+            w[i] -= p.lr * grad / (std::sqrt(m[i]) + p.epsilon);
+            break;
+        case Update::ADAM:
+            m[i] = p.beta1 * m[i] + (1.0f - p.beta1) * grad;
+            v[i] = p.beta2 * v[i] + (1.0f - p.beta2) * (grad * grad);
+            w[i] -= p.lr * m[i] / (std::sqrt(v[i]) / p.correction + p.epsilon);
+            break;
+        }
+    }
+}
+
+auto scalar_kernels() -> Kernels const &
+{
+    static Kernels const kernels{Isa::SCALAR, add,       multiply,     add_scalar, multiply_scalar, maximum,
+                                 exp,         log,       pow,          clip,       fill,            axpy,
+                                 binary,      GEMM_ROWS, GEMM_COLUMNS, gemm,       nullptr,         nullptr,
+                                 philox,      update};
+    return kernels;
+}
+
+auto best_supported() -> Isa
+{
+    for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::SSE42}) {
+        if (is_supported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::SCALAR;
+}
+
+auto select_isa() -> Isa
+{
+    char const *forced = std::getenv("TENSOR_FORCE_ISA");
+    if (forced == nullptr || *forced == '\0') {
+        return best_supported();
+    }
+    for (Isa isa : {Isa::SCALAR, Isa::SSE42, Isa::AVX2, Isa::AVX512}) {
+        if (std::strcmp(forced, isa_name(isa)) == 0) {
+            if (is_supported(isa)) {
+                return isa;
+            }
+            std::cerr << "TENSOR_FORCE_ISA: " << forced << " is not supported on this machine, using "
+                      << isa_name(best_supported()) << std::endl;
+            return best_supported();
+        }
+    }
+    std::cerr << "TENSOR_FORCE_ISA: unknown ISA '" << forced << "', expected one of scalar, sse4.2, avx2, avx512"
+              << std::endl;
+    return best_supported();
+}
+
+} // namespace
+
+auto is_supported(Isa isa) -> bool
+{
+    switch (isa) {
+    case Isa::SCALAR:
+        return true;
+#ifdef TENSOR_SIMD_X86
+    case Isa::SSE42:
+        return __builtin_cpu_supports("sse4.2");
+    case Isa::AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+    case Isa::AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+auto isa_name(Isa isa) -> char const *
+{
+    switch (isa) {
+    case Isa::SSE42:
+        return "sse4.2";
+    case Isa::AVX2:
+        return "avx2";
+    case Isa::AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+auto kernels(Isa isa) -> Kernels const &
+{
+    assert(is_supported(isa));
+    switch (isa) {
+#ifdef TENSOR_SIMD_X86
+    case Isa::SSE42:
+        return sse42_kernels();
+    case Isa::AVX2:
+        return avx2_kernels();
+    case Isa::AVX512:
+        return avx512_kernels();
+#endif
+    default:
+        return scalar_kernels();
+    }
+}
+
+auto kernels() -> Kernels const &
+{
+    static Kernels const &selected = kernels(select_isa());
+    return selected;
+}
+
+} // namespace ts::simd
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+#include "tensor/tensor_forward.hpp"
+
+// Elementwise float kernels and the GEMM micro-kernel, with hand-vectorized SSE4.2, AVX2 and AVX-512 versions. The best
+// version supported by the CPU is picked once, at the first call to simd::kernels(), so the same binary runs on every
+// x86-64 machine.
+// The choice can be pinned with TENSOR_FORCE_ISA=scalar|sse4.2|avx2|avx512 (handy for A/B tests).
+//
+// All kernels work on plain contiguous buffers, `out` may be the same as one of the inputs.
+
+namespace ts::simd {
+
+enum class Isa { SCALAR, SSE42, AVX2, AVX512 };
+
+enum class Binary { ADD, SUBTRACT, MULTIPLY, DIVIDE, MAXIMUM, MINIMUM };
+
+// Optimizer steps, with the state each of them keeps in m and v:
+//   SGD       w -= lr * g
+//   MOMENTUM  m = beta1 * m + lr * g, w -= m
+//   ADAGRAD   m += g^2, w -= lr * g / sqrt(m + epsilon)
+//   RMSPROP   m = beta1 * m + (1 - beta1) * g^2, w -= lr * g / (sqrt(m) + epsilon)
+//   ADAM      m = beta1 * m + (1 - beta1) * g, v = beta2 * v + (1 - beta2) * g^2,
+//             w -= lr * m / (sqrt(v) / correction + epsilon)
+enum class Update { SGD, MOMENTUM, ADAGRAD, RMSPROP, ADAM };
+
+struct UpdateParameters {
+    float lr;
+    float beta1 = 0.0f;
+    float beta2 = 0.0f;
+    float epsilon = 0.0f;
+    // square root of the bias correction of v in Adam
+    float correction = 1.0f;
+    // gradients are clipped to [-clip, clip] first
+    float clip = 5.0f;
+};
+
+// Counters the philox kernel runs side by side, its output comes in groups of 4 * PHILOX_LANES values
+inline constexpr size_type PHILOX_LANES = 16;
+
+struct Kernels {
+    Isa isa;
+
+    // out = x + y
+    void (*add)(float const *x, float const *y, float *out, size_type n);
+    // out = x * y
+    void (*multiply)(float const *x, float const *y, float *out, size_type n);
+    // out = x + value
+    void (*add_scalar)(float const *x, float value, float *out, size_type n);
+    // out = x * value
+    void (*multiply_scalar)(float const *x, float value, float *out, size_type n);
+    // out = x < value ? value : x
+    void (*maximum)(float value, float const *x, float *out, size_type n);
+    // out = exp(x) + epsilon
+    void (*exp)(float const *x, float epsilon, float *out, size_type n);
+    // out = log(x + epsilon)
+    void (*log)(float const *x, float epsilon, float *out, size_type n);
+    // out = pow(x, value)
+    void (*pow)(float const *x, float value, float *out, size_type n);
+    // out = min(max(x, min), max)
+    void (*clip)(float const *x, float min, float max, float *out, size_type n);
+    // out = value
+    void (*fill)(float *out, float value, size_type n);
+    // y = alpha * x + y
+    void (*axpy)(float alpha, float const *x, float *y, size_type n);
+    // out = x op y, a step of 0 repeats the first value of x or y over the whole row (only one of them). maximum and
+    // minimum give y when one of the values is NaN
+    void (*binary)(Binary op, float const *x, size_type x_step, float const *y, size_type y_step, float *out,
+                   size_type n);
+    // GEMM micro-kernel: c (gemm_rows x gemm_columns, row stride ldc) = a * b, plus c if accumulate. a holds k columns
+    // of gemm_rows values, b k rows of gemm_columns values, both packed one after another
+    size_type gemm_rows;
+    size_type gemm_columns;
+    void (*gemm)(size_type k, float const *a, float const *b, float *c, size_type ldc, bool accumulate);
+    // out = x widened to float, x holds fp16 bit patterns. nullptr if the ISA has no conversion instructions
+    void (*fp16_to_float)(std::uint16_t const *x, float *out, size_type n);
+    // out = fp16 bit patterns of x, rounded to nearest even. nullptr if the ISA has no conversion instructions
+    void (*float_to_fp16)(float const *x, std::uint16_t *out, size_type n);
+    // Philox4x32-10 random bits (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3") for `groups` groups.
+    // Lane l of group g is the block of counter (first + g * PHILOX_LANES + l, stream) under key, its word w goes to
+    // out[(4 * g + w) * PHILOX_LANES + l]. The same on every ISA
+    void (*philox)(std::uint64_t key, std::uint64_t stream, std::uint64_t first, std::uint32_t *out, size_type groups);
+    // Fused optimizer step: clips g in place, then updates w and the state. m and v may be nullptr when the update
+    // doesn't use them
+    void (*update)(Update update, UpdateParameters const &parameters, float *w, float *g, float *m, float *v,
+                   size_type n);
+};
+
+// Kernels for the ISA selected at startup
+auto kernels() -> Kernels const &;
+
+// Kernels for the given ISA, it has to be supported by this CPU (and compiled in)
+auto kernels(Isa isa) -> Kernels const &;
+
+auto is_supported(Isa isa) -> bool;
+
+auto isa_name(Isa isa) -> char const *;
+
+} // namespace ts::simd
@@ -0,0 +1,91 @@
+#include "simd_kernels.hpp"
+
+#include <immintrin.h>
+
+namespace ts::simd {
+
+namespace {
+
+struct Avx2 {
+    using reg = __m256;
+    using mask = __m256;
+    using ireg = __m256i;
+    static constexpr size_type width = 8;
+    static constexpr bool has_fp16 = true;
+
+    static auto load(float const *p) -> reg { return _mm256_loadu_ps(p); }
+    static auto store(float *p, reg a) -> void { _mm256_storeu_ps(p, a); }
+    static auto set1(float value) -> reg { return _mm256_set1_ps(value); }
+
+    static auto load_fp16(std::uint16_t const *p) -> reg
+    {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p)));
+    }
+
+    static auto store_fp16(std::uint16_t *p, reg a) -> void
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    static auto add(reg a, reg b) -> reg { return _mm256_add_ps(a, b); }
+    static auto sub(reg a, reg b) -> reg { return _mm256_sub_ps(a, b); }
+    static auto mul(reg a, reg b) -> reg { return _mm256_mul_ps(a, b); }
+    static auto div(reg a, reg b) -> reg { return _mm256_div_ps(a, b); }
+    static auto min(reg a, reg b) -> reg { return _mm256_min_ps(a, b); }
+    static auto max(reg a, reg b) -> reg { return _mm256_max_ps(a, b); }
+    static auto sqrt(reg a) -> reg { return _mm256_sqrt_ps(a); }
+    static auto floor(reg a) -> reg { return _mm256_floor_ps(a); }
+    static auto fmadd(reg a, reg b, reg c) -> reg { return _mm256_fmadd_ps(a, b, c); }
+
+    static auto less(reg a, reg b) -> mask { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static auto greater(reg a, reg b) -> mask { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static auto equal(reg a, reg b) -> mask { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static auto unordered(reg a, reg b) -> mask { return _mm256_cmp_ps(a, b, _CMP_UNORD_Q); }
+    static auto mask_or(mask a, mask b) -> mask { return _mm256_or_ps(a, b); }
+    static auto blend(reg a, reg b, mask m) -> reg { return _mm256_blendv_ps(a, b, m); }
+
+    static auto exponent(reg a) -> reg
+    {
+        __m256i bits = _mm256_srli_epi32(_mm256_castps_si256(a), 23);
+        return _mm256_cvtepi32_ps(_mm256_sub_epi32(bits, _mm256_set1_epi32(127)));
+    }
+
+    static auto with_exponent_of_half(reg a) -> reg
+    {
+        reg mantissa = _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(~0x7f800000)));
+        return _mm256_or_ps(mantissa, _mm256_set1_ps(0.5f));
+    }
+
+    static auto pow2(reg n) -> reg
+    {
+        __m256i bits = _mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 23));
+    }
+
+    static auto iload(std::uint32_t const *p) -> ireg
+    {
+        return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+    }
+    static auto istore(std::uint32_t *p, ireg a) -> void { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), a); }
+    static auto iset1(std::uint32_t value) -> ireg { return _mm256_set1_epi32(static_cast<int>(value)); }
+    static auto ixor(ireg a, ireg b) -> ireg { return _mm256_xor_si256(a, b); }
+
+    static auto mulhilo(ireg a, std::uint32_t b, ireg &hi, ireg &lo) -> void
+    {
+        __m256i m = _mm256_set1_epi32(static_cast<int>(b));
+        __m256i even = _mm256_mul_epu32(a, m);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+        lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    }
+};
+
+} // namespace
+
+auto avx2_kernels() -> Kernels const &
+{
+    static Kernels const kernels = detail::make_kernels<Avx2>(Isa::AVX2);
+    return kernels;
+}
+
+} // namespace ts::simd
@@ -0,0 +1,88 @@
+#include "simd_kernels.hpp"
+
+#include <immintrin.h>
+
+namespace ts::simd {
+
+namespace {
+
+struct Avx512 {
+    using reg = __m512;
+    using mask = __mmask16;
+    using ireg = __m512i;
+    static constexpr size_type width = 16;
+    static constexpr bool has_fp16 = true;
+
+    static auto load(float const *p) -> reg { return _mm512_loadu_ps(p); }
+    static auto store(float *p, reg a) -> void { _mm512_storeu_ps(p, a); }
+    static auto set1(float value) -> reg { return _mm512_set1_ps(value); }
+
+    static auto load_fp16(std::uint16_t const *p) -> reg
+    {
+        return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)));
+    }
+
+    static auto store_fp16(std::uint16_t *p, reg a) -> void
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm512_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    static auto add(reg a, reg b) -> reg { return _mm512_add_ps(a, b); }
+    static auto sub(reg a, reg b) -> reg { return _mm512_sub_ps(a, b); }
+    static auto mul(reg a, reg b) -> reg { return _mm512_mul_ps(a, b); }
+    static auto div(reg a, reg b) -> reg { return _mm512_div_ps(a, b); }
+    static auto min(reg a, reg b) -> reg { return _mm512_min_ps(a, b); }
+    static auto max(reg a, reg b) -> reg { return _mm512_max_ps(a, b); }
+    static auto sqrt(reg a) -> reg { return _mm512_sqrt_ps(a); }
+    static auto floor(reg a) -> reg { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static auto fmadd(reg a, reg b, reg c) -> reg { return _mm512_fmadd_ps(a, b, c); }
+
+    static auto less(reg a, reg b) -> mask { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static auto greater(reg a, reg b) -> mask { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static auto equal(reg a, reg b) -> mask { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static auto unordered(reg a, reg b) -> mask { return _mm512_cmp_ps_mask(a, b, _CMP_UNORD_Q); }
+    static auto mask_or(mask a, mask b) -> mask { return _mm512_kor(a, b); }
+    static auto blend(reg a, reg b, mask m) -> reg { return _mm512_mask_blend_ps(m, a, b); }
+
+    static auto exponent(reg a) -> reg
+    {
+        __m512i bits = _mm512_srli_epi32(_mm512_castps_si512(a), 23);
+        return _mm512_cvtepi32_ps(_mm512_sub_epi32(bits, _mm512_set1_epi32(127)));
+    }
+
+    static auto with_exponent_of_half(reg a) -> reg
+    {
+        __m512i mantissa = _mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(~0x7f800000));
+        return _mm512_castsi512_ps(_mm512_or_si512(mantissa, _mm512_castps_si512(_mm512_set1_ps(0.5f))));
+    }
+
+    static auto pow2(reg n) -> reg
+    {
+        __m512i bits = _mm512_add_epi32(_mm512_cvttps_epi32(n), _mm512_set1_epi32(127));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 23));
+    }
+
+    static auto iload(std::uint32_t const *p) -> ireg { return _mm512_loadu_si512(p); }
+    static auto istore(std::uint32_t *p, ireg a) -> void { _mm512_storeu_si512(p, a); }
+    static auto iset1(std::uint32_t value) -> ireg { return _mm512_set1_epi32(static_cast<int>(value)); }
+    static auto ixor(ireg a, ireg b) -> ireg { return _mm512_xor_si512(a, b); }
+
+    static auto mulhilo(ireg a, std::uint32_t b, ireg &hi, ireg &lo) -> void
+    {
+        __m512i m = _mm512_set1_epi32(static_cast<int>(b));
+        __m512i even = _mm512_mul_epu32(a, m);
+        __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+        lo = _mm512_mask_blend_epi32(0xAAAA, even, _mm512_slli_epi64(odd, 32));
+        hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+    }
+};
+
+} // namespace
+
+auto avx512_kernels() -> Kernels const &
+{
+    static Kernels const kernels = detail::make_kernels<Avx512>(Isa::AVX512);
+    return kernels;
+}
+
+} // namespace ts::simd
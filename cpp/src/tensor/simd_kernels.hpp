@@ -0,0 +1,506 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#include "tensor/simd.hpp"
+
+// Kernels written once against a small set of vector operations, every simd_<isa>.cpp implements these operations
+// with its own intrinsics (in an anonymous namespace, so code built with e.g. -mavx512f never leaks into other
+// translation units) and instantiates make_kernels() with them.
+//
+// A vector type V provides:
+//   reg, mask, width, load, store, set1, add, sub, mul, div, min, max, sqrt, floor, fmadd, less, greater, equal,
+//   unordered, mask_or, blend (takes b where mask is set), exponent (unbiased exponent as float),
+//   with_exponent_of_half (keeps mantissa and sign, exponent of 0.5), pow2 (2^n for integral n)
+// and has_fp16, if it's true also load_fp16 and store_fp16 (conversions from/to fp16 bit patterns).
+// For integers there is ireg with iload, istore, iset1, ixor and mulhilo (32 x 32 -> 64 bit products split in halves).
+
+namespace ts::simd {
+
+auto sse42_kernels() -> Kernels const &;
+auto avx2_kernels() -> Kernels const &;
+auto avx512_kernels() -> Kernels const &;
+
+namespace detail {
+
+// Main loop over full registers, the tail goes through a padded buffer so every op needs a single vector version
+template <typename V, typename Op> inline void map(float const *x, float *out, size_type n, float pad, Op op)
+{
+    size_type i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, op(V::load(x + i)));
+    }
+    if (i < n) {
+        float buffer[V::width];
+        for (size_type k = 0; k < V::width; ++k) {
+            buffer[k] = i + k < n ? x[i + k] : pad;
+        }
+        V::store(buffer, op(V::load(buffer)));
+        for (size_type k = 0; i + k < n; ++k) {
+            out[i + k] = buffer[k];
+        }
+    }
+}
+
+template <typename V, typename Op>
+inline void map(float const *x, float const *y, float *out, size_type n, float pad, Op op)
+{
+    size_type i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, op(V::load(x + i), V::load(y + i)));
+    }
+    if (i < n) {
+        float buffer_x[V::width];
+        float buffer_y[V::width];
+        for (size_type k = 0; k < V::width; ++k) {
+            buffer_x[k] = i + k < n ? x[i + k] : pad;
+            buffer_y[k] = i + k < n ? y[i + k] : pad;
+        }
+        V::store(buffer_x, op(V::load(buffer_x), V::load(buffer_y)));
+        for (size_type k = 0; i + k < n; ++k) {
+            out[i + k] = buffer_x[k];
+        }
+    }
+}
+
+// Cephes expf: exp(x) = 2^n * exp(r), |r| <= ln(2)/2, relative error ~2 ulp
+template <typename V> inline auto exp(typename V::reg x) -> typename V::reg
+{
+    using reg = typename V::reg;
+    // anything above overflows, anything below would be a denormal and is flushed to zero
+    reg const overflow = V::set1(88.7228391f);
+    reg const underflow = V::set1(-87.3365448f);
+
+    // min/max return their second operand for NaNs, so NaNs go through
+    reg clamped = V::max(underflow, V::min(overflow, x));
+    reg n = V::floor(V::fmadd(clamped, V::set1(1.44269504088896341f), V::set1(0.5f)));
+    reg r = V::sub(clamped, V::mul(n, V::set1(0.693359375f)));
+    r = V::sub(r, V::mul(n, V::set1(-2.12194440e-4f)));
+
+    reg y = V::set1(1.9875691500e-4f);
+    y = V::fmadd(y, r, V::set1(1.3981999507e-3f));
+    y = V::fmadd(y, r, V::set1(8.3334519073e-3f));
+    y = V::fmadd(y, r, V::set1(4.1665795894e-2f));
+    y = V::fmadd(y, r, V::set1(1.6666665459e-1f));
+    y = V::fmadd(y, r, V::set1(5.0000001201e-1f));
+    y = V::fmadd(y, V::mul(r, r), V::add(r, V::set1(1.0f)));
+    // n reaches 128 just below the overflow threshold, 2^128 isn't a float so scale in two steps there
+    auto top = V::greater(n, V::set1(127.0f));
+    y = V::mul(y, V::pow2(V::blend(n, V::set1(127.0f), top)));
+    y = V::blend(y, V::add(y, y), top);
+
+    y = V::blend(y, V::set1(INFINITY), V::greater(x, overflow));
+    return V::blend(y, V::set1(0.0f), V::less(x, underflow));
+}
+
+// Cephes logf: log(x) = e * ln(2) + log(m), sqrt(0.5) <= m < sqrt(2), relative error ~2 ulp
+template <typename V> inline auto log(typename V::reg x) -> typename V::reg
+{
+    using reg = typename V::reg;
+    reg const one = V::set1(1.0f);
+
+    // denormals are treated as the smallest normal number
+    reg m = V::max(V::set1(1.17549435e-38f), x);
+    reg e = V::add(V::exponent(m), one);
+    m = V::with_exponent_of_half(m);
+
+    auto small = V::less(m, V::set1(0.707106781186547524f));
+    e = V::blend(e, V::sub(e, one), small);
+    m = V::sub(V::blend(m, V::add(m, m), small), one);
+
+    reg z = V::mul(m, m);
+    reg y = V::set1(7.0376836292e-2f);
+    y = V::fmadd(y, m, V::set1(-1.1514610310e-1f));
+    y = V::fmadd(y, m, V::set1(1.1676998740e-1f));
+    y = V::fmadd(y, m, V::set1(-1.2420140846e-1f));
+    y = V::fmadd(y, m, V::set1(1.4249322787e-1f));
+    y = V::fmadd(y, m, V::set1(-1.6668057665e-1f));
+    y = V::fmadd(y, m, V::set1(2.0000714765e-1f));
+    y = V::fmadd(y, m, V::set1(-2.4999993993e-1f));
+    y = V::fmadd(y, m, V::set1(3.3333331174e-1f));
+    y = V::mul(V::mul(y, m), z);
+    y = V::fmadd(e, V::set1(-2.12194440e-4f), y);
+    y = V::fmadd(z, V::set1(-0.5f), y);
+    reg result = V::add(m, y);
+    result = V::fmadd(e, V::set1(0.693359375f), result);
+
+    result = V::blend(result, V::set1(INFINITY), V::equal(x, V::set1(INFINITY)));
+    result = V::blend(result, V::set1(-INFINITY), V::equal(x, V::set1(0.0f)));
+    return V::blend(result, V::set1(NAN), V::mask_or(V::less(x, V::set1(0.0f)), V::unordered(x, x)));
+}
+
+template <typename V> void add(float const *x, float const *y, float *out, size_type n)
+{
+    map<V>(x, y, out, n, 0.0f, [](auto a, auto b) { return V::add(a, b); });
+}
+
+template <typename V> void multiply(float const *x, float const *y, float *out, size_type n)
+{
+    map<V>(x, y, out, n, 0.0f, [](auto a, auto b) { return V::mul(a, b); });
+}
+
+template <typename V> void add_scalar(float const *x, float value, float *out, size_type n)
+{
+    auto v = V::set1(value);
+    map<V>(x, out, n, 0.0f, [v](auto a) { return V::add(a, v); });
+}
+
+template <typename V> void multiply_scalar(float const *x, float value, float *out, size_type n)
+{
+    auto v = V::set1(value);
+    map<V>(x, out, n, 0.0f, [v](auto a) { return V::mul(a, v); });
+}
+
+template <typename V> void maximum(float value, float const *x, float *out, size_type n)
+{
+    // max(v, x) gives x when x is NaN, same as `x < v ? v : x`
+    auto v = V::set1(value);
+    map<V>(x, out, n, 0.0f, [v](auto a) { return V::max(v, a); });
+}
+
+template <typename V> void exp(float const *x, float epsilon, float *out, size_type n)
+{
+    auto eps = V::set1(epsilon);
+    map<V>(x, out, n, 0.0f, [eps](auto a) { return V::add(detail::exp<V>(a), eps); });
+}
+
+template <typename V> void log(float const *x, float epsilon, float *out, size_type n)
+{
+    auto eps = V::set1(epsilon);
+    map<V>(x, out, n, 1.0f, [eps](auto a) { return detail::log<V>(V::add(a, eps)); });
+}
+
+template <typename V> void pow(float const *x, float value, float *out, size_type n)
+{
+    // exponents common in nn code get exact versions, the rest goes through exp(value * log(x)) which is only defined
+    // for positive x, blocks with other values fall back to powf
+    if (value == 2.0f) {
+        map<V>(x, out, n, 0.0f, [](auto a) { return V::mul(a, a); });
+        return;
+    }
+    if (value == 1.0f) {
+        map<V>(x, out, n, 0.0f, [](auto a) { return a; });
+        return;
+    }
+    if (value == 0.5f) {
+        map<V>(x, out, n, 0.0f, [](auto a) { return V::sqrt(a); });
+        return;
+    }
+    if (value == -1.0f) {
+        auto one = V::set1(1.0f);
+        map<V>(x, out, n, 1.0f, [one](auto a) { return V::div(one, a); });
+        return;
+    }
+    auto v = V::set1(value);
+    for (size_type i = 0; i < n; i += V::width) {
+        size_type block = n - i < V::width ? n - i : V::width;
+        bool positive = true;
+        for (size_type k = 0; k < block; ++k) {
+            positive = positive && x[i + k] > 0.0f && x[i + k] < INFINITY;
+        }
+        if (positive) {
+            map<V>(x + i, out + i, block, 1.0f, [v](auto a) { return detail::exp<V>(V::mul(v, detail::log<V>(a))); });
+        } else {
+            for (size_type k = 0; k < block; ++k) {
+                out[i + k] = ::powf(x[i + k], value);
+            }
+        }
+    }
+}
+
+template <typename V> void clip(float const *x, float min, float max, float *out, size_type n)
+{
+    auto lo = V::set1(min);
+    auto hi = V::set1(max);
+    map<V>(x, out, n, 0.0f, [lo, hi](auto a) { return V::max(lo, V::min(hi, a)); });
+}
+
+template <typename V> void fill(float *out, float value, size_type n)
+{
+    auto v = V::set1(value);
+    size_type i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, v);
+    }
+    for (; i < n; ++i) {
+        out[i] = value;
+    }
+}
+
+template <typename V> void axpy(float alpha, float const *x, float *y, size_type n)
+{
+    auto a = V::set1(alpha);
+    map<V>(x, y, y, n, 0.0f, [a](auto b, auto c) { return V::fmadd(a, b, c); });
+}
+
+// x or y may be a single value repeated over the row, padding with ones keeps divisions in the tail quiet
+template <typename V, typename Op>
+inline void map_broadcast(float const *x, size_type x_step, float const *y, size_type y_step, float *out, size_type n,
+                          Op op)
+{
+    if (x_step == 0) {
+        auto a = V::set1(*x);
+        map<V>(y, out, n, 1.0f, [a, op](auto b) { return op(a, b); });
+    } else if (y_step == 0) {
+        auto b = V::set1(*y);
+        map<V>(x, out, n, 1.0f, [b, op](auto a) { return op(a, b); });
+    } else {
+        map<V>(x, y, out, n, 1.0f, op);
+    }
+}
+
+template <typename V>
+void binary(Binary op, float const *x, size_type x_step, float const *y, size_type y_step, float *out, size_type n)
+{
+    switch (op) {
+    case Binary::ADD:
+        map_broadcast<V>(x, x_step, y, y_step, out, n, [](auto a, auto b) { return V::add(a, b); });
+        break;
+    case Binary::SUBTRACT:
+        map_broadcast<V>(x, x_step, y, y_step, out, n, [](auto a, auto b) { return V::sub(a, b); });
+        break;
+    case Binary::MULTIPLY:
+        map_broadcast<V>(x, x_step, y, y_step, out, n, [](auto a, auto b) { return V::mul(a, b); });
+        break;
+    case Binary::DIVIDE:
+        map_broadcast<V>(x, x_step, y, y_step, out, n, [](auto a, auto b) { return V::div(a, b); });
+        break;
+    case Binary::MAXIMUM:
+        map_broadcast<V>(x, x_step, y, y_step, out, n, [](auto a, auto b) { return V::max(a, b); });
+        break;
+    case Binary::MINIMUM:
+        map_broadcast<V>(x, x_step, y, y_step, out, n, [](auto a, auto b) { return V::min(a, b); });
+        break;
+    }
+}
+
+// Rows of the GEMM micro-kernel, as many accumulators as fit in the registers next to two of b and one of a (there are
+// 32 registers with AVX-512, 16 otherwise)
+template <typename V> inline constexpr size_type gemm_rows = V::width == 16 ? 12 : 6;
+
+template <typename V> void gemm(size_type k, float const *a, float const *b, float *c, size_type ldc, bool accumulate)
+{
+    using reg = typename V::reg;
+    constexpr size_type rows = gemm_rows<V>;
+    constexpr size_type width = V::width;
+
+    reg acc[rows][2];
+    for (size_type r = 0; r < rows; ++r) {
+        acc[r][0] = V::set1(0.0f);
+        acc[r][1] = V::set1(0.0f);
+    }
+    for (size_type p = 0; p < k; ++p, a += rows, b += 2 * width) {
+        reg b0 = V::load(b);
+        reg b1 = V::load(b + width);
+        for (size_type r = 0; r < rows; ++r) {
+            reg value = V::set1(a[r]);
+            acc[r][0] = V::fmadd(value, b0, acc[r][0]);
+            acc[r][1] = V::fmadd(value, b1, acc[r][1]);
+        }
+    }
+    for (size_type r = 0; r < rows; ++r) {
+        float *row = c + r * ldc;
+        if (accumulate) {
+            acc[r][0] = V::add(acc[r][0], V::load(row));
+            acc[r][1] = V::add(acc[r][1], V::load(row + width));
+        }
+        V::store(row, acc[r][0]);
+        V::store(row + width, acc[r][1]);
+    }
+}
+
+template <typename V> void fp16_to_float(std::uint16_t const *x, float *out, size_type n)
+{
+    size_type i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store(out + i, V::load_fp16(x + i));
+    }
+    if (i < n) {
+        std::uint16_t buffer[V::width] = {};
+        float result[V::width];
+        std::memcpy(buffer, x + i, (n - i) * sizeof(std::uint16_t));
+        V::store(result, V::load_fp16(buffer));
+        std::memcpy(out + i, result, (n - i) * sizeof(float));
+    }
+}
+
+template <typename V> void float_to_fp16(float const *x, std::uint16_t *out, size_type n)
+{
+    size_type i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        V::store_fp16(out + i, V::load(x + i));
+    }
+    if (i < n) {
+        float buffer[V::width] = {};
+        std::uint16_t result[V::width];
+        std::memcpy(buffer, x + i, (n - i) * sizeof(float));
+        V::store_fp16(result, V::load(buffer));
+        std::memcpy(out + i, result, (n - i) * sizeof(std::uint16_t));
+    }
+}
+
+// Runs op(w, g, m, v) on registers of all four buffers and stores them back, a missing state buffer reads as zeros.
+// The tail goes through zero padded buffers, every update maps zeros to zeros.
+template <typename V, typename Op>
+inline void map_update(float *w, float *g, float *m, float *v, size_type n, Op op)
+{
+    using reg = typename V::reg;
+    size_type i = 0;
+    for (; i + V::width <= n; i += V::width) {
+        reg w_i = V::load(w + i);
+        reg g_i = V::load(g + i);
+        reg m_i = m != nullptr ? V::load(m + i) : V::set1(0.0f);
+        reg v_i = v != nullptr ? V::load(v + i) : V::set1(0.0f);
+        op(w_i, g_i, m_i, v_i);
+        V::store(w + i, w_i);
+        V::store(g + i, g_i);
+        if (m != nullptr) {
+            V::store(m + i, m_i);
+        }
+        if (v != nullptr) {
+            V::store(v + i, v_i);
+        }
+    }
+    if (i < n) {
+        float buffers[4][V::width] = {};
+        float *outputs[4] = {w, g, m, v};
+        for (size_type b = 0; b < 4; ++b) {
+            for (size_type k = 0; outputs[b] != nullptr && i + k < n; ++k) {
+                buffers[b][k] = outputs[b][i + k];
+            }
+        }
+        reg w_i = V::load(buffers[0]);
+        reg g_i = V::load(buffers[1]);
+        reg m_i = V::load(buffers[2]);
+        reg v_i = V::load(buffers[3]);
+        op(w_i, g_i, m_i, v_i);
+        V::store(buffers[0], w_i);
+        V::store(buffers[1], g_i);
+        V::store(buffers[2], m_i);
+        V::store(buffers[3], v_i);
+        for (size_type b = 0; b < 4; ++b) {
+            for (size_type k = 0; outputs[b] != nullptr && i + k < n; ++k) {
+                outputs[b][i + k] = buffers[b][k];
+            }
+        }
+    }
+}
+
+template <typename V>
+void update(Update update, UpdateParameters const &p, float *w, float *g, float *m, float *v, size_type n)
+{
+    using reg = typename V::reg;
+    reg lr = V::set1(p.lr);
+    reg beta1 = V::set1(p.beta1);
+    reg beta2 = V::set1(p.beta2);
+    reg one_minus_beta1 = V::set1(1.0f - p.beta1);
+    reg one_minus_beta2 = V::set1(1.0f - p.beta2);
+    reg epsilon = V::set1(p.epsilon);
+    reg correction = V::set1(p.correction);
+    reg low = V::set1(-p.clip);
+    reg high = V::set1(p.clip);
+    // min/max return their second operand for NaNs, a NaN gradient stays NaN like in the scalar step
+    auto clip = [&](reg &grad) { grad = V::min(high, V::max(low, grad)); };
+
+    switch (update) {
+    case Update::SGD:
+        map_update<V>(w, g, nullptr, nullptr, n, [&](reg &w_i, reg &g_i, reg &, reg &) {
+            clip(g_i);
+            w_i = V::sub(w_i, V::mul(lr, g_i));
+        });
+        break;
+    case Update::MOMENTUM:
+        map_update<V>(w, g, m, nullptr, n, [&](reg &w_i, reg &g_i, reg &m_i, reg &) {
+            clip(g_i);
+            m_i = V::add(V::mul(beta1, m_i), V::mul(lr, g_i));
+            w_i = V::sub(w_i, m_i);
+        });
+        break;
+    case Update::ADAGRAD:
+        map_update<V>(w, g, m, nullptr, n, [&](reg &w_i, reg &g_i, reg &m_i, reg &) {
+            clip(g_i);
+            m_i = V::add(m_i, V::mul(g_i, g_i));
+            w_i = V::sub(w_i, V::div(V::mul(lr, g_i), V::sqrt(V::add(m_i, epsilon))));
+        });
+        break;
+    case Update::RMSPROP:
+        map_update<V>(w, g, m, nullptr, n, [&](reg &w_i, reg &g_i, reg &m_i, reg &) {
+            clip(g_i);
+            m_i = V::add(V::mul(beta1, m_i), V::mul(one_minus_beta1, V::mul(g_i, g_i)));
+            w_i = V::sub(w_i, V::div(V::mul(lr, g_i), V::add(V::sqrt(m_i), epsilon)));
+        });
+        break;
+    case Update::ADAM:
+        map_update<V>(w, g, m, v, n, [&](reg &w_i, reg &g_i, reg &m_i, reg &v_i) {
+            clip(g_i);
+            m_i = V::add(V::mul(beta1, m_i), V::mul(one_minus_beta1, g_i));
+            v_i = V::add(V::mul(beta2, v_i), V::mul(one_minus_beta2, V::mul(g_i, g_i)));
+            reg denominator = V::add(V::div(V::sqrt(v_i), correction), epsilon);
+            w_i = V::sub(w_i, V::div(V::mul(lr, m_i), denominator));
+        });
+        break;
+    }
+}
+
+// Philox4x32 constants: multipliers and the Weyl sequence the key is bumped by after every round
+inline constexpr std::uint32_t PHILOX_M0 = 0xD2511F53;
+inline constexpr std::uint32_t PHILOX_M1 = 0xCD9E8D57;
+inline constexpr std::uint32_t PHILOX_W0 = 0x9E3779B9;
+inline constexpr std::uint32_t PHILOX_W1 = 0xBB67AE85;
+inline constexpr int PHILOX_ROUNDS = 10;
+
+// Every register holds one word of V::width counters
+template <typename V>
+void philox(std::uint64_t key, std::uint64_t stream, std::uint64_t first, std::uint32_t *out, size_type groups)
+{
+    using ireg = typename V::ireg;
+    static_assert(PHILOX_LANES % V::width == 0);
+    for (size_type g = 0; g < groups; ++g) {
+        std::uint32_t *group = out + g * 4 * PHILOX_LANES;
+        for (size_type lane = 0; lane < PHILOX_LANES; lane += V::width) {
+            std::uint32_t low[V::width];
+            std::uint32_t high[V::width];
+            for (size_type l = 0; l < V::width; ++l) {
+                std::uint64_t counter = first + g * PHILOX_LANES + lane + l;
+                low[l] = static_cast<std::uint32_t>(counter);
+                high[l] = static_cast<std::uint32_t>(counter >> 32);
+            }
+            ireg c0 = V::iload(low);
+            ireg c1 = V::iload(high);
+            ireg c2 = V::iset1(static_cast<std::uint32_t>(stream));
+            ireg c3 = V::iset1(static_cast<std::uint32_t>(stream >> 32));
+            auto k0 = static_cast<std::uint32_t>(key);
+            auto k1 = static_cast<std::uint32_t>(key >> 32);
+            for (int round = 0; round < PHILOX_ROUNDS; ++round, k0 += PHILOX_W0, k1 += PHILOX_W1) {
+                ireg hi0, lo0, hi1, lo1;
+                V::mulhilo(c0, PHILOX_M0, hi0, lo0);
+                V::mulhilo(c2, PHILOX_M1, hi1, lo1);
+                c0 = V::ixor(V::ixor(hi1, c1), V::iset1(k0));
+                c1 = lo1;
+                c2 = V::ixor(V::ixor(hi0, c3), V::iset1(k1));
+                c3 = lo0;
+            }
+            V::istore(group + lane, c0);
+            V::istore(group + PHILOX_LANES + lane, c1);
+            V::istore(group + 2 * PHILOX_LANES + lane, c2);
+            V::istore(group + 3 * PHILOX_LANES + lane, c3);
+        }
+    }
+}
+
+template <typename V> auto make_kernels(Isa isa) -> Kernels
+{
+    Kernels kernels{isa,          add<V>,       multiply<V>, add_scalar<V>, multiply_scalar<V>, maximum<V>,
+                    exp<V>,       log<V>,       pow<V>,      clip<V>,       fill<V>,            axpy<V>,
+                    binary<V>,    gemm_rows<V>, 2 * V::width, gemm<V>,      nullptr,            nullptr,
+                    philox<V>,    update<V>};
+    if constexpr (V::has_fp16) {
+        kernels.fp16_to_float = fp16_to_float<V>;
+        kernels.float_to_fp16 = float_to_fp16<V>;
+    }
+    return kernels;
+}
+
+} // namespace detail
+} // namespace ts::simd
@@ -0,0 +1,79 @@
+#include "simd_kernels.hpp"
+
+#include <nmmintrin.h>
+
+namespace ts::simd {
+
+namespace {
+
+struct Sse42 {
+    using reg = __m128;
+    using mask = __m128;
+    using ireg = __m128i;
+    static constexpr size_type width = 4;
+    static constexpr bool has_fp16 = false;
+
+    static auto load(float const *p) -> reg { return _mm_loadu_ps(p); }
+    static auto store(float *p, reg a) -> void { _mm_storeu_ps(p, a); }
+    static auto set1(float value) -> reg { return _mm_set1_ps(value); }
+
+    static auto add(reg a, reg b) -> reg { return _mm_add_ps(a, b); }
+    static auto sub(reg a, reg b) -> reg { return _mm_sub_ps(a, b); }
+    static auto mul(reg a, reg b) -> reg { return _mm_mul_ps(a, b); }
+    static auto div(reg a, reg b) -> reg { return _mm_div_ps(a, b); }
+    static auto min(reg a, reg b) -> reg { return _mm_min_ps(a, b); }
+    static auto max(reg a, reg b) -> reg { return _mm_max_ps(a, b); }
+    static auto sqrt(reg a) -> reg { return _mm_sqrt_ps(a); }
+    static auto floor(reg a) -> reg { return _mm_floor_ps(a); }
+    static auto fmadd(reg a, reg b, reg c) -> reg { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+    static auto less(reg a, reg b) -> mask { return _mm_cmplt_ps(a, b); }
+    static auto greater(reg a, reg b) -> mask { return _mm_cmpgt_ps(a, b); }
+    static auto equal(reg a, reg b) -> mask { return _mm_cmpeq_ps(a, b); }
+    static auto unordered(reg a, reg b) -> mask { return _mm_cmpunord_ps(a, b); }
+    static auto mask_or(mask a, mask b) -> mask { return _mm_or_ps(a, b); }
+    static auto blend(reg a, reg b, mask m) -> reg { return _mm_blendv_ps(a, b, m); }
+
+    static auto exponent(reg a) -> reg
+    {
+        __m128i bits = _mm_srli_epi32(_mm_castps_si128(a), 23);
+        return _mm_cvtepi32_ps(_mm_sub_epi32(bits, _mm_set1_epi32(127)));
+    }
+
+    static auto with_exponent_of_half(reg a) -> reg
+    {
+        reg mantissa = _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(~0x7f800000)));
+        return _mm_or_ps(mantissa, _mm_set1_ps(0.5f));
+    }
+
+    static auto pow2(reg n) -> reg
+    {
+        __m128i bits = _mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127));
+        return _mm_castsi128_ps(_mm_slli_epi32(bits, 23));
+    }
+
+    static auto iload(std::uint32_t const *p) -> ireg { return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)); }
+    static auto istore(std::uint32_t *p, ireg a) -> void { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), a); }
+    static auto iset1(std::uint32_t value) -> ireg { return _mm_set1_epi32(static_cast<int>(value)); }
+    static auto ixor(ireg a, ireg b) -> ireg { return _mm_xor_si128(a, b); }
+
+    // mul_epu32 multiplies even lanes only, odd ones are shifted down for a second multiply
+    static auto mulhilo(ireg a, std::uint32_t b, ireg &hi, ireg &lo) -> void
+    {
+        __m128i m = _mm_set1_epi32(static_cast<int>(b));
+        __m128i even = _mm_mul_epu32(a, m);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+        lo = _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xCC);
+        hi = _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+    }
+};
+
+} // namespace
+
+auto sse42_kernels() -> Kernels const &
+{
+    static Kernels const kernels = detail::make_kernels<Sse42>(Isa::SSE42);
+    return kernels;
+}
+
+} // namespace ts::simd
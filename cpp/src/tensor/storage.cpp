@@ -0,0 +1,71 @@
+#include "storage.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ts {
+
+auto MappedFile::open(std::string const &path, MapMode mode) -> std::shared_ptr<MappedFile>
+{
+    int fd = ::open(path.c_str(), mode == MapMode::READ_WRITE ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat status {};
+    if (fstat(fd, &status) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    auto file = map(fd, static_cast<std::size_t>(status.st_size), mode);
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    return file;
+}
+
+auto MappedFile::create(std::string const &path, std::size_t bytes) -> std::shared_ptr<MappedFile>
+{
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    auto file = map(fd, bytes, MapMode::READ_WRITE);
+    ::close(fd);
+    return file;
+}
+
+auto MappedFile::map(int fd, std::size_t size, MapMode mode) -> std::shared_ptr<MappedFile>
+{
+    if (size == 0) {
+        // mmap() refuses empty mappings
+        return std::shared_ptr<MappedFile>(new MappedFile(nullptr, 0, mode));
+    }
+    int protection = mode == MapMode::READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = mode == MapMode::COPY_ON_WRITE ? MAP_PRIVATE : MAP_SHARED;
+    void *data = mmap(nullptr, size, protection, flags, fd, 0);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return std::shared_ptr<MappedFile>(new MappedFile(static_cast<std::byte *>(data), size, mode));
+}
+
+auto MappedFile::sync() const -> void
+{
+    if (_mode == MapMode::READ_WRITE && _size > 0) {
+        msync(_data, _size, MS_SYNC);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (_size > 0) {
+        munmap(_data, _size);
+    }
+}
+
+} // namespace ts
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "tensor/tensor.hpp"
+
+// Tensors on top of memory the tensor doesn't own: buffers of other libraries and memory mapped files. Such tensors
+// work like any other one, nothing is copied on the way in. Results of ops are allocated as usual, deep copies too.
+
+namespace ts {
+
+namespace detail {
+
+template <typename Element>
+auto external_data(Element *data, size_type size, std::function<void()> release) ->
+    typename DataHolder<Element>::data_ptr_t
+{
+    static_assert(std::is_trivially_default_constructible_v<Element> && std::is_trivially_destructible_v<Element>,
+                  "external storage would be overwritten by constructors of the elements");
+    using vector_t = typename DataHolder<Element>::vector_t;
+
+    if (reinterpret_cast<std::uintptr_t>(data) % alignof(Element) != 0) {
+        std::cerr << "from_external: data is not aligned to " << alignof(Element) << " bytes" << std::endl;
+        exit(-1);
+    }
+    // the vector "allocates" its buffer from the resource and default-initializes elements which is a no-op here,
+    // so it simply ends up pointing at `data`
+    auto *resource = new ExternalResource(data, size * sizeof(Element), std::move(release));
+    auto *vector = new vector_t(size, Allocator<Element>(resource));
+    return std::shared_ptr<vector_t>(vector, [resource](vector_t *vector) {
+        delete vector;
+        delete resource;
+    });
+}
+
+} // namespace detail
+
+// Tensor using `data` as its storage. `release` is called once the last tensor (or view) sharing the storage goes
+// away, leave it empty if the caller keeps the buffer alive itself.
+template <typename Element, int Dim>
+auto from_external(Element *data, std::array<size_type, Dim> const &shape, std::function<void()> release = nullptr)
+    -> Tensor<Element, Dim>
+{
+    size_type size = std::reduce(shape.begin(), shape.end(), size_type(1), std::multiplies<>());
+    return Tensor<Element, Dim>(detail::external_data(data, size, std::move(release)), shape);
+}
+
+enum class MapMode {
+    READ_ONLY,     // writing to the tensor crashes the program
+    READ_WRITE,    // writes go to the file and are visible to other processes mapping it
+    COPY_ON_WRITE, // writes stay private to this process, touched pages get copied
+};
+
+// File mapped into memory. Pages are read from disk the first time they're touched and shared with every other
+// process mapping the same file, so big weights and datasets "load" instantly and don't take memory twice.
+class MappedFile {
+  public:
+    // nullptr when the file can't be opened or mapped
+    static auto open(std::string const &path, MapMode mode = MapMode::READ_ONLY) -> std::shared_ptr<MappedFile>;
+
+    // Creates (or truncates) a file of `bytes` zeros and maps it for writing
+    static auto create(std::string const &path, std::size_t bytes) -> std::shared_ptr<MappedFile>;
+
+    MappedFile(MappedFile const &) = delete;
+
+    auto operator=(MappedFile const &) -> MappedFile & = delete;
+
+    ~MappedFile();
+
+    [[nodiscard]] auto data() const -> std::byte * { return _data; }
+
+    [[nodiscard]] auto size() const -> std::size_t { return _size; }
+
+    [[nodiscard]] auto mode() const -> MapMode { return _mode; }
+
+    // Flushes writes of a READ_WRITE mapping to disk
+    auto sync() const -> void;
+
+  private:
+    MappedFile(std::byte *data, std::size_t size, MapMode mode) : _data(data), _size(size), _mode(mode) {}
+
+    static auto map(int fd, std::size_t size, MapMode mode) -> std::shared_ptr<MappedFile>;
+
+    std::byte *_data;
+    std::size_t _size;
+    MapMode _mode;
+};
+
+// Tensor reading its elements straight from the mapping, starting `offset` bytes into the file. The mapping stays
+// alive as long as the tensor does.
+template <typename Element, int Dim>
+auto from_mapped_file(std::shared_ptr<MappedFile> const &file, std::array<size_type, Dim> const &shape,
+                      std::size_t offset = 0) -> Tensor<Element, Dim>
+{
+    size_type size = std::reduce(shape.begin(), shape.end(), size_type(1), std::multiplies<>());
+    if (offset > file->size() || (file->size() - offset) / sizeof(Element) < size) {
+        std::cerr << "from_mapped_file: " << size << " elements starting at byte " << offset
+                  << " don't fit in a file of " << file->size() << " bytes" << std::endl;
+        exit(-1);
+    }
+    auto *data = reinterpret_cast<Element *>(file->data() + offset);
+    return from_external<Element, Dim>(data, shape, [file]() {});
+}
+
+} // namespace ts
@@ -28,8 +28,13 @@ template <typename Element, int Dim> class Tensor : public DataHolder<Element> {
     auto shape() const -> std::array<size_type, Dim> { return _dimensions; }
     [[nodiscard]] auto shape(size_type index) const -> size_type { return _dimensions[index]; }
     [[nodiscard]] auto data_size() const -> size_type { return _data_size; }
+    auto strides() const -> std::array<size_type, Dim> { return _strides; }
+    [[nodiscard]] auto is_contiguous() const -> bool;
+    auto contiguous() const -> Tensor;
     auto clone() const -> Tensor;
 
+    // For non-contiguous views begin() points at the first element and [begin, end) spans all the memory the view
+    // touches, iterating over it only makes sense after contiguous()
     auto begin() -> iterator { return _begin; }
     auto end() -> iterator { return _end; }
     auto begin() const -> iterator { return _begin; }
@@ -45,7 +50,10 @@ template <typename Element, int Dim> class Tensor : public DataHolder<Element> {
 
     explicit Tensor(std::array<size_type, Dim> const &shape);
 
-    template <typename... Sizes> explicit Tensor(size_type first, Sizes... rest);
+    Tensor(std::array<size_type, Dim> const &shape, uninitialized_t);
+
+    template <typename... Sizes, typename = std::enable_if_t<(std::is_integral_v<Sizes> && ...)>>
+    explicit Tensor(size_type first, Sizes... rest);
 
     Tensor(Tensor const &tensor, bool deep_copy);
 
@@ -59,6 +67,8 @@ template <typename Element, int Dim> class Tensor : public DataHolder<Element> {
 
     Tensor(data_t data, std::array<size_type, Dim> shape) : Tensor(data, shape, data->begin(), data->end()){};
 
+    Tensor(data_t data, std::array<size_type, Dim> shape, std::array<size_type, Dim> strides, iterator begin);
+
     template <typename... Indices> auto operator()(size_type first, Indices... rest) -> decltype(auto);
 
     template <typename... Indices> auto operator()(size_type first, Indices... rest) const -> decltype(auto);
@@ -89,39 +99,45 @@ template <typename Element, int Dim> class Tensor : public DataHolder<Element> {
 
     auto operator-() -> Tensor &;
 
-    template <typename T> auto cast() -> Tensor<T, Dim>
-    {
-        auto t = Tensor<T, Dim>();
-        t._data = std::make_shared<std::vector<T>>(std::vector<T>(begin(), end()));
-        t._dimensions = _dimensions;
-        t._data_size = _data_size;
-        t._begin = t.data()->begin();
-        t._end = t.data()->end();
+    // Copies elements of a tensor of the same shape into this one, both can be views
+    auto assign(Tensor const &tensor) const -> void;
 
-        std::advance(t._begin, std::distance(_data->begin(), _begin));
-        std::advance(t._end, std::distance(_end, _data->end()));
+    // View with dimensions reordered, e.g. permute({0, 3, 1, 2}) turns NHWC into NCHW
+    auto permute(std::array<int, Dim> const &axes) const -> Tensor;
 
+    template <typename T> auto cast() const -> Tensor<T, Dim>
+    {
+        auto source = contiguous();
+        auto t = Tensor<T, Dim>(_dimensions, uninitialized);
+        if constexpr ((is_half_v<T> && std::is_same_v<Element, float>) ||
+                      (is_half_v<Element> && std::is_same_v<T, float>)) {
+            Element const *input = source.raw_data();
+            T *output = t.raw_data_mutable();
+            parallel_for(
+                _data_size,
+                [&](size_type begin, size_type end) { convert(input + begin, output + begin, end - begin); },
+                elements_per_cache_line<T>);
+        } else {
+            std::copy(source.begin(), source.end(), t.begin());
+        }
         return t;
     }
 
     auto flatten() const -> Vector<Element>
     {
-        auto t = Vector<Element>(_data_size);
-        t._data = _data;
-        t._dimensions = std::array<size_type, 1>{_data_size};
-        t._data_size = _data_size;
-        t._begin = t.data()->begin();
-        t._end = t.data()->end();
-
-        std::advance(t._begin, std::distance(_data->begin(), _begin));
-        std::advance(t._end, std::distance(_end, _data->end()));
-
-        return t;
+        if (!is_contiguous()) {
+            return contiguous().flatten();
+        }
+        return Vector<Element>(_data, {_data_size}, _begin, _begin + _data_size);
     }
 
+    // No copy unless this is a non-contiguous view
     template <int AnyDim> auto reshape(std::array<size_type, AnyDim> shape) const -> Tensor<Element, AnyDim>
     {
-        return Tensor<Element, AnyDim>(_data, shape, begin(), end());
+        if (!is_contiguous()) {
+            return contiguous().template reshape<AnyDim>(shape);
+        }
+        return Tensor<Element, AnyDim>(_data, shape, _begin, _begin + _data_size);
     }
 
     auto index(std::array<int, Dim> indices) const -> size_type
@@ -135,45 +151,50 @@ template <typename Element, int Dim> class Tensor : public DataHolder<Element> {
         return index;
     }
 
+    // index is the position in the row-major order, also for views
     auto at(size_type index) const -> Element &
     {
-        return _begin[index];
+        if (is_contiguous()) {
+            return _begin[index];
+        }
+        size_type offset = 0;
+        for (int i = Dim - 1; i >= 0; --i) {
+            offset += (index % _dimensions[i]) * _strides[i];
+            index /= _dimensions[i];
+        }
+        return _begin[offset];
     }
 
 
     auto at(std::array<int, Dim> indices) const -> Element &
     {
-        size_t offset = 1;
-        size_t index = 0;
-        for (int i = indices.size() - 1; i >= 0; --i) {
-            index += indices[i] * offset;
-            offset *= _dimensions[i];
+        size_type offset = 0;
+        for (int i = 0; i < Dim; ++i) {
+            offset += indices[i] * _strides[i];
         }
-        return _begin[index];
+        return _begin[offset];
     }
 
     auto get_subarray(std::vector<size_type> indices) const -> std::pair<iterator, iterator>
     {
-        size_type offset = _dimensions.back();
-        int index = 0;
-        int start_index = int(indices.size()) - 1;
-        for (int i = start_index; i >= 0; --i) {
-            index += indices[i] * offset;
-            offset *= _dimensions[i];
+        assert(_strides.back() == 1);
+        size_type offset = 0;
+        for (size_type i = 0; i < indices.size(); ++i) {
+            offset += indices[i] * _strides[i];
         }
         iterator begin = _begin;
-        std::advance(begin, index);
+        std::advance(begin, offset);
 
         iterator end = begin;
         std::advance(end, _dimensions.back());
         return std::make_pair(begin, end);
     }
 
-    auto raw_data_mutable() -> float * {
+    auto raw_data_mutable() const -> Element * {
         return _data.get()->data() + std::distance(data().get()->begin(), begin());
     }
 
-    auto raw_data() -> float const * {
+    auto raw_data() const -> Element const * {
         return _data.get()->data() + std::distance(data().get()->begin(), begin());
     }
 
@@ -182,14 +203,22 @@ template <typename Element, int Dim> class Tensor : public DataHolder<Element> {
   private:
     size_type _data_size{};
     std::array<size_type, Dim> _dimensions;
-    std::shared_ptr<std::vector<Element>> _data;
+    std::array<size_type, Dim> _strides{};
+    data_t _data;
     iterator _begin;
     iterator _end;
 
     template <typename... Sizes> auto set_sizes(int pos, size_type first, Sizes... rest) -> void;
 
-    template <typename... Indices>
-    auto get_index(int pos, size_type prev_index, size_type first, Indices... rest) const -> size_type;
+    template <typename... Indices> auto get_offset(int pos, size_type first, Indices... rest) const -> size_type;
+
+    auto set_contiguous_strides() -> void;
+
+    // Number of elements between the first and the last element of the view, plus one
+    [[nodiscard]] auto span() const -> size_type;
+
+    // Calls fn(offset) for every element in row-major order, offsets are relative to _begin
+    template <typename Fn> auto for_each_offset(Fn fn) const -> void;
 };
 
 template <typename Element, int Dim> Tensor<Element, Dim>::Tensor()
@@ -199,13 +228,15 @@ template <typename Element, int Dim> Tensor<Element, Dim>::Tensor()
 }
 
 template <typename Element, int Dim>
-template <typename... Sizes>
+template <typename... Sizes, typename>
 Tensor<Element, Dim>::Tensor(size_type first, Sizes... rest)
 {
     set_sizes(0, first, rest...);
+    set_contiguous_strides();
     _data = std::make_shared<vector_t>(_data_size);
     _begin = _data->begin();
     _end = _data->end();
+    std::fill(_begin, _end, Element());
 }
 
 template <typename Element, int Dim>
@@ -213,17 +244,31 @@ Tensor<Element, Dim>::Tensor(Tensor<Element, Dim + 1> const &tensor, size_type i
 {
     auto shape_cpy(tensor.shape()); // TODO: why without this tests fail?
     std::copy(shape_cpy.begin() + 1, shape_cpy.end(), _dimensions.begin());
+    std::copy(tensor._strides.begin() + 1, tensor._strides.end(), _strides.begin());
 
-    _data_size = tensor.data_size() / tensor.shape(0);
+    _data_size = std::reduce(_dimensions.begin(), _dimensions.end(), 1, std::multiplies<>());
     _data = tensor.data();
-    _begin = tensor.begin() + (int)index * _data_size;
-    _end = _begin + _data_size;
+    _begin = tensor.begin() + index * tensor._strides[0];
+    _end = _begin + span();
 }
 
 template <typename Element, int Dim> Tensor<Element, Dim>::Tensor(const std::array<size_type, Dim> &shape)
 {
     std::copy(shape.begin(), shape.end(), _dimensions.begin());
     _data_size = std::reduce(shape.begin(), shape.end(), 1, std::multiplies<>());
+    set_contiguous_strides();
+    _data = std::make_shared<vector_t>(_data_size);
+    _begin = _data->begin();
+    _end = _data->end();
+    std::fill(_begin, _end, Element());
+}
+
+template <typename Element, int Dim>
+Tensor<Element, Dim>::Tensor(const std::array<size_type, Dim> &shape, uninitialized_t)
+{
+    std::copy(shape.begin(), shape.end(), _dimensions.begin());
+    _data_size = std::reduce(shape.begin(), shape.end(), 1, std::multiplies<>());
+    set_contiguous_strides();
     _data = std::make_shared<vector_t>(_data_size);
     _begin = _data->begin();
     _end = _data->end();
@@ -234,7 +279,7 @@ template <typename... Indices>
 auto Tensor<Element, Dim>::operator()(size_type first, Indices... rest) -> decltype(auto)
 {
     if constexpr (sizeof...(Indices) == Dim - 1) {
-        return _begin[get_index(0, 0, first, rest...)];
+        return _begin[get_offset(0, first, rest...)];
     } else if constexpr (Dim >= 2 && sizeof...(Indices) == 0) {
         return Tensor<Element, Dim - 1>(*this, first);
     } else if constexpr (Dim >= 2 && sizeof...(Indices) < Dim - 1) {
@@ -249,7 +294,7 @@ template <typename... Indices>
 auto Tensor<Element, Dim>::operator()(size_type first, Indices... rest) const -> decltype(auto)
 {
     if constexpr (sizeof...(Indices) == Dim - 1) {
-        return _begin[get_index(0, 0, first, rest...)];
+        return _begin[get_offset(0, first, rest...)];
     } else if constexpr (Dim >= 2 && sizeof...(Indices) == 0) {
         return Tensor<Element, Dim - 1>(*this, first);
     } else if constexpr (Dim >= 2 && sizeof...(Indices) < Dim - 1) {
@@ -265,13 +310,16 @@ auto Tensor<Element, Dim>::operator==(const Tensor<Element, Dim> &other) const -
     if (_data_size != other.data_size()) {
         return false;
     }
+    if (!is_contiguous() || !other.is_contiguous()) {
+        return contiguous() == other.contiguous();
+    }
     return std::equal(other.begin(), other.end(), _begin);
 }
 
 template <typename Element, int Dim> auto Tensor<Element, Dim>::operator[](size_type i) const -> decltype(auto)
 {
     if constexpr (Dim == 1) {
-        return _begin[i];
+        return _begin[i * _strides[0]];
     } else {
         return Tensor<Element, Dim - 1>(*this, i);
     }
@@ -290,6 +338,7 @@ template <typename Element, int Dim> auto Tensor<Element, Dim>::operator=(Tensor
     _data = tensor.data();
     _data_size = tensor.data_size();
     _dimensions = tensor.shape();
+    _strides = tensor.strides();
     _begin = tensor.begin();
     _end = tensor.end();
 
@@ -298,15 +347,11 @@ template <typename Element, int Dim> auto Tensor<Element, Dim>::operator=(Tensor
 
 template <typename Element, int Dim> auto Tensor<Element, Dim>::randn(const std::vector<int> &shape) -> Tensor
 {
-    std::random_device rd;
-    std::mt19937 mt(rd());
-    std::normal_distribution<Element> dist{0.0};
-
     std::array<ulong, Dim> array_shape;
     // TODO: this is weird solution :P
     std::copy(shape.begin(), shape.end(), array_shape.begin());
-    Tensor<Element, Dim> tensor(array_shape);
-    std::generate(tensor.begin(), tensor.end(), [&]() { return dist(mt); });
+    Tensor<Element, Dim> tensor(array_shape, uninitialized);
+    ts::normal_(tensor, Element(0), Element(1));
     return tensor;
 }
 
@@ -337,7 +382,13 @@ template <typename Element, int Dim> auto Tensor<Element, Dim>::operator==(const
 
 template <typename Element, int Dim> auto Tensor<Element, Dim>::operator+=(Tensor const &tensor) -> Tensor &
 {
-    std::transform(_begin, _end, tensor.begin(), _begin, std::plus());
+    if (is_contiguous() && tensor.is_contiguous()) {
+        std::transform(_begin, _end, tensor.begin(), _begin, std::plus());
+        return *this;
+    }
+    auto source = tensor.contiguous();
+    auto input = source.begin();
+    for_each_offset([&](size_type offset) { _begin[offset] += *input++; });
     return *this;
 }
 
@@ -358,16 +409,103 @@ auto Tensor<Element, Dim>::set_sizes(int pos, size_type first, Sizes... rest) ->
 
 template <typename Element, int Dim>
 template <typename... Indices>
-auto Tensor<Element, Dim>::get_index(int pos, size_type prev_index, size_type first, Indices... rest) const -> size_type
+auto Tensor<Element, Dim>::get_offset(int pos, size_type first, Indices... rest) const -> size_type
 {
-    size_type index = (prev_index * _dimensions[pos]) + first;
     if constexpr (sizeof...(rest) > 0) {
-        return get_index(pos + 1, index, rest...);
+        return first * _strides[pos] + get_offset(pos + 1, rest...);
     } else {
-        return index;
+        return first * _strides[pos];
+    }
+}
+
+template <typename Element, int Dim> auto Tensor<Element, Dim>::set_contiguous_strides() -> void
+{
+    size_type stride = 1;
+    for (int i = Dim - 1; i >= 0; --i) {
+        _strides[i] = stride;
+        stride *= _dimensions[i];
+    }
+}
+
+template <typename Element, int Dim> auto Tensor<Element, Dim>::is_contiguous() const -> bool
+{
+    size_type stride = 1;
+    for (int i = Dim - 1; i >= 0; --i) {
+        // stride of a dimension of size one doesn't matter
+        if (_dimensions[i] != 1 && _strides[i] != stride) {
+            return false;
+        }
+        stride *= _dimensions[i];
+    }
+    return true;
+}
+
+template <typename Element, int Dim> auto Tensor<Element, Dim>::span() const -> size_type
+{
+    if (_data_size == 0) {
+        return 0;
+    }
+    size_type last = 0;
+    for (int i = 0; i < Dim; ++i) {
+        last += (_dimensions[i] - 1) * _strides[i];
+    }
+    return last + 1;
+}
+
+template <typename Element, int Dim>
+template <typename Fn>
+auto Tensor<Element, Dim>::for_each_offset(Fn fn) const -> void
+{
+    std::array<size_type, Dim> index{};
+    size_type offset = 0;
+    for (size_type n = 0; n < _data_size; ++n) {
+        fn(offset);
+        for (int d = Dim - 1; d >= 0; --d) {
+            offset += _strides[d];
+            if (++index[d] < _dimensions[d]) {
+                break;
+            }
+            offset -= _strides[d] * _dimensions[d];
+            index[d] = 0;
+        }
     }
 }
 
+template <typename Element, int Dim> auto Tensor<Element, Dim>::contiguous() const -> Tensor
+{
+    if (is_contiguous()) {
+        return *this;
+    }
+    Tensor tensor(_dimensions, uninitialized);
+    auto output = tensor.begin();
+    for_each_offset([&](size_type offset) { *output++ = _begin[offset]; });
+    return tensor;
+}
+
+template <typename Element, int Dim> auto Tensor<Element, Dim>::assign(Tensor const &tensor) const -> void
+{
+    assert(_dimensions == tensor.shape());
+    auto source = tensor.contiguous();
+    if (is_contiguous()) {
+        std::copy(source.begin(), source.end(), _begin);
+        return;
+    }
+    auto input = source.begin();
+    for_each_offset([&](size_type offset) { _begin[offset] = *input++; });
+}
+
+template <typename Element, int Dim>
+auto Tensor<Element, Dim>::permute(std::array<int, Dim> const &axes) const -> Tensor
+{
+    std::array<size_type, Dim> shape;
+    std::array<size_type, Dim> strides;
+    for (int i = 0; i < Dim; ++i) {
+        shape[i] = _dimensions[axes[i]];
+        strides[i] = _strides[axes[i]];
+    }
+    return Tensor(_data, shape, strides, _begin);
+}
+
 template <typename Element, int Dim> Tensor<Element, Dim>::Tensor(std::initializer_list<Tensor<Element, Dim - 1>> list)
 {
     if (list.size() == 0) {
@@ -386,10 +524,12 @@ template <typename Element, int Dim> Tensor<Element, Dim>::Tensor(std::initializ
         _data_size += tensor.data_size();
     }
 
+    set_contiguous_strides();
     _data = std::make_shared<vector_t>(_data_size);
     auto data_end = _data->begin();
     for (auto const &tensor : list) {
-        data_end = std::copy(tensor.begin(), tensor.end(), data_end);
+        auto source = tensor.contiguous();
+        data_end = std::copy(source.begin(), source.end(), data_end);
     }
     _begin = _data->begin();
     _end = data_end;
@@ -413,10 +553,12 @@ template <typename Element, int Dim> Tensor<Element, Dim>::Tensor(std::vector<Te
         _data_size += tensor.data_size();
     }
 
+    set_contiguous_strides();
     _data = std::make_shared<vector_t>(_data_size);
     auto data_end = _data->begin();
     for (auto const &tensor : list) {
-        data_end = std::copy(tensor.begin(), tensor.end(), data_end);
+        auto source = tensor.contiguous();
+        data_end = std::copy(source.begin(), source.end(), data_end);
     }
     _begin = _data->begin();
     _end = data_end;
@@ -431,6 +573,7 @@ template <typename Element, int Dim> Tensor<Element, Dim>::Tensor(std::initializ
     }
     _data_size = list.size();
     _dimensions[0] = _data_size;
+    _strides[0] = 1;
     _data = std::make_shared<vector_t>(list.begin(), list.end());
     _begin = _data->begin();
     _end = _data->end();
@@ -441,14 +584,31 @@ Tensor<Element, Dim>::Tensor(data_t data, std::array<size_type, Dim> shape, iter
 {
     _data_size = std::reduce(shape.begin(), shape.end(), 1, std::multiplies());
     _dimensions = shape;
+    set_contiguous_strides();
     _data = data;
     _begin = begin;
     _end = end;
 }
 
+template <typename Element, int Dim>
+Tensor<Element, Dim>::Tensor(data_t data, std::array<size_type, Dim> shape, std::array<size_type, Dim> strides,
+                             iterator begin)
+{
+    _data_size = std::reduce(shape.begin(), shape.end(), 1, std::multiplies());
+    _dimensions = shape;
+    _strides = strides;
+    _data = data;
+    _begin = begin;
+    _end = _begin + span();
+}
+
 template <typename Element, int Dim> auto Tensor<Element, Dim>::operator-() -> Tensor &
 {
-    std::transform(_begin, _end, _begin, [](Element const &e) { return -e; });
+    if (is_contiguous()) {
+        std::transform(_begin, _end, _begin, [](Element const &e) { return -e; });
+    } else {
+        for_each_offset([&](size_type offset) { _begin[offset] = -_begin[offset]; });
+    }
     return *this;
 }
 
@@ -459,18 +619,24 @@ template <typename Element, int Dim> Tensor<Element, Dim>::Tensor(const Tensor &
     _data_size = tensor.data_size();
     _dimensions = tensor.shape();
     if (deep_copy) {
-        _data = std::make_shared<vector_t>(*tensor.data());
+        // copy only what this tensor sees, it might be a view on a bigger buffer
+        auto source = tensor.contiguous();
+        set_contiguous_strides();
+        _data = std::make_shared<vector_t>(_data_size);
+        _begin = _data->begin();
+        _end = std::copy(source.begin(), source.end(), _begin);
     } else {
+        _strides = tensor._strides;
         _data = tensor.data();
+        _begin = tensor._begin;
+        _end = tensor._end;
     }
-    _begin = _data->begin();
-    _end = _data->end();
 }
 
 template <typename Element, int Dim>
 Tensor<Element, Dim>::Tensor(Tensor &&tensor) noexcept
-    : _data_size(tensor._data_size), _dimensions(std::move(tensor._dimensions)), _data(std::move(tensor._data)),
-      _begin(std::move(tensor._begin)), _end(std::move(tensor._end))
+    : _data_size(tensor._data_size), _dimensions(std::move(tensor._dimensions)), _strides(tensor._strides),
+      _data(std::move(tensor._data)), _begin(std::move(tensor._begin)), _end(std::move(tensor._end))
 {
     tensor._data_size = 0;
 }
@@ -484,6 +650,7 @@ template <typename Element, int Dim> auto Tensor<Element, Dim>::operator=(Tensor
     _begin = std::move(tensor._begin);
     _end = std::move(tensor._end);
     _dimensions = std::move(tensor._dimensions);
+    _strides = tensor._strides;
     _data_size = tensor._data_size;
 
     // Invalidate moved object
@@ -499,7 +666,12 @@ auto Tensor<Element, Dim>::operator=(std::initializer_list<Element> list) -> Ten
         std::cerr << "operator=(std::initializer_list)" << std::endl;
         exit(-1);
     }
-    std::copy(list.begin(), list.end(), _begin);
+    if (is_contiguous()) {
+        std::copy(list.begin(), list.end(), _begin);
+    } else {
+        auto input = list.begin();
+        for_each_offset([&](size_type offset) { _begin[offset] = *input++; });
+    }
     return *this;
 }
 
@@ -7,6 +7,10 @@ using size_type = unsigned long int;
 template <typename Element, int Dim> class Tensor;
 template <typename Element> class DataHolder;
 
+// 16 bit floating point storage types, see half.hpp
+struct bf16;
+struct fp16;
+
 // Convenient typedefs
 template <typename Element> using Matrix = Tensor<Element, 2>;
 using MatrixF = Matrix<float>;
@@ -1,4 +1,5 @@
 #pragma once
 
+#include "expression.hpp"
 #include "ops.hpp"
 #include "tensor.hpp"
\ No newline at end of file
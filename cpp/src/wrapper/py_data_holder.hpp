@@ -5,7 +5,7 @@
 class PyDataHolderFloat : public ts::DataHolder<float>{
   public:
     using Element = float;
-    using vector_t = std::vector<Element>;
+    using vector_t = ts::DataHolder<float>::vector_t;
     using data_ptr_t = std::shared_ptr<vector_t>;
     using iterator = typename vector_t::iterator;
 
@@ -23,7 +23,7 @@ class PyDataHolderFloat : public ts::DataHolder<float>{
 class PyDataHolderInt : public ts::DataHolder<int>{
   public:
     using Element = int;
-    using vector_t = std::vector<Element>;
+    using vector_t = ts::DataHolder<int>::vector_t;
     using data_ptr_t = std::shared_ptr<vector_t>;
     using iterator = typename vector_t::iterator;
 
@@ -1,6 +1,10 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
 #include <tensor/nn/activations.hpp>
 #include <tensor/nn/cross_entropy_loss.hpp>
 #include <tensor/nn/layer/conv_2d.hpp>
@@ -12,6 +16,7 @@
 #include <tensor/nn/optimizer/rmsprop.hpp>
 #include <tensor/nn/optimizer/sgd.hpp>
 #include <tensor/nn/softmax.hpp>
+#include <tensor/storage.hpp>
 #include <tensor/tensor.hpp>
 
 #include "py_data_holder.hpp"
@@ -25,22 +30,64 @@ namespace py = pybind11;
 
 using size_type = ts::size_type;
 
+// Tensor sharing memory with a Python buffer (e.g. a NumPy array), the buffer is kept alive until the last tensor
+// using it is gone. Only writable C-contiguous buffers are shared, the rest (e.g. a transposed array) gets copied in
+// the row-major order, since plenty of the nn code walks tensors with raw pointers.
+template <typename Element, int Dim> auto from_buffer(py::buffer const &b) -> ts::Tensor<Element, Dim>
+{
+    auto info = std::make_unique<py::buffer_info>(b.request());
+    if (info->format != py::format_descriptor<Element>::format() || info->ndim != Dim)
+        throw std::runtime_error("Incompatible buffer format!");
+
+    std::array<size_type, Dim> shape{};
+    std::array<size_type, Dim> strides{};
+    size_type size = 1;
+    bool borrow = !info->readonly && reinterpret_cast<std::uintptr_t>(info->ptr) % alignof(Element) == 0;
+    for (int i = Dim - 1; i >= 0; --i) {
+        shape[i] = static_cast<size_type>(info->shape[i]);
+        strides[i] = size;
+        // the stride of a dimension of size 1 doesn't matter
+        borrow = borrow && (shape[i] == 1 || info->strides[i] == static_cast<py::ssize_t>(size * sizeof(Element)));
+        size *= shape[i];
+    }
+
+    if (info->size == 0) {
+        return ts::Tensor<Element, Dim>(shape);
+    }
+
+    if (!borrow) {
+        ts::Tensor<Element, Dim> tensor(shape, ts::uninitialized);
+        Element *output = tensor.raw_data_mutable();
+        auto const *input = static_cast<char const *>(info->ptr);
+        for (size_type i = 0; i < tensor.data_size(); ++i) {
+            py::ssize_t offset = 0;
+            size_type rest = i;
+            for (int dim = Dim - 1; dim >= 0; --dim) {
+                offset += static_cast<py::ssize_t>(rest % shape[dim]) * info->strides[dim];
+                rest /= shape[dim];
+            }
+            std::memcpy(output + i, input + offset, sizeof(Element));
+        }
+        return tensor;
+    }
+
+    auto *data = static_cast<Element *>(info->ptr);
+    auto *owner = info.release();
+    auto storage = ts::detail::external_data(data, size, [owner]() {
+        // the last tensor may go away on a thread which doesn't hold the GIL
+        py::gil_scoped_acquire gil;
+        delete owner;
+    });
+    return ts::Tensor<Element, Dim>(storage, shape, strides, storage->begin());
+}
+
 template <typename Element> auto wrap_tensor4D(pybind11::module &m, char const *class_name)
 {
     py::class_<ts::Tensor<Element, 4>, ts::DataHolder<Element>>(m, class_name, py::buffer_protocol())
         .def(py::init<size_type, size_type, size_type, size_type>())
 
-        // Construct from a buffer
-        .def(py::init([](py::buffer const b) {
-            py::buffer_info info = b.request();
-            if (info.format != py::format_descriptor<Element>::format() || info.ndim != 4)
-                throw std::runtime_error("Incompatible buffer format!");
-
-            auto v = new ts::Tensor<Element, 4>(info.shape[0], info.shape[1], info.shape[2], info.shape[3]);
-            memcpy(v->data()->data(), info.ptr,
-                   sizeof(Element) * (size_t)(v->shape(0) * v->shape(1) * v->shape(2) * v->shape(3)));
-            return v;
-        }))
+        // Construct from a buffer, without copying it
+        .def(py::init([](py::buffer const b) { return new ts::Tensor<Element, 4>(from_buffer<Element, 4>(b)); }))
 
         .def("shape", [](ts::Tensor<Element, 4> const &t) -> std::array<size_type, 4> { return t.shape(); })
 
@@ -70,12 +117,12 @@ template <typename Element> auto wrap_tensor4D(pybind11::module &m, char const *
 
         // Provide buffer access
         .def_buffer([](ts::Tensor<Element, 4> &t) -> py::buffer_info {
-            return py::buffer_info(t.data()->data(),                                 // Pointer to buffer
+            auto strides = t.strides();
+            return py::buffer_info(t.raw_data_mutable(),                             // Pointer to buffer
                                    {t.shape(0), t.shape(1), t.shape(2), t.shape(3)}, // Buffer dimensions
-                                   {sizeof(Element) * size_t(t.shape(1)) * size_t(t.shape(2)) *
-                                        size_t(t.shape(3)), // Strides (in bytes) for each index
-                                    sizeof(Element) * size_t(t.shape(2)) * size_t(t.shape(3)),
-                                    sizeof(Element) * size_t(t.shape(3)), sizeof(Element)});
+                                   {sizeof(Element) * strides[0], // Strides (in bytes) for each index
+                                    sizeof(Element) * strides[1], sizeof(Element) * strides[2],
+                                    sizeof(Element) * strides[3]});
         });
 }
 
@@ -84,16 +131,8 @@ template <typename Element> auto wrap_tensor3D(pybind11::module &m, char const *
     py::class_<ts::Tensor<Element, 3>, ts::DataHolder<Element>>(m, class_name, py::buffer_protocol())
         .def(py::init<size_type, size_type, size_type>())
 
-        // Construct from a buffer
-        .def(py::init([](py::buffer const b) {
-            py::buffer_info info = b.request();
-            if (info.format != py::format_descriptor<Element>::format() || info.ndim != 3)
-                throw std::runtime_error("Incompatible buffer format!");
-
-            auto v = new ts::Tensor<Element, 3>(info.shape[0], info.shape[1], info.shape[2]);
-            memcpy(v->data()->data(), info.ptr, sizeof(Element) * (size_t)(v->shape(0) * v->shape(1) * v->shape(2)));
-            return v;
-        }))
+        // Construct from a buffer, without copying it
+        .def(py::init([](py::buffer const b) { return new ts::Tensor<Element, 3>(from_buffer<Element, 3>(b)); }))
 
         .def("shape", [](ts::Tensor<Element, 3> const &t) -> std::array<size_type, 3> { return t.shape(); })
 
@@ -123,11 +162,11 @@ template <typename Element> auto wrap_tensor3D(pybind11::module &m, char const *
 
         // Provide buffer access
         .def_buffer([](ts::Tensor<Element, 3> &t) -> py::buffer_info {
-            return py::buffer_info(
-                t.data()->data(),                                           // Pointer to buffer
-                {t.shape(0), t.shape(1), t.shape(2)},                       // Buffer dimensions
-                {sizeof(Element) * size_t(t.shape(1)) * size_t(t.shape(2)), // Strides (in bytes) for each index
-                 sizeof(Element) * size_t(t.shape(2)), sizeof(Element)});
+            auto strides = t.strides();
+            return py::buffer_info(t.raw_data_mutable(),                 // Pointer to buffer
+                                   {t.shape(0), t.shape(1), t.shape(2)}, // Buffer dimensions
+                                   {sizeof(Element) * strides[0],        // Strides (in bytes) for each index
+                                    sizeof(Element) * strides[1], sizeof(Element) * strides[2]});
         });
 }
 
@@ -136,16 +175,8 @@ template <typename Element> auto wrap_tensor2D(pybind11::module &m, char const *
     py::class_<ts::Tensor<Element, 2>, ts::DataHolder<Element>>(m, class_name, py::buffer_protocol())
         .def(py::init<size_type, size_type>())
 
-        // Construct from a buffer
-        .def(py::init([](py::buffer const b) {
-            py::buffer_info info = b.request();
-            if (info.format != py::format_descriptor<Element>::format() || info.ndim != 2)
-                throw std::runtime_error("Incompatible buffer format!");
-
-            auto v = new ts::Tensor<Element, 2>(info.shape[0], info.shape[1]);
-            memcpy(v->data()->data(), info.ptr, sizeof(Element) * (size_t)(v->shape(0) * v->shape(1)));
-            return v;
-        }))
+        // Construct from a buffer, without copying it
+        .def(py::init([](py::buffer const b) { return new ts::Tensor<Element, 2>(from_buffer<Element, 2>(b)); }))
 
         .def("shape", [](ts::Tensor<Element, 2> const &t) -> std::array<size_type, 2> { return t.shape(); })
 
@@ -173,10 +204,11 @@ template <typename Element> auto wrap_tensor2D(pybind11::module &m, char const *
 
         // Provide buffer access
         .def_buffer([](ts::Tensor<Element, 2> &t) -> py::buffer_info {
-            return py::buffer_info(t.data()->data(),                      /* Pointer to buffer */
-                                   {t.shape(0), t.shape(1)},              /* Buffer dimensions */
-                                   {sizeof(Element) * size_t(t.shape(1)), /* Strides (in bytes) for each index */
-                                    sizeof(Element)});
+            auto strides = t.strides();
+            return py::buffer_info(t.raw_data_mutable(),           /* Pointer to buffer */
+                                   {t.shape(0), t.shape(1)},       /* Buffer dimensions */
+                                   {sizeof(Element) * strides[0], /* Strides (in bytes) for each index */
+                                    sizeof(Element) * strides[1]});
         });
 }
 
@@ -186,16 +218,8 @@ template <typename Element> auto wrap_tensor1D(pybind11::module &m, char const *
     py::class_<ts::Tensor<Element, 1>, ts::DataHolder<Element>>(m, class_name, py::buffer_protocol())
         .def(py::init<size_type>())
 
-        // Construct from a buffer
-        .def(py::init([](py::buffer const b) {
-            py::buffer_info info = b.request();
-            if (info.format != py::format_descriptor<Element>::format() || info.ndim != 1)
-                throw std::runtime_error("Incompatible buffer format!");
-
-            auto v = new ts::Tensor<Element, 1>(info.shape[0]);
-            memcpy(v->data()->data(), info.ptr, sizeof(Element) * (size_t)(v->shape(0)));
-            return v;
-        }))
+        // Construct from a buffer, without copying it
+        .def(py::init([](py::buffer const b) { return new ts::Tensor<Element, 1>(from_buffer<Element, 1>(b)); }))
 
         .def("shape", [](ts::Tensor<Element, 1> const &t) -> std::array<size_type, 1> { return t.shape(); })
 
@@ -223,8 +247,8 @@ template <typename Element> auto wrap_tensor1D(pybind11::module &m, char const *
 
         // Provide buffer access
         .def_buffer([](ts::Tensor<Element, 1> &t) -> py::buffer_info {
-            return py::buffer_info(t.data()->data(), sizeof(Element), py::format_descriptor<Element>::format(), 1,
-                                   {t.shape(0)}, {sizeof(Element)});
+            return py::buffer_info(t.raw_data_mutable(), sizeof(Element), py::format_descriptor<Element>::format(), 1,
+                                   {t.shape(0)}, {sizeof(Element) * t.strides()[0]});
         });
 }
 
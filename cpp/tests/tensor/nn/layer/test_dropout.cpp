@@ -5,18 +5,25 @@
 TEST_CASE("dropout")
 {
     float keep_probability = 0.5;
-    auto dropout = ts::Dropout(keep_probability);
+    ts::Generator generator(42);
+    auto dropout = ts::Dropout(keep_probability, generator);
 
-    ts::MatrixF input {
-        {10, 10, 10},
-        {20, 20, 20}
-    };
+    ts::MatrixF input(32, 64);
+    ts::fill_(input, 10.0f);
     auto result = dropout.forward(input);
 
-    ts::MatrixF expected {
-        {20, 0, 20},
-        {0, 40, 0}
-    };
-    REQUIRE(result == expected);
+    ts::size_type kept = 0;
+    for (auto e : result) {
+        REQUIRE((e == 0.0f || e == 20.0f));
+        kept += e != 0.0f;
+    }
+    REQUIRE(kept > input.data_size() / 4);
+    REQUIRE(kept < input.data_size() * 3 / 4);
 
+    ts::MatrixF d_output(32, 64);
+    ts::fill_(d_output, 1.0f);
+    REQUIRE(dropout.backward(d_output) == ts::multiply(result, 0.1f));
+
+    // every forward draws a new mask
+    REQUIRE_FALSE(dropout.forward(input) == result);
 }
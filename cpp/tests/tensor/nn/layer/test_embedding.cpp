@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <tensor/nn/layer/embedding.hpp>
+
+using namespace ts;
+
+TEST_CASE("Embedding: forward gathers rows, backward adds up the touched ones")
+{
+    auto layer = Embedding::create(10, 33);
+    VectorI indices = {3, 7, 3, 0, 9, 3};
+    MatrixF one_hot(6, 10);
+    for (int i = 0; i < 6; ++i) {
+        one_hot.at({i, indices.at(i)}) = 1.0f;
+    }
+
+    auto output = layer.forward(indices);
+    REQUIRE(output == ts::dot(one_hot, layer.weight().tensor()));
+
+    auto d_output = Tensor<float, 2>::randn({6, 33});
+    layer.backward(d_output);
+    auto expected = ts::dot(one_hot, d_output, true);
+    auto const &grad = layer.weight().grad();
+    for (int r = 0; r < 10; ++r) {
+        for (int j = 0; j < 33; ++j) {
+            REQUIRE(grad(r, j) == Approx(expected(r, j)).margin(1e-6));
+        }
+    }
+    // rows nobody looked up stay untouched
+    for (int j = 0; j < 33; ++j) {
+        REQUIRE(grad(5, j) == 0.0f);
+    }
+}
+
+TEST_CASE("Embedding: lookup doesn't change what backward uses")
+{
+    auto layer = Embedding::create(10, 4);
+    auto output = layer.forward(VectorI{3, 7});
+    REQUIRE(layer.lookup(VectorI{3, 7}) == output);
+
+    layer.lookup(VectorI{1, 2});
+    layer.backward(MatrixF::randn({2, 4}));
+    auto const &grad = layer.weight().grad();
+    for (int j = 0; j < 4; ++j) {
+        REQUIRE(grad(1, j) == 0.0f);
+        REQUIRE(grad(2, j) == 0.0f);
+        REQUIRE(grad(3, j) != 0.0f);
+    }
+}
+
+TEST_CASE("Embedding: half precision output")
+{
+    auto layer = Embedding::create(4, 8);
+    layer.set_precision(Precision::BF16);
+    auto output = layer(VectorI{2, 1});
+    REQUIRE(output == round_to(output, Precision::BF16));
+}
+
+TEST_CASE("Embedding: row-sparse gradient")
+{
+    auto layer = Embedding::create(10, 33);
+    layer.weight().set_sparse_grad(true);
+    VectorI indices = {3, 7, 3, 0};
+    layer.forward(indices);
+    auto d_output = Tensor<float, 2>::randn({4, 33});
+    layer.backward(d_output);
+
+    auto *sparse = layer.weight().sparse_grad();
+    REQUIRE(sparse->indices() == std::vector<size_type>{3, 7, 3, 0});
+    sparse->coalesce();
+    REQUIRE(sparse->indices() == std::vector<size_type>{0, 3, 7});
+    MatrixF dense(10, 33);
+    sparse->add_to(dense.raw_data_mutable());
+    for (int j = 0; j < 33; ++j) {
+        REQUIRE(dense(3, j) == Approx(d_output(0, j) + d_output(2, j)));
+        REQUIRE(dense(0, j) == d_output(3, j));
+    }
+    // the dense gradient isn't used
+    REQUIRE(layer.weight().grad() == MatrixF(10, 33));
+}
+
+TEST_CASE("Embedding: an index out of range exits")
+{
+    auto layer = Embedding::create(10, 4);
+    for (int index : {10, -1}) {
+        // the check runs before any work is handed to the thread pool, so a forked child can run it
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::freopen("/dev/null", "w", stderr);
+            layer.forward(VectorI{3, index});
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) != 0);
+    }
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 
 #include <tensor/nn/layer/feed_forward.hpp>
+#include <tensor/nn/layer/feed_forward_half.hpp>
 
 using namespace ts;
 
@@ -25,3 +26,27 @@ TEST_CASE("FeedForward: forward, backward")
         REQUIRE(d_y.shape() == expected_shape);
     }
 }
+
+TEST_CASE("FeedForward: half precision inference copy")
+{
+    auto layer = FeedForward::create(16, 8, Activation::RELU);
+    MatrixF input(4, 16);
+    for (size_type i = 0; i < input.data_size(); ++i) {
+        input.at(i) = static_cast<float>(i % 7) - 3.0f;
+    }
+    auto expected = layer(input);
+
+    FeedForwardHalf<bf16> half(layer);
+    REQUIRE(half.weight().cast<float>() == layer.weight().tensor().cast<bf16>().cast<float>());
+    auto y = half(input);
+    REQUIRE(y.shape() == expected.shape());
+    for (size_type i = 0; i < y.data_size(); ++i) {
+        REQUIRE(y.at(i) == Approx(expected.at(i)).margin(0.05));
+    }
+
+    FeedForwardHalf<fp16> fp16_layer(layer);
+    Matrix<fp16> y_half = fp16_layer.forward(input.cast<fp16>());
+    for (size_type i = 0; i < y_half.data_size(); ++i) {
+        REQUIRE(float(y_half.at(i)) == Approx(expected.at(i)).margin(0.01));
+    }
+}
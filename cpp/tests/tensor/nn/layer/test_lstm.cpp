@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+
+#include <tensor/nn/layer/lstm.hpp>
+#include <tensor/nn/layer/lstm_cell.hpp>
+
+using namespace ts;
+
+namespace {
+
+auto as_matrix(GradHolder<float> &holder, size_type rows, size_type columns, bool grad) -> MatrixF
+{
+    auto &data = grad ? holder.grad() : holder.tensor();
+    MatrixF matrix(rows, columns);
+    std::copy(data.begin(), data.end(), matrix.begin());
+    return matrix;
+}
+
+} // namespace
+
+TEST_CASE("LSTM: packed time-batched engine matches LSTMCell")
+{
+    int vocab_size = 7;
+    int hidden = 6;
+    int embedding = 5;
+    int concat = embedding + hidden;
+    std::vector<int> inputs{1, 4, 2, 6, 3, 0};
+    std::vector<int> targets{4, 2, 6, 3, 0, 5};
+    auto steps = static_cast<int>(inputs.size());
+
+    auto lstm = LSTM(vocab_size, steps, hidden, embedding);
+    auto previous_state = Tensor<float, 2>::randn({1, hidden});
+    auto previous_memory = Tensor<float, 2>::randn({1, hidden});
+    float loss = lstm.forward(inputs, targets, previous_state, previous_memory);
+    lstm.backward();
+
+    auto &params = lstm.parameters();
+    auto weight = as_matrix(params[0], concat, 4 * hidden, false);
+    auto bias = as_matrix(params[1], 1, 4 * hidden, false);
+    auto w_embedding = as_matrix(params[2], vocab_size, embedding, false);
+    auto w_output = as_matrix(params[3], hidden, vocab_size, false);
+    auto d_weight = as_matrix(params[0], concat, 4 * hidden, true);
+    auto d_bias = as_matrix(params[1], 1, 4 * hidden, true);
+
+    // gates are packed as forget, input, output, candidate
+    auto gate = [&](MatrixF const &m, int g) { return ts::slice(m, g * hidden, (g + 1) * hidden, 1); };
+    auto bias_gate = [&](int g) { return gate(bias, g).reshape<1>({static_cast<size_type>(hidden)}).clone(); };
+    LSTMCell::Parameters p{Variable<float, 2>::create(gate(weight, 0)), Variable<float, 2>::create(gate(weight, 1)),
+                           Variable<float, 2>::create(gate(weight, 2)), Variable<float, 2>::create(gate(weight, 3)),
+                           Variable<float, 1>::create(bias_gate(0)),    Variable<float, 1>::create(bias_gate(1)),
+                           Variable<float, 1>::create(bias_gate(2)),    Variable<float, 1>::create(bias_gate(3))};
+    std::vector<LSTMCell> cells(steps, LSTMCell(p));
+
+    float expected_loss = 0.0f;
+    auto h = previous_state;
+    auto c = previous_memory;
+    for (int t = 0; t < steps; ++t) {
+        MatrixF one_hot(1, vocab_size);
+        one_hot.at({0, inputs[t]}) = 1;
+        cells[t].forward(ts::dot(one_hot, w_embedding), h, c);
+        expected_loss += cells[t].loss().forward(ts::dot(cells[t].state(), w_output), {targets[t]});
+        h = cells[t].state();
+        c = cells[t].memory();
+    }
+    REQUIRE(loss == Approx(expected_loss).epsilon(1e-4));
+    REQUIRE(lstm.last_state().shape() == h.shape());
+    for (int j = 0; j < hidden; ++j) {
+        REQUIRE(lstm.last_state()(0, j) == Approx(h(0, j)).margin(1e-5));
+        REQUIRE(lstm.last_memory()(0, j) == Approx(c(0, j)).margin(1e-5));
+    }
+
+    MatrixF d_h(1, hidden);
+    MatrixF d_c(1, hidden);
+    for (int t = steps - 1; t >= 0; --t) {
+        auto d_state = ts::dot(cells[t].loss().backward(), w_output, false, true);
+        d_state += d_h;
+        auto [next_d_h, next_d_c, d_x] = cells[t].backward(d_state, d_c);
+        d_h = next_d_h;
+        d_c = next_d_c;
+    }
+    std::vector<Variable<float, 2> *> weights{&p.wxf, &p.wxi, &p.wxo, &p.wxc};
+    std::vector<Variable<float, 1> *> biases{&p.bf, &p.bi, &p.bo, &p.bc};
+    for (int g = 0; g < 4; ++g) {
+        auto expected = weights[g]->grad();
+        auto result = gate(d_weight, g);
+        for (int r = 0; r < concat; ++r) {
+            for (int j = 0; j < hidden; ++j) {
+                REQUIRE(result(r, j) == Approx(expected(r, j)).margin(1e-5));
+            }
+        }
+        for (int j = 0; j < hidden; ++j) {
+            REQUIRE(d_bias(0, g * hidden + j) == Approx(biases[g]->grad()(j)).margin(1e-5));
+        }
+    }
+}
+
+TEST_CASE("LSTM: sampling")
+{
+    auto lstm = LSTM(9, 4, 8, 8);
+    auto indices = lstm.sample(3, MatrixF(1, 8), MatrixF(1, 8), 12);
+    REQUIRE(indices.size() == 12);
+    REQUIRE(indices[0] == 3);
+    for (int index : indices) {
+        REQUIRE((index >= 0 && index < 9));
+    }
+}
+
+TEST_CASE("LSTM: sampling between forward and backward keeps the gradients")
+{
+    std::vector<int> inputs{1, 4, 2, 6};
+    std::vector<int> targets{4, 2, 6, 3};
+    auto lstm = LSTM(7, 4, 6, 5);
+    MatrixF state(1, 6);
+    MatrixF memory(1, 6);
+
+    lstm.forward(inputs, targets, state, memory);
+    lstm.backward();
+    std::vector<std::vector<float>> expected;
+    for (GradHolder<float> &param : lstm.parameters()) {
+        expected.emplace_back(param.grad().begin(), param.grad().end());
+        std::fill(param.grad().begin(), param.grad().end(), 0.0f);
+    }
+
+    lstm.forward(inputs, targets, state, memory);
+    lstm.sample(3, state, memory, 5);
+    lstm.backward();
+    auto &params = lstm.parameters();
+    for (size_t i = 0; i < params.size(); ++i) {
+        auto &grad = params[i].get().grad();
+        REQUIRE(std::vector<float>(grad.begin(), grad.end()) == expected[i]);
+    }
+}
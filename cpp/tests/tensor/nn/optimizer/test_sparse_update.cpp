@@ -0,0 +1,135 @@
+#include <catch2/catch.hpp>
+
+#include <functional>
+#include <memory>
+
+#include <tensor/nn/optimizer/adagrad.hpp>
+#include <tensor/nn/optimizer/adam.hpp>
+#include <tensor/nn/optimizer/rmsprop.hpp>
+#include <tensor/nn/optimizer/sgd.hpp>
+
+#include "../../test_helpers.hpp"
+
+using namespace ts;
+using namespace ts::test;
+
+namespace {
+
+using Params = std::vector<std::reference_wrapper<GradHolder<float>>>;
+
+auto variable(MatrixF const &weight) -> Variable<float, 2>
+{
+    return Variable<float, 2>(std::make_unique<MatrixF>(weight.clone()),
+                              std::make_unique<MatrixF>(MatrixF(weight.shape())), "Variable");
+}
+
+auto row(MatrixF const &m, int r) -> MatrixF { return ts::slice(m, r, r + 1, 0); }
+
+// gradient of `rows`, to both the dense and the row-sparse variable
+auto set_gradient(Variable<float, 2> &dense, Variable<float, 2> &sparse, std::vector<int> const &rows,
+                  MatrixF const &values) -> void
+{
+    for (size_t i = 0; i < rows.size(); ++i) {
+        sparse.sparse_grad()->add(rows[i], values.raw_data() + i * values.shape(1));
+        for (int j = 0; j < values.shape(1); ++j) {
+            dense.grad()(rows[i], j) += values(i, j);
+        }
+    }
+}
+
+template <typename Optimizer> auto check(std::function<Optimizer(Params)> const &create) -> void
+{
+    auto weight = Tensor<float, 2>::randn({6, 20});
+    auto dense = variable(weight);
+    auto sparse = variable(weight);
+    sparse.set_sparse_grad(true);
+    auto dense_optimizer = create(Params{std::ref(dense)});
+    auto sparse_optimizer = create(Params{std::ref(sparse)});
+
+    // the first step of a fresh state, a zero gradient doesn't move other rows either
+    set_gradient(dense, sparse, {1, 3, 1}, Tensor<float, 2>::randn({3, 20}));
+    dense_optimizer.step();
+    sparse_optimizer.step();
+    require_close(sparse.tensor(), dense.tensor(), 1e-6);
+    auto after_first = sparse.tensor().clone();
+
+    dense_optimizer.zero_gradients();
+    sparse_optimizer.zero_gradients();
+    REQUIRE(sparse.sparse_grad()->empty());
+    set_gradient(dense, sparse, {2}, Tensor<float, 2>::randn({1, 20}));
+    dense_optimizer.step();
+    sparse_optimizer.step();
+    require_close(row(sparse.tensor(), 2), row(dense.tensor(), 2), 1e-6);
+    // lazy, the state of rows 1 and 3 isn't decayed without their gradient
+    for (int r : {0, 1, 3, 4, 5}) {
+        REQUIRE(row(sparse.tensor(), r) == row(after_first, r));
+    }
+}
+
+} // namespace
+
+TEST_CASE("sparse update: coalesce sums repeated rows, sorted or not")
+{
+    RowSparseGrad<float> grad(2);
+    std::vector<float> values{1, 2, 3, 4, 5, 6};
+    for (size_type row : {1, 1, 4}) {
+        grad.add(row, values.data() + grad.size() * 2);
+    }
+    grad.coalesce();
+    REQUIRE(grad.indices() == std::vector<size_type>{1, 4});
+    REQUIRE(std::vector<float>(grad.values(), grad.values() + 4) == std::vector<float>{4, 6, 5, 6});
+
+    grad.add(0, values.data());
+    grad.coalesce();
+    REQUIRE(grad.indices() == std::vector<size_type>{0, 1, 4});
+    REQUIRE(grad.values()[0] == 1);
+}
+
+TEST_CASE("sparse update: only the rows of the gradient")
+{
+    check<SGD<float>>([](Params p) { return SGD<float>(p, 0.1, 0.9); });
+    check<Adagrad<float>>([](Params p) { return Adagrad<float>(p, 0.1); });
+    check<RMSProp<float>>([](Params p) { return RMSProp<float>(p, 0.1); });
+    check<Adam<float>>([](Params p) { return Adam<float>(p, 0.1); });
+}
+
+TEST_CASE("sparse update: packed parameters around a sparse one")
+{
+    auto first = Tensor<float, 2>::randn({3, 5});
+    auto table = Tensor<float, 2>::randn({8, 7});
+    auto last = Tensor<float, 2>::randn({4, 3});
+    auto a = variable(first);
+    auto b = variable(table);
+    auto c = variable(last);
+    auto expected_a = variable(first);
+    auto expected_c = variable(last);
+    b.set_sparse_grad(true);
+
+    auto optimizer = Adam<float>(Params{std::ref(a), std::ref(b), std::ref(c)}, 0.1);
+    auto expected = Adam<float>(Params{std::ref(expected_a), std::ref(expected_c)}, 0.1);
+    REQUIRE(optimizer.pack());
+    for (int step = 0; step < 2; ++step) {
+        auto d_a = Tensor<float, 2>::randn({3, 5});
+        auto d_c = Tensor<float, 2>::randn({4, 3});
+        a.grad().assign(d_a);
+        c.grad().assign(d_c);
+        expected_a.grad().assign(d_a);
+        expected_c.grad().assign(d_c);
+        b.sparse_grad()->add(5, Tensor<float, 1>::randn({7}).raw_data());
+        optimizer.step();
+        expected.step();
+        optimizer.zero_gradients();
+        expected.zero_gradients();
+    }
+
+    require_close(a.tensor(), expected_a.tensor(), 1e-6);
+    require_close(c.tensor(), expected_c.tensor(), 1e-6);
+    REQUIRE(a.grad() == MatrixF(3, 5));
+    for (int r = 0; r < 8; ++r) {
+        if (r == 5) {
+            REQUIRE_FALSE(row(b.tensor(), r) == row(table, r));
+        } else {
+            REQUIRE(row(b.tensor(), r) == row(table, r));
+        }
+    }
+}
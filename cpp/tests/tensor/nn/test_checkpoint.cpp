@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include <tensor/nn/checkpoint.hpp>
+#include <tensor/nn/layer/dropout.hpp>
+#include <tensor/nn/layer/feed_forward.hpp>
+#include <tensor/nn/layer/lstm.hpp>
+#include <tensor/nn/layer/rnn.hpp>
+
+using namespace ts;
+
+namespace {
+
+auto gradients(ParameterRegistry<float> &registry) -> std::vector<std::vector<float>>
+{
+    std::vector<std::vector<float>> result;
+    for (GradHolder<float> &param : registry.parameters()) {
+        result.emplace_back(param.grad().begin(), param.grad().end());
+        std::fill(param.grad().begin(), param.grad().end(), 0.0f);
+    }
+    return result;
+}
+
+auto require_close(std::vector<std::vector<float>> const &a, std::vector<std::vector<float>> const &b) -> void
+{
+    REQUIRE(a.size() == b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        REQUIRE(a[i].size() == b[i].size());
+        for (size_t j = 0; j < a[i].size(); ++j) {
+            REQUIRE(a[i][j] == Approx(b[i][j]).margin(1e-5));
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("checkpoint: forward is rerun for all segments but the last one")
+{
+    std::vector<int> forward_steps;
+    std::vector<int> backward_steps;
+    auto forward = [&](int step, int state) {
+        forward_steps.push_back(step);
+        return state + 1;
+    };
+    auto backward = [&](int step, int d_state) {
+        backward_steps.push_back(step);
+        return d_state * 2;
+    };
+
+    Checkpoint<int> checkpoint(3);
+    REQUIRE(checkpoint.forward(8, 0, forward) == 8);
+    REQUIRE(checkpoint.backward(1, forward, backward) == 256);
+    REQUIRE(forward_steps == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 3, 4, 5, 0, 1, 2});
+    REQUIRE(backward_steps == std::vector<int>{7, 6, 5, 4, 3, 2, 1, 0});
+
+    forward_steps.clear();
+    checkpoint.set_segment_length(0);
+    checkpoint.forward(8, 0, forward);
+    checkpoint.backward(1, forward, backward);
+    REQUIRE(forward_steps.size() == 8);
+}
+
+TEST_CASE("checkpoint: saved tensors are dropped inside of segments")
+{
+    auto layer = FeedForward::create(4, 4);
+    MatrixF input = Tensor<float, 2>::randn({2, 4});
+    {
+        detail::SavingScope scope(true, nullptr);
+        layer.forward(input);
+    }
+    std::vector<detail::Saved *> saved;
+    {
+        detail::SavingScope scope(false, &saved);
+        layer.forward(input);
+    }
+    REQUIRE(saved.size() == 2);
+}
+
+TEST_CASE("checkpoint: layer stack gradients match the ones without checkpointing")
+{
+    std::vector<FeedForward> layers;
+    for (int i = 0; i < 5; ++i) {
+        layers.push_back(FeedForward::create(8, 8, Activation::TANH));
+    }
+    Generator generator(5);
+    // dropout after every other layer, its mask is drawn again when a segment is recomputed
+    std::vector<Dropout> dropouts(3, Dropout(0.7f, generator));
+    auto forward = [&](int step, MatrixF const &x) {
+        auto y = layers[step].forward(x);
+        return step % 2 == 0 ? dropouts[step / 2].forward(y) : y;
+    };
+    auto input = Tensor<float, 2>::randn({3, 8});
+    auto d_output = Tensor<float, 2>::randn({3, 8});
+
+    std::vector<std::vector<float>> expected;
+    MatrixF expected_d_input;
+    for (int segment_length : {0, 1, 2, 4}) {
+        generator.manual_seed(5);
+        Checkpoint<MatrixF> checkpoint(segment_length, generator);
+        auto output = checkpoint.forward(5, input, forward);
+        auto d_input = checkpoint.backward(d_output, forward, [&](int step, MatrixF const &d) {
+            auto d_y = step % 2 == 0 ? dropouts[step / 2].backward(d) : d;
+            return layers[step].backward(d_y);
+        });
+        std::vector<std::vector<float>> result;
+        for (auto &layer : layers) {
+            result.emplace_back(layer.weight().grad().begin(), layer.weight().grad().end());
+            std::fill(layer.weight().grad().begin(), layer.weight().grad().end(), 0.0f);
+            std::fill(layer.bias()->get().grad().begin(), layer.bias()->get().grad().end(), 0.0f);
+        }
+        if (segment_length == 0) {
+            expected = result;
+            expected_d_input = d_input.clone();
+        } else {
+            REQUIRE(result == expected);
+            REQUIRE(d_input == expected_d_input);
+        }
+    }
+}
+
+TEST_CASE("checkpoint: LSTM and RNN timesteps")
+{
+    std::vector<int> inputs{1, 4, 2, 7, 3, 0, 5, 6, 8};
+    std::vector<int> targets{4, 2, 7, 3, 0, 5, 6, 8, 1};
+
+    auto lstm = LSTM(11, 9, 12, 12);
+    MatrixF state(1, 12);
+    MatrixF memory(1, 12);
+    float loss = lstm.forward(inputs, targets, state, memory);
+    lstm.backward();
+    auto expected = gradients(lstm);
+    for (int segment_length : {1, 3, 4}) {
+        // blocks of timesteps sum up the weight gradient in a different order
+        lstm.set_checkpointing(segment_length);
+        REQUIRE(lstm.forward(inputs, targets, state, memory) == Approx(loss));
+        lstm.backward();
+        require_close(gradients(lstm), expected);
+    }
+
+    auto rnn = RNN(12, 9, 11);
+    loss = rnn.forward(inputs, targets, state);
+    rnn.backward();
+    expected = gradients(rnn);
+    rnn.set_checkpointing(3);
+    REQUIRE(rnn.forward(inputs, targets, state) == loss);
+    rnn.backward();
+    REQUIRE(gradients(rnn) == expected);
+}
@@ -55,3 +55,22 @@ TEST_CASE("_get_flatten_tile(MatrixF, ...)")
         REQUIRE(result == expected);
     }
 }
+
+TEST_CASE("_get_flatten_tile(Tensor<float, 4>, ...) of a permuted batch")
+{
+    // NHWC view of a NCHW batch, channels aren't next to each other in memory
+    auto images = ts::Tensor<float, 4>::randn({2, 3, 5, 5}).permute({0, 2, 3, 1});
+    auto images_contiguous = images.contiguous();
+    REQUIRE_FALSE(images.is_contiguous());
+
+    for (auto [row, col] : {std::pair{0, 0}, {1, 2}, {2, 2}}) {
+        REQUIRE(ts::_get_flatten_tile(images, 3, row, col) == ts::_get_flatten_tile(images_contiguous, 3, row, col));
+    }
+
+    auto image = images(1);
+    auto tile = ts::_get_tile(image, 2, 1, 3);
+    REQUIRE(tile == ts::_get_tile(images_contiguous(1), 2, 1, 3));
+
+    ts::_set_tile(image, ts::multiply(tile, 2.0f), 2, 0, 0);
+    REQUIRE(image(1, 0) == ts::multiply(images_contiguous(1)(2, 3), 2.0f));
+}
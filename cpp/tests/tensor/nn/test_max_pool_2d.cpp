@@ -142,3 +142,27 @@ TEST_CASE("max_pool_regression_test") {
     REQUIRE(d_input_hwc.shape() == ts::chw2hwc(d_input).shape());
     REQUIRE(d_input_hwc == ts::chw2hwc(d_input));
 }
+
+TEST_CASE("max_pool_2d of permuted inputs")
+{
+    // NHWC view of a NCHW batch and the other way around
+    auto input_chw = ts::Tensor<float, 4>::randn({2, 3, 6, 6});
+    auto input_hwc = input_chw.permute({0, 2, 3, 1});
+    REQUIRE_FALSE(input_hwc.is_contiguous());
+
+    auto [output_hwc, mask_hwc] = ts::max_pool_2d_hwc(input_hwc, 2, 2);
+    auto [expected_hwc, expected_mask_hwc] = ts::max_pool_2d_hwc(input_hwc.contiguous(), 2, 2);
+    REQUIRE(output_hwc == expected_hwc);
+    REQUIRE(mask_hwc == expected_mask_hwc);
+
+    auto d_output_hwc = ts::Tensor<float, 4>::randn({2, 3, 3, 3}).permute({0, 2, 3, 1});
+    REQUIRE(ts::max_pool_2d_backward_hwc(d_output_hwc, mask_hwc, 2, 2) ==
+            ts::max_pool_2d_backward_hwc(d_output_hwc.contiguous(), mask_hwc, 2, 2));
+
+    auto input = input_hwc.contiguous().permute({0, 3, 1, 2});
+    REQUIRE_FALSE(input.is_contiguous());
+    auto [output, mask] = ts::max_pool_2d(input, 2, 2, 0);
+    auto [expected, expected_mask] = ts::max_pool_2d(input_chw, 2, 2, 0);
+    REQUIRE(output == expected);
+    REQUIRE(mask == expected_mask);
+}
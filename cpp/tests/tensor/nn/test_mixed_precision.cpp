@@ -0,0 +1,133 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <tensor/nn/layer/conv_2d_im2col.hpp>
+#include <tensor/nn/layer/feed_forward.hpp>
+#include <tensor/nn/layer/lstm.hpp>
+#include <tensor/nn/loss_scaler.hpp>
+#include <tensor/nn/mixed_precision.hpp>
+#include <tensor/nn/optimizer/sgd.hpp>
+
+using namespace ts;
+
+namespace {
+
+template <int Dim> auto max_difference(Tensor<float, Dim> const &a, Tensor<float, Dim> const &b) -> float
+{
+    float difference = 0.0f;
+    for (auto it_a = a.begin(), it_b = b.begin(); it_a != a.end(); ++it_a, ++it_b) {
+        difference = std::max(difference, std::abs(*it_a - *it_b));
+    }
+    return difference;
+}
+
+} // namespace
+
+TEST_CASE("mixed precision: saved tensors")
+{
+    auto x = Tensor<float, 2>::randn({17, 9});
+    SavedTensor<2> saved;
+
+    saved.save(x, Precision::FLOAT);
+    REQUIRE(saved.load() == x);
+
+    saved.save(x, Precision::BF16);
+    REQUIRE(max_difference(saved.load(), x) < 0.04f);
+    REQUIRE(saved.load() == round_to(x, Precision::BF16));
+
+    saved.save(x, Precision::FP16);
+    REQUIRE(max_difference(saved.load(), x) < 0.005f);
+    REQUIRE(saved.load() == round_to(x, Precision::FP16));
+}
+
+TEST_CASE("mixed precision: FeedForward in half precision is close to float")
+{
+    auto layer = FeedForward::create(24, 16, Activation::RELU);
+    auto input = Tensor<float, 2>::randn({8, 24});
+    auto d_output = Tensor<float, 2>::randn({8, 16});
+
+    auto output = layer.forward(input).clone();
+    auto d_input = layer.backward(d_output).clone();
+    auto d_weight = layer.weight().grad().clone();
+
+    for (auto [precision, tolerance] : {std::pair{Precision::BF16, 0.15f}, std::pair{Precision::FP16, 0.02f}}) {
+        layer.weight().grad().assign(Tensor<float, 2>(24, 16));
+        layer.set_precision(precision);
+        REQUIRE(layer.precision() == precision);
+        auto half_output = layer.forward(input);
+        REQUIRE(half_output == round_to(half_output, precision));
+        REQUIRE(max_difference(half_output, output) < tolerance);
+        REQUIRE(max_difference(layer.backward(d_output), d_input) < tolerance);
+        REQUIRE(max_difference(layer.weight().grad(), d_weight) < 4 * tolerance);
+    }
+}
+
+TEST_CASE("mixed precision: im2col Conv2D in half precision is close to float")
+{
+    auto layer = im2col::Conv2D::create(3, 4, 3, 1, 1, 1, Activation::RELU);
+    auto input = Tensor<float, 4>::randn({2, 3, 6, 6});
+    auto d_output = Tensor<float, 4>::randn({2, 4, 6, 6});
+
+    auto output = layer.forward(input).clone();
+    auto d_input = layer.backward(d_output).clone();
+
+    layer.set_precision(Precision::FP16);
+    REQUIRE(max_difference(layer.forward(input), output) < 0.02f);
+    REQUIRE(max_difference(layer.backward(d_output), d_input) < 0.02f);
+}
+
+TEST_CASE("mixed precision: LSTM loss in half precision is close to float")
+{
+    int vocab_size = 11;
+    std::vector<int> inputs{1, 4, 2, 7, 3};
+    std::vector<int> targets{4, 2, 7, 3, 9};
+    auto lstm = LSTM(vocab_size, 5, 16, 16);
+    MatrixF state(1, 16);
+    MatrixF memory(1, 16);
+
+    float loss = lstm.forward(inputs, targets, state, memory);
+    lstm.set_precision(Precision::BF16);
+    float half_loss = lstm.forward(inputs, targets, state, memory);
+    REQUIRE(half_loss == Approx(loss).epsilon(0.02));
+    lstm.backward(1024.0f);
+}
+
+TEST_CASE("LossScaler: skips steps with overflowed gradients")
+{
+    auto weight = Variable<float, 2>::create(Tensor<float, 2>(4, 8));
+    std::vector<std::reference_wrapper<GradHolder<float>>> vars;
+    vars.emplace_back(std::ref(weight));
+    auto optimizer = SGD<float>(vars, 0.1f, 0.0f);
+    LossScaler scaler(1024.0f, 2.0f, 0.5f, 2);
+
+    weight.grad().assign(Tensor<float, 2>::randn({4, 8}));
+    weight.grad().at({1, 3}) = std::numeric_limits<float>::infinity();
+    REQUIRE_FALSE(scaler.step(optimizer));
+    REQUIRE(scaler.scale() == 512.0f);
+    REQUIRE(weight.tensor() == Tensor<float, 2>(4, 8));
+    REQUIRE(weight.grad() == Tensor<float, 2>(4, 8));
+
+    // 512 * 1 / 512 * lr, one step with finite gradients
+    std::fill(weight.grad().begin(), weight.grad().end(), 512.0f);
+    REQUIRE(scaler.step(optimizer));
+    REQUIRE(weight.tensor()(0, 0) == Approx(-0.1f));
+    REQUIRE(scaler.scale() == 512.0f);
+
+    optimizer.zero_gradients();
+    REQUIRE(scaler.step(optimizer));
+    REQUIRE(scaler.scale() == 1024.0f);
+}
+
+TEST_CASE("LossScaler: scales the gradient of the loss")
+{
+    CrossEntropyLoss loss;
+    auto logits = Tensor<float, 2>::randn({4, 5});
+    loss.forward(logits, {0, 1, 2, 3});
+    auto d_logits = loss.backward().clone();
+
+    LossScaler scaler(256.0f);
+    auto d_scaled = scaler.backward(loss);
+    REQUIRE(max_difference(d_scaled, ts::multiply(d_logits, 256.0f)) < 1e-5f);
+}
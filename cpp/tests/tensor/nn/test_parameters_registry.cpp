@@ -0,0 +1,145 @@
+#include <catch2/catch.hpp>
+
+#include <tensor/nn/optimizer/adagrad.hpp>
+#include <tensor/nn/optimizer/adam.hpp>
+#include <tensor/nn/optimizer/rmsprop.hpp>
+#include <tensor/nn/optimizer/sgd.hpp>
+
+using namespace ts;
+
+namespace {
+
+struct Model {
+    Variable<float, 2> weight{std::make_unique<MatrixF>(MatrixF::randn({7, 5})),
+                              std::make_unique<MatrixF>(MatrixF::randn({7, 5}))};
+    Variable<float, 1> bias{std::make_unique<VectorF>(VectorF::randn({5})),
+                            std::make_unique<VectorF>(VectorF::randn({5}))};
+
+    auto parameters() -> std::vector<std::reference_wrapper<GradHolder<float>>>
+    {
+        return {std::ref<GradHolder<float>>(weight), std::ref<GradHolder<float>>(bias)};
+    }
+
+    auto copy() -> Model
+    {
+        Model model;
+        model.weight.tensor().assign(weight.tensor());
+        model.weight.grad().assign(weight.grad());
+        model.bias.tensor().assign(bias.tensor());
+        model.bias.grad().assign(bias.grad());
+        return model;
+    }
+};
+
+// keeps its memory, like the holders defined in Python
+struct Pinned : Variable<float, 1> {
+    using Variable<float, 1>::Variable;
+
+    auto can_move() -> bool override { return false; }
+};
+
+template <typename Optimizer> auto check_packed_step() -> void
+{
+    Model model;
+    Model packed_model = model.copy();
+    Optimizer optimizer(model.parameters(), 0.1f);
+    Optimizer packed_optimizer(packed_model.parameters(), 0.1f);
+    REQUIRE(packed_optimizer.pack());
+
+    for (int i = 0; i < 3; ++i) {
+        optimizer.step();
+        packed_optimizer.step();
+    }
+    REQUIRE(packed_model.weight.tensor() == model.weight.tensor());
+    REQUIRE(packed_model.bias.tensor() == model.bias.tensor());
+}
+
+} // namespace
+
+TEST_CASE("ParameterRegistry: pack moves parameters into the arena")
+{
+    Model model;
+    MatrixF weight = model.weight.tensor().clone();
+    VectorF bias_grad = model.bias.grad().clone();
+    MatrixF &weight_ref = model.weight.tensor();
+
+    SGD<float> optimizer(model.parameters(), 0.1f);
+    REQUIRE_FALSE(optimizer.is_packed());
+    REQUIRE(optimizer.pack());
+    REQUIRE(optimizer.is_packed());
+
+    // values are kept, tensors are rebound in place
+    REQUIRE(model.weight.tensor() == weight);
+    REQUIRE(model.bias.grad() == bias_grad);
+    REQUIRE(&weight_ref == &model.weight.tensor());
+
+    // slots start at cache lines
+    REQUIRE(optimizer.offset(0) == 0);
+    REQUIRE(optimizer.offset(1) == 48);
+    REQUIRE(optimizer.packed_size() == 64);
+    REQUIRE(&model.weight.tensor().at(0) == optimizer.packed_weights());
+    REQUIRE(&model.bias.tensor().at(0) == optimizer.packed_weights() + 48);
+    REQUIRE(&model.bias.grad().at(0) == optimizer.packed_gradients() + 48);
+
+    optimizer.zero_gradients();
+    REQUIRE(model.weight.grad() == MatrixF(7, 5));
+    REQUIRE(model.bias.grad() == VectorF(5));
+
+    // a parameter registered later lives on its own until the next pack()
+    auto extra = Variable<float, 1>::create(3);
+    optimizer.register_parameters(extra);
+    REQUIRE_FALSE(optimizer.is_packed());
+    REQUIRE(optimizer.offset(2) == 64);
+}
+
+TEST_CASE("ParameterRegistry: parameters packed by another registry are refused")
+{
+    Model model;
+    ParameterRegistry<float> layer;
+    layer.register_parameters(model.parameters());
+    SGD<float> optimizer(model.parameters(), 0.1f);
+
+    REQUIRE(layer.pack());
+    REQUIRE_FALSE(optimizer.pack());
+    REQUIRE_FALSE(optimizer.is_packed());
+    // the first arena is still the live one
+    REQUIRE(layer.is_packed());
+    REQUIRE(&model.weight.tensor().at(0) == layer.packed_weights());
+    REQUIRE(&model.bias.grad().at(0) == layer.packed_gradients() + 48);
+
+    // packing again into a new arena of its own is fine
+    auto extra = Variable<float, 1>::create(3);
+    layer.register_parameters(extra);
+    REQUIRE(layer.pack());
+    REQUIRE(&model.weight.tensor().at(0) == layer.packed_weights());
+}
+
+TEST_CASE("ParameterRegistry: a failed pack moves nothing")
+{
+    Model model;
+    Pinned pinned{std::make_unique<VectorF>(VectorF::randn({3})), std::make_unique<VectorF>(VectorF::randn({3}))};
+    MatrixF weight = model.weight.tensor().clone();
+
+    auto params = model.parameters();
+    params.push_back(pinned);
+    SGD<float> optimizer(params, 0.1f);
+    REQUIRE_FALSE(optimizer.pack());
+    REQUIRE_FALSE(optimizer.is_packed());
+    REQUIRE(model.weight.arena() == nullptr);
+    REQUIRE(model.bias.arena() == nullptr);
+    REQUIRE(model.weight.tensor() == weight);
+
+    // a registry without the pinned parameter can still pack the rest
+    SGD<float> retry(model.parameters(), 0.1f);
+    REQUIRE(retry.pack());
+    REQUIRE(&model.weight.tensor().at(0) == retry.packed_weights());
+    REQUIRE(model.weight.tensor() == weight);
+}
+
+TEST_CASE("ParameterRegistry: optimizers step the same packed or not")
+{
+    check_packed_step<SGD<float>>();
+    check_packed_step<Adagrad<float>>();
+    check_packed_step<RMSProp<float>>();
+    check_packed_step<Adam<float>>();
+}
@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <tensor/tensor.hpp>
+
+using namespace ts;
+
+TEST_CASE("CachingResource::bucket_size")
+{
+    REQUIRE(CachingResource::bucket_size(1) == 64);
+    REQUIRE(CachingResource::bucket_size(64) == 64);
+    REQUIRE(CachingResource::bucket_size(65) == 80);
+    REQUIRE(CachingResource::bucket_size(1000) == 1024);
+    REQUIRE(CachingResource::bucket_size(1025) == 1280);
+    REQUIRE(CachingResource::bucket_size(4096) == 4096);
+}
+
+TEST_CASE("CachingResource: freed blocks are reused")
+{
+    CachingResource resource;
+    void *first = resource.allocate(1000);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(first) % MemoryResource::ALIGNMENT == 0);
+    resource.deallocate(first, 1000);
+    REQUIRE(resource.stats().bytes_cached == 1024);
+
+    void *second = resource.allocate(1010); // same bucket
+    REQUIRE(second == first);
+    REQUIRE(resource.stats().hits == 1);
+    REQUIRE(resource.stats().misses == 1);
+    REQUIRE(resource.stats().hit_rate() == 0.5);
+    REQUIRE(resource.stats().bytes_cached == 0);
+    REQUIRE(resource.stats().bytes_in_use == 1024);
+
+    resource.deallocate(second, 1010);
+    resource.release_cached();
+    REQUIRE(resource.stats().bytes_cached == 0);
+    REQUIRE(resource.stats().bytes_in_use == 0);
+}
+
+TEST_CASE("CachingResource: cache limit")
+{
+    CachingResource resource;
+    resource.set_max_cached_bytes(64);
+    void *small = resource.allocate(64);
+    void *big = resource.allocate(4096);
+    resource.deallocate(small, 64);
+    resource.deallocate(big, 4096);
+    REQUIRE(resource.stats().bytes_cached == 64);
+}
+
+TEST_CASE("Tensor: storage comes from the default resource")
+{
+    CachingResource resource;
+    MemoryResource *previous = set_default_resource(&resource);
+    {
+        MatrixF a(16, 16);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(a.data()->data()) % MemoryResource::ALIGNMENT == 0);
+        REQUIRE(std::all_of(a.begin(), a.end(), [](float e) { return e == 0.0f; }));
+    }
+    for (int i = 0; i < 10; ++i) {
+        MatrixF a(16, 16);
+        MatrixF b(16, 16);
+        auto c = ts::add(a, b);
+    }
+    set_default_resource(previous);
+
+    REQUIRE(resource.stats().bytes_in_use == 0);
+    REQUIRE(resource.stats().misses == 3);
+    REQUIRE(resource.stats().hits == 30 - 2);
+}
+
+TEST_CASE("Tensor: uninitialized constructor skips zero-filling")
+{
+    CachingResource resource;
+    MemoryResource *previous = set_default_resource(&resource);
+    {
+        VectorF a(8);
+        ts::fill_(a, 1.0f);
+    }
+    VectorF b({8}, uninitialized);
+    VectorF c(8);
+    set_default_resource(previous);
+
+    REQUIRE(b(0) == 1.0f); // same block, left untouched
+    REQUIRE(c(0) == 0.0f);
+}
@@ -0,0 +1,82 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <tensor/backend.hpp>
+#include <tensor/tensor.hpp>
+
+#include "test_helpers.hpp"
+
+using namespace ts;
+using namespace ts::test;
+
+TEST_CASE("backend: registry")
+{
+    REQUIRE(is_available(Backend::AUTO));
+    REQUIRE(is_available(Backend::NATIVE));
+    REQUIRE(std::string(backend_name(Backend::NATIVE)) == "native");
+    REQUIRE(std::string(backend_name(Backend::BLAS)) == "blas");
+#ifdef USE_BLAS
+    REQUIRE(is_available(Backend::BLAS));
+#else
+    REQUIRE_FALSE(is_available(Backend::BLAS));
+#endif
+}
+
+TEST_CASE("backend: scopes and per shape dispatch")
+{
+    Backend global = backend();
+    size_type threshold = blas_threshold();
+    {
+        BackendScope native(Backend::NATIVE);
+        REQUIRE(backend() == Backend::NATIVE);
+        REQUIRE(detail::select_backend(1000, 1000, 1000) == Backend::NATIVE);
+        {
+            BackendScope automatic(Backend::AUTO);
+            set_blas_threshold(64 * 64 * 64);
+            // small products stay native, big ones go to BLAS if there is one
+            REQUIRE(detail::select_backend(8, 8, 8) == Backend::NATIVE);
+            Backend big = is_available(Backend::BLAS) ? Backend::BLAS : Backend::NATIVE;
+            REQUIRE(detail::select_backend(64, 64, 64) == big);
+            set_blas_threshold(threshold);
+        }
+        REQUIRE(backend() == Backend::NATIVE);
+
+        // asking for a backend that isn't compiled in falls back to the native one
+        BackendScope blas(Backend::BLAS);
+        REQUIRE(detail::select_backend(1, 1, 1) == (is_available(Backend::BLAS) ? Backend::BLAS : Backend::NATIVE));
+    }
+    REQUIRE(backend() == global);
+}
+
+TEST_CASE("backend: every backend gives the same products")
+{
+    auto A = make_matrix(37, 70, 0.0f);
+    auto B = make_matrix(70, 45, 1.0f);
+    auto x = make_matrix(1, 70, 2.0f)[0];
+    auto batch = make_matrix(3 * 37, 70, 3.0f).reshape<3>({3, 37, 70});
+
+    MatrixF expected_matrix;
+    VectorF expected_vector;
+    Tensor<float, 3> expected_batch;
+    {
+        BackendScope native(Backend::NATIVE);
+        expected_matrix = ts::dot(A, B);
+        expected_vector = ts::dot(A, x);
+        expected_batch = ts::dot(batch, B);
+    }
+    for (auto backend : {Backend::AUTO, Backend::BLAS}) {
+        INFO(backend_name(backend));
+        BackendScope scope(backend);
+        auto matrix = ts::dot(A, B);
+        auto vector = ts::dot(A, x);
+        auto tensor = ts::dot(batch, B);
+        for (size_type i = 0; i < matrix.data_size(); ++i) {
+            REQUIRE(matrix.at(i) == Approx(expected_matrix.at(i)).margin(1e-4));
+        }
+        for (size_type i = 0; i < vector.data_size(); ++i) {
+            REQUIRE(vector.at(i) == Approx(expected_vector.at(i)).margin(1e-4));
+        }
+        for (size_type i = 0; i < tensor.data_size(); ++i) {
+            REQUIRE(tensor.at(i) == Approx(expected_batch.at(i)).margin(1e-4));
+        }
+    }
+}
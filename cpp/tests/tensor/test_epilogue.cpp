@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <tensor/epilogue.hpp>
+#include <tensor/tensor.hpp>
+
+#include "test_helpers.hpp"
+
+using namespace ts;
+using namespace ts::test;
+
+namespace {
+
+auto activate(Activation activation, float x) -> float
+{
+    switch (activation) {
+    case Activation::RELU:
+        return std::max(x, 0.0f);
+    case Activation::TANH:
+        return std::tanh(x);
+    default:
+        return x;
+    }
+}
+
+// dot, bias and activation one after another
+auto unfused(MatrixF const &A, MatrixF const &B, Epilogue const &epilogue) -> MatrixF
+{
+    auto C = ts::dot(A, B);
+    for (size_type i = 0; i < C.shape(0); ++i) {
+        for (size_type j = 0; j < C.shape(1); ++j) {
+            float bias = epilogue.bias ? (*epilogue.bias)(epilogue.bias_axis == 0 ? i : j) : 0.0f;
+            C(i, j) = activate(epilogue.activation, C(i, j) + bias);
+        }
+    }
+    return C;
+}
+
+} // namespace
+
+TEST_CASE("epilogue: bias and activation fused into dot")
+{
+    // several tiles, edges and blocks of k
+    for (auto [m, n, k] : {std::array<size_type, 3>{1, 37, 20}, {7, 5, 3}, {50, 70, 300}, {13, 35, 0}}) {
+        auto A = make_matrix(m, k, 0.0f);
+        auto B = make_matrix(k, n, 1.0f);
+        VectorF column_bias = make_matrix(1, n, 2.0f)[0];
+        VectorF row_bias = make_matrix(1, m, 3.0f)[0];
+
+        for (auto activation : {Activation::NONE, Activation::RELU, Activation::TANH}) {
+            INFO("m " << m << " n " << n << " k " << k);
+            for (Epilogue epilogue : {Epilogue{column_bias, 1, activation}, Epilogue{row_bias, 0, activation},
+                                      Epilogue{std::nullopt, 1, activation}}) {
+                MatrixF C(m, n);
+                ts::dot(A, B, C, epilogue);
+                require_close(C, unfused(A, B, epilogue));
+            }
+        }
+    }
+
+    // transposed operands and output
+    auto A = make_matrix(9, 11, 0.0f);
+    auto B = make_matrix(6, 9, 1.0f);
+    Epilogue epilogue{make_matrix(1, 6, 2.0f)[0], 1, Activation::RELU};
+    MatrixF C_T(6, 11);
+    auto C = ts::transpose(C_T);
+    ts::dot(A, B, C, epilogue, true, true);
+    require_close(C.contiguous(), unfused(ts::transpose(A).contiguous(), ts::transpose(B).contiguous(), epilogue));
+}
+
+TEST_CASE("epilogue: backward")
+{
+    auto output = make_matrix(6, 5, 0.0f);
+    auto d_output = make_matrix(6, 5, 1.0f);
+
+    for (auto activation : {Activation::NONE, Activation::RELU, Activation::TANH}) {
+        Epilogue epilogue{std::nullopt, 1, activation};
+        MatrixF expected(6, 5);
+        for (size_type i = 0; i < expected.data_size(); ++i) {
+            float y = output.at(i);
+            float derivative = activation == Activation::RELU ? (y > 0.0f ? 1.0f : 0.0f)
+                               : activation == Activation::TANH ? 1.0f - y * y
+                                                                : 1.0f;
+            expected.at(i) = derivative * d_output.at(i);
+        }
+
+        VectorF d_bias = {1, 1, 1, 1, 1};
+        auto d_product = ts::epilogue_backward(output, d_output, epilogue, &d_bias);
+        require_close(d_product, expected);
+        VectorF expected_bias = ts::add(ts::sum(expected, 0), VectorF{1, 1, 1, 1, 1});
+        for (size_type j = 0; j < 5; ++j) {
+            REQUIRE(d_bias(j) == Approx(expected_bias(j)));
+        }
+    }
+
+    // a bias per row of every sample
+    auto samples = make_matrix(3 * 4, 5, 0.0f).reshape<3>({3, 4, 5});
+    auto d_samples = make_matrix(3 * 4, 5, 1.0f).reshape<3>({3, 4, 5});
+    VectorF d_bias(4);
+    auto d_product = ts::epilogue_backward(samples, d_samples, {std::nullopt, 0, Activation::RELU}, &d_bias);
+    for (size_type r = 0; r < 4; ++r) {
+        float expected = 0.0f;
+        for (size_type b = 0; b < 3; ++b) {
+            for (size_type j = 0; j < 5; ++j) {
+                expected += d_product(b, r, j);
+                REQUIRE(d_product(b, r, j) == (samples(b, r, j) > 0.0f ? d_samples(b, r, j) : 0.0f));
+            }
+        }
+        REQUIRE(d_bias(r) == Approx(expected));
+    }
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+#include <tensor/expression.hpp>
+#include <tensor/ops.hpp>
+#include <tensor/tensor.hpp>
+
+using namespace ts;
+
+TEST_CASE("lazy: same results as eager ops")
+{
+    MatrixF a = {{1, 2, 3}, {4, 5, 6}};
+    MatrixF b = {{6, 5, 4}, {3, 2, 1}};
+    MatrixF c = {{1, 1, 1}, {2, 2, 2}};
+
+    MatrixF fused = lazy::add(lazy::multiply(a, b), lazy::multiply(c, a));
+    REQUIRE(fused == ts::add(ts::multiply(a, b), ts::multiply(c, a)));
+
+    MatrixF with_scalars = lazy::subtract(lazy::multiply(a, 2.0), 1);
+    REQUIRE(with_scalars == MatrixF{{1, 3, 5}, {7, 9, 11}});
+
+    // eager exp/log are vectorized approximations, a couple of ulp away from std::exp/std::log
+    MatrixF lazy_exp = lazy::exp(a);
+    MatrixF eager_exp = ts::exp(a);
+    MatrixF lazy_log = lazy::log(a);
+    MatrixF eager_log = ts::log(a);
+    for (size_type i = 0; i < a.data_size(); ++i) {
+        REQUIRE(lazy_exp.at(i) == Approx(eager_exp.at(i)));
+        REQUIRE(lazy_log.at(i) == Approx(eager_log.at(i)));
+    }
+    REQUIRE(lazy::evaluate(lazy::pow(a, 2.0f)) == ts::pow(a, 2.0f));
+    REQUIRE(lazy::evaluate(lazy::maximum(3.0f, a)) == ts::maximum(3.0f, a));
+    REQUIRE(lazy::evaluate(lazy::divide(a, c)) == MatrixF{{1, 2, 3}, {2, 2.5, 3}});
+    REQUIRE(lazy::evaluate(lazy::apply(a, [](float e) { return e * e; })) == ts::multiply(a, a));
+    REQUIRE(lazy::evaluate(lazy::apply(a, b, [](float x, float y) { return x - y; })) ==
+            MatrixF{{-5, -3, -1}, {1, 3, 5}});
+}
+
+TEST_CASE("lazy: evaluate into existing tensor")
+{
+    VectorF a = {1, 2, 3};
+    VectorF b = {1, 1, 1};
+
+    // output aliasing an operand is fine, every element depends only on the same position
+    lazy::evaluate(lazy::add(a, lazy::multiply(b, 10)), a);
+    REQUIRE(a == VectorF{11, 12, 13});
+
+    // assignment goes through the conversion
+    a = lazy::subtract(a, b);
+    REQUIRE(a == VectorF{10, 11, 12});
+
+    // views are valid operands and outputs
+    MatrixF m = {{1, 2}, {3, 4}};
+    MatrixF out(2, 2);
+    auto out_t = ts::transpose(out);
+    lazy::evaluate(lazy::multiply(ts::transpose(m), 2), out_t);
+    REQUIRE(out == MatrixF{{2, 4}, {6, 8}});
+}
+
+TEST_CASE("lazy: expression keeps operands alive")
+{
+    auto expression = [] {
+        VectorF a = {1, 2, 3};
+        return lazy::multiply(a, a);
+    }();
+    REQUIRE(lazy::evaluate(expression) == VectorF{1, 4, 9});
+}
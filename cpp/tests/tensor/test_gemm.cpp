@@ -0,0 +1,164 @@
+#include <catch2/catch.hpp>
+#include <tensor/gemm.hpp>
+#include <tensor/tensor.hpp>
+
+#include "test_helpers.hpp"
+
+using namespace ts;
+using namespace ts::test;
+
+namespace {
+
+struct ParallelSettings {
+    ParallelSettings(int threads, size_type grain) : _threads(num_threads()), _grain(grain_size())
+    {
+        set_num_threads(threads);
+        set_grain_size(grain);
+    }
+
+    ~ParallelSettings()
+    {
+        set_num_threads(_threads);
+        set_grain_size(_grain);
+    }
+
+  private:
+    int _threads;
+    size_type _grain;
+};
+
+auto as_ref(MatrixF const &matrix, bool transpose = false) -> detail::MatrixRef
+{
+    auto strides = matrix.strides();
+    return transpose ? detail::MatrixRef{matrix.raw_data(), strides[1], strides[0]}
+                     : detail::MatrixRef{matrix.raw_data(), strides[0], strides[1]};
+}
+
+// A * B + beta * C in double
+auto reference(MatrixF const &A, MatrixF const &B, float beta, MatrixF const &C) -> MatrixF
+{
+    MatrixF result(A.shape(0), B.shape(1));
+    for (size_type i = 0; i < A.shape(0); ++i) {
+        for (size_type j = 0; j < B.shape(1); ++j) {
+            double acc = beta == 0.0f ? 0.0 : beta * static_cast<double>(C(i, j));
+            for (size_type p = 0; p < A.shape(1); ++p) {
+                acc += static_cast<double>(A(i, p)) * B(p, j);
+            }
+            result(i, j) = static_cast<float>(acc);
+        }
+    }
+    return result;
+}
+
+auto check(size_type m, size_type n, size_type k, float beta) -> void
+{
+    INFO("m " << m << " n " << n << " k " << k << " beta " << beta);
+    auto A = make_matrix(m, k, 0.0f);
+    auto B = make_matrix(k, n, 1.0f);
+    auto C = make_matrix(m, n, 2.0f);
+    auto expected = reference(A, B, beta, C);
+    detail::gemm(m, n, k, as_ref(A), as_ref(B), beta, C.raw_data_mutable(), n);
+    require_close(C, expected);
+}
+
+} // namespace
+
+TEST_CASE("gemm: sizes")
+{
+    // edges of the micro-kernel tiles and of every block
+    check(1, 1, 1, 0.0f);
+    check(7, 5, 3, 0.0f);
+    check(13, 35, 300, 0.0f);
+    check(150, 17, 20, 1.0f);
+    check(20, 4100, 3, 0.5f);
+    check(5, 3, 0, 0.0f);
+    check(1, 70, 33, 0.0f);
+}
+
+TEST_CASE("gemm: transposed operands and views")
+{
+    auto A = make_matrix(40, 23, 0.0f);
+    auto B = make_matrix(31, 40, 1.0f);
+
+    // A^T * B^T through the strides
+    MatrixF C(23, 31);
+    detail::gemm(23, 31, 40, as_ref(A, true), as_ref(B, true), 0.0f, C.raw_data_mutable(), 31);
+    require_close(C, reference(A.permute({1, 0}).contiguous(), B.permute({1, 0}).contiguous(), 0.0f, C));
+
+    // a block in the middle of a bigger C
+    MatrixF big(30, 50);
+    auto A_rows = A.permute({1, 0});
+    auto B_block = B.permute({1, 0});
+    detail::gemm(23, 31, 40, as_ref(A_rows), as_ref(B_block), 0.0f, big.raw_data_mutable() + 2 * 50 + 3, 50);
+    auto expected = reference(A_rows.contiguous(), B_block.contiguous(), 0.0f, C);
+    for (size_type i = 0; i < 30; ++i) {
+        for (size_type j = 0; j < 50; ++j) {
+            bool inside = i >= 2 && i < 25 && j >= 3 && j < 34;
+            REQUIRE(big(i, j) == (inside ? Approx(expected(i - 2, j - 3)).margin(1e-4) : Approx(0.0f)));
+        }
+    }
+}
+
+TEST_CASE("gemm: gemv")
+{
+    auto A = make_matrix(37, 300, 0.0f);
+    auto x = make_matrix(300, 1, 1.0f);
+    auto expected = reference(A, x, 0.0f, x);
+
+    VectorF y(37);
+    detail::gemv(37, 300, as_ref(A), x.raw_data(), 1, y.raw_data_mutable());
+    require_close(y.reshape<2>({37, 1}), expected);
+
+    // columns of A^T are contiguous
+    auto A_T = A.permute({1, 0}).contiguous();
+    detail::gemv(37, 300, as_ref(A_T, true), x.raw_data(), 1, y.raw_data_mutable());
+    require_close(y.reshape<2>({37, 1}), expected);
+}
+
+TEST_CASE("gemm: parallel")
+{
+    auto A = make_matrix(300, 257, 0.0f);
+    auto B = make_matrix(257, 70, 1.0f);
+    auto wide = make_matrix(257, 1000, 2.0f);
+    MatrixF C(300, 70);
+    MatrixF C_wide(300, 1000);
+    detail::gemm(300, 70, 257, as_ref(A), as_ref(B), 0.0f, C.raw_data_mutable(), 70);
+    detail::gemm(300, 1000, 257, as_ref(A), as_ref(wide), 0.0f, C_wide.raw_data_mutable(), 1000);
+
+    // row blocks and groups of columns go to different threads, every element is still computed the same way
+    ParallelSettings settings(4, 64);
+    MatrixF result(300, 70);
+    MatrixF result_wide(300, 1000);
+    detail::gemm(300, 70, 257, as_ref(A), as_ref(B), 0.0f, result.raw_data_mutable(), 70);
+    detail::gemm(300, 1000, 257, as_ref(A), as_ref(wide), 0.0f, result_wide.raw_data_mutable(), 1000);
+    REQUIRE(result == C);
+    REQUIRE(result_wide == C_wide);
+}
+
+TEST_CASE("gemm: batched")
+{
+    size_type const batch = 5;
+    auto A = make_matrix(batch * 8, 9, 0.0f).reshape<3>({batch, 8, 9});
+    auto B = make_matrix(batch * 10, 6, 1.0f).reshape<3>({batch, 10, 6});
+    // every sample of A has a spare row at the end and of B a spare row at the start
+    auto sample_a = [&](size_type b) { return ts::slice(A[b], 0, 7, 0).contiguous(); };
+    auto sample_b = [&](size_type b) { return ts::slice(B[b], 1, 10, 0).contiguous(); };
+    auto ref_b = [&](size_type b) { return as_ref(ts::slice(B[b], 1, 10, 0)); };
+
+    Tensor<float, 3> C(batch, 7, 6);
+    detail::gemm_batched(batch, 7, 6, 9, as_ref(A[0]), 8 * 9, ref_b(0), 10 * 6, 0.0f, C.raw_data_mutable(), 6, 7 * 6);
+    for (size_type b = 0; b < batch; ++b) {
+        require_close(C[b], reference(sample_a(b), sample_b(b), 0.0f, C[b]));
+    }
+
+    // B shared by the samples, with the spare rows of A and with samples of A stacked right after each other
+    auto stacked = A.reshape<2>({batch * 8, 9});
+    detail::gemm_batched(batch, 7, 6, 9, as_ref(A[0]), 8 * 9, ref_b(2), 0, 0.0f, C.raw_data_mutable(), 6, 7 * 6);
+    for (size_type b = 0; b < batch; ++b) {
+        require_close(C[b], reference(sample_a(b), sample_b(2), 0.0f, C[b]));
+    }
+    Tensor<float, 3> C_stacked(batch, 8, 6);
+    detail::gemm_batched(batch, 8, 6, 9, as_ref(stacked), 8 * 9, ref_b(2), 0, 1.0f, C_stacked.raw_data_mutable(), 6,
+                         8 * 6);
+    require_close(C_stacked.reshape<2>({batch * 8, 6}), reference(stacked, sample_b(2), 0.0f, stacked));
+}
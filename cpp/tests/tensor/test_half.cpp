@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <tensor/simd.hpp>
+#include <tensor/tensor.hpp>
+#include <vector>
+
+#include "test_helpers.hpp"
+
+using namespace ts;
+using namespace ts::test;
+
+TEST_CASE("half: bf16 conversions")
+{
+    float const inf = std::numeric_limits<float>::infinity();
+
+    REQUIRE(bf16(1.0f).bits == 0x3f80);
+    REQUIRE(bf16(-2.0f).bits == 0xc000);
+    REQUIRE(float(bf16(3.140625f)) == 3.140625f);
+    REQUIRE(float(bf16(inf)) == inf);
+    REQUIRE(std::isnan(float(bf16(std::numeric_limits<float>::quiet_NaN()))));
+
+    // 1 + 2^-8 is exactly between two bf16 numbers, rounds to the even one
+    REQUIRE(float(bf16(1.0f + std::ldexp(1.0f, -8))) == 1.0f);
+    REQUIRE(float(bf16(1.0f + 3 * std::ldexp(1.0f, -8))) == 1.0f + std::ldexp(1.0f, -6));
+    // bf16 has the range of float
+    REQUIRE(float(bf16(1e30f)) == Approx(1e30f).epsilon(1e-2));
+}
+
+TEST_CASE("half: fp16 conversions")
+{
+    float const inf = std::numeric_limits<float>::infinity();
+
+    REQUIRE(fp16(1.0f).bits == 0x3c00);
+    REQUIRE(fp16(-2.0f).bits == 0xc000);
+    REQUIRE(fp16(65504.0f).bits == 0x7bff);
+    REQUIRE(float(fp16(65504.0f)) == 65504.0f);
+    REQUIRE(float(fp16(1e6f)) == inf);
+    REQUIRE(float(fp16(-inf)) == -inf);
+    REQUIRE(std::isnan(float(fp16(std::numeric_limits<float>::quiet_NaN()))));
+
+    // smallest subnormal
+    REQUIRE(fp16(std::ldexp(1.0f, -24)).bits == 0x0001);
+    REQUIRE(float(fp16::from_bits(0x0001)) == std::ldexp(1.0f, -24));
+    REQUIRE(float(fp16(std::ldexp(1.0f, -26))) == 0.0f);
+
+    // 1 + 2^-11 is exactly between two fp16 numbers, rounds to the even one
+    REQUIRE(float(fp16(1.0f + std::ldexp(1.0f, -11))) == 1.0f);
+    REQUIRE(float(fp16(1.0f + 3 * std::ldexp(1.0f, -11))) == 1.0f + std::ldexp(1.0f, -9));
+}
+
+TEST_CASE("half: fp16 kernels match the portable conversion")
+{
+    std::vector<float> values;
+    for (int i = -300; i < 300; ++i) {
+        values.push_back(std::ldexp(1.0f + static_cast<float>(i % 97) / 97.0f, i / 10));
+    }
+    values.push_back(std::numeric_limits<float>::infinity());
+    values.push_back(65520.0f);
+    values.push_back(std::ldexp(1.0f, -25));
+
+    for (auto isa : {simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (!simd::is_supported(isa)) {
+            continue;
+        }
+        INFO(simd::isa_name(isa));
+        auto const &kernels = simd::kernels(isa);
+        REQUIRE(kernels.float_to_fp16 != nullptr);
+
+        std::vector<std::uint16_t> bits(values.size());
+        kernels.float_to_fp16(values.data(), bits.data(), values.size());
+        for (size_type i = 0; i < values.size(); ++i) {
+            REQUIRE(bits[i] == fp16(values[i]).bits);
+        }
+
+        std::vector<float> widened(values.size());
+        kernels.fp16_to_float(bits.data(), widened.data(), bits.size());
+        for (size_type i = 0; i < values.size(); ++i) {
+            REQUIRE(widened[i] == float(fp16::from_bits(bits[i])));
+        }
+    }
+}
+
+TEST_CASE("half: cast")
+{
+    MatrixF matrix = {{1, -2, 0.5}, {1024, 0, -0.25}};
+    Matrix<bf16> half = matrix.cast<bf16>();
+    REQUIRE(half.shape() == matrix.shape());
+    REQUIRE(half.cast<float>() == matrix);
+    REQUIRE(matrix.cast<fp16>().cast<float>() == matrix);
+
+    // views are cast too
+    REQUIRE(matrix.permute({1, 0}).cast<fp16>().cast<float>() == MatrixF{{1, 1024}, {-2, 0}, {0.5, -0.25}});
+}
+
+TEST_CASE("half: elementwise ops compute in float")
+{
+    auto x = make_matrix(3, 517, 0.0f, 4.0f);
+    auto y = make_matrix(3, 517, 1.0f, -2.0f);
+    auto x_half = x.cast<bf16>();
+    auto y_half = y.cast<bf16>();
+    auto x_rounded = x_half.cast<float>();
+    auto y_rounded = y_half.cast<float>();
+
+    // float math on the rounded inputs, rounded once more at the end
+    REQUIRE(ts::add(x_half, y_half) == ts::add(x_rounded, y_rounded).cast<bf16>());
+    REQUIRE(ts::multiply(x_half, y_half) == ts::multiply(x_rounded, y_rounded).cast<bf16>());
+    REQUIRE(ts::multiply(x_half, bf16(0.5f)) == ts::multiply(x_rounded, 0.5f).cast<bf16>());
+    REQUIRE(ts::maximum(bf16(0.0f), x_half) == ts::maximum(0.0f, x_rounded).cast<bf16>());
+    REQUIRE(ts::exp(x_half) == ts::exp(x_rounded).cast<bf16>());
+
+    auto x_fp16 = x.cast<fp16>();
+    auto accumulated = ts::add(x_fp16, x_fp16);
+    ts::add_(accumulated, x_fp16);
+    auto expected = x_fp16.cast<float>();
+    REQUIRE(accumulated == ts::multiply(expected, 3.0f).cast<fp16>());
+}
+
+TEST_CASE("half: sum accumulates in float")
+{
+    VectorF values(4096);
+    ts::fill_(values, 1.0f);
+    auto ones = values.cast<bf16>();
+    // a bf16 accumulator would get stuck at 256
+    REQUIRE(float(ts::sum(ones)) == 4096.0f);
+}
+
+TEST_CASE("half: dot accumulates in float")
+{
+    auto x = make_matrix(7, 300, 0.0f);
+    auto w = make_matrix(300, 600, 1.0f, 0.1f);
+    auto w_bf16 = w.cast<bf16>();
+    auto w_fp16 = w.cast<fp16>();
+
+    auto expected_bf16 = ts::dot(x, w_bf16.cast<float>());
+    auto expected_fp16 = ts::dot(x, w_fp16.cast<float>());
+    auto result_bf16 = ts::dot(x, w_bf16);
+    auto result_fp16 = ts::dot(x, w_fp16);
+    require_close(result_bf16, expected_bf16);
+    require_close(result_fp16, expected_fp16);
+
+    // transposed operands, both in half precision
+    auto x_T = x.permute({1, 0}).contiguous().cast<bf16>();
+    auto w_T = w.permute({1, 0}).contiguous().cast<bf16>();
+    auto expected = ts::dot(x_T.cast<float>(), w_T.cast<float>(), true, true);
+    auto result = ts::dot(x_T, w_T, true, true);
+    require_close(result, expected);
+}
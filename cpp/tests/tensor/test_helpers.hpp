@@ -0,0 +1,29 @@
+#pragma once
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <tensor/tensor.hpp>
+
+namespace ts::test {
+
+// Deterministic matrix without repeating values, `offset` tells apart matrices of the same shape
+inline auto make_matrix(size_type rows, size_type columns, float offset, float scale = 1.0f) -> MatrixF
+{
+    MatrixF matrix(rows, columns);
+    for (size_type i = 0; i < matrix.data_size(); ++i) {
+        matrix.at(i) = scale * std::sin(static_cast<float>(i) * 0.61f + offset);
+    }
+    return matrix;
+}
+
+template <int Dim>
+auto require_close(Tensor<float, Dim> const &result, Tensor<float, Dim> const &expected, double tolerance = 1e-4)
+    -> void
+{
+    REQUIRE(result.shape() == expected.shape());
+    for (size_type i = 0; i < expected.data_size(); ++i) {
+        REQUIRE(result.at(i) == Approx(expected.at(i)).epsilon(tolerance).margin(tolerance));
+    }
+}
+
+} // namespace ts::test
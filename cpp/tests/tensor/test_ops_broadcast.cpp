@@ -0,0 +1,135 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <tensor/tensor.hpp>
+
+using namespace ts;
+
+namespace {
+
+struct ParallelSettings {
+    ParallelSettings(int threads, size_type grain) : _threads(num_threads()), _grain(grain_size())
+    {
+        set_num_threads(threads);
+        set_grain_size(grain);
+    }
+
+    ~ParallelSettings()
+    {
+        set_num_threads(_threads);
+        set_grain_size(_grain);
+    }
+
+  private:
+    int _threads;
+    size_type _grain;
+};
+
+template <int Dim> auto make_tensor(std::array<size_type, Dim> shape, float offset = 0.0f) -> Tensor<float, Dim>
+{
+    Tensor<float, Dim> tensor(shape);
+    for (size_type i = 0; i < tensor.data_size(); ++i) {
+        tensor.at(i) = std::sin(static_cast<float>(i) * 0.37f + offset) * 3.0f + 0.5f;
+    }
+    return tensor;
+}
+
+// x op channel(c) for x: [B, C, H, W], computed element by element
+template <typename Op> auto per_channel(Tensor<float, 4> const &x, VectorF const &channel, Op op) -> Tensor<float, 4>
+{
+    auto [B, C, H, W] = x.shape();
+    Tensor<float, 4> result(x.shape());
+    for (size_type b = 0; b < B; ++b) {
+        for (size_type c = 0; c < C; ++c) {
+            for (size_type h = 0; h < H; ++h) {
+                for (size_type w = 0; w < W; ++w) {
+                    result(b, c, h, w) = op(x(b, c, h, w), channel(c));
+                }
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("broadcast: shapes")
+{
+    MatrixF matrix = {{1, 2, 3}, {4, 5, 6}};
+    VectorF row = {10, 20, 30};
+    REQUIRE(ts::add(matrix, row) == MatrixF{{11, 22, 33}, {14, 25, 36}});
+    REQUIRE(ts::subtract(row, matrix) == MatrixF{{9, 18, 27}, {6, 15, 24}});
+
+    // [2, 1] with [1, 3] gives [2, 3]
+    MatrixF column = VectorF{1, 2}.reshape<2>({2, 1});
+    MatrixF line = {{1, 2, 3}};
+    REQUIRE(ts::multiply(column, line) == MatrixF{{1, 2, 3}, {2, 4, 6}});
+    REQUIRE(ts::divide(matrix, column) == MatrixF{{1, 2, 3}, {2, 2.5, 3}});
+
+    // a single value goes everywhere
+    VectorF scalar = {2};
+    REQUIRE(ts::maximum(matrix, scalar) == MatrixF{{2, 2, 3}, {4, 5, 6}});
+    REQUIRE(ts::minimum(scalar, matrix) == MatrixF{{1, 2, 2}, {2, 2, 2}});
+    REQUIRE(ts::add(matrix, matrix) == MatrixF{{2, 4, 6}, {8, 10, 12}});
+
+    Tensor<float, 3> tensor = ts::add(line.reshape<3>({1, 1, 3}), column);
+    REQUIRE(tensor.shape() == std::array<size_type, 3>{1, 2, 3});
+    REQUIRE(tensor[0] == MatrixF{{2, 3, 4}, {3, 4, 5}});
+
+    MatrixI integers = {{7, -8}, {9, 10}};
+    REQUIRE(ts::divide(integers, VectorI{2, 3}) == MatrixI{{3, -2}, {4, 3}});
+    REQUIRE(ts::minimum(integers, VectorI{0, 0}) == MatrixI{{0, -8}, {0, 0}});
+}
+
+TEST_CASE("broadcast: per channel")
+{
+    auto x = make_tensor<4>({2, 3, 5, 7});
+    VectorF channel = {1.5f, -2.0f, 0.25f};
+    auto c = channel.reshape<4>({1, 3, 1, 1});
+
+    REQUIRE(ts::add(x, c) == per_channel(x, channel, std::plus<>()));
+    REQUIRE(ts::subtract(x, c) == per_channel(x, channel, std::minus<>()));
+    REQUIRE(ts::multiply(x, c) == per_channel(x, channel, std::multiplies<>()));
+    REQUIRE(ts::divide(x, c) == per_channel(x, channel, std::divides<>()));
+    REQUIRE(ts::maximum(x, c) == per_channel(x, channel, [](float a, float b) { return a > b ? a : b; }));
+    REQUIRE(ts::minimum(x, c) == per_channel(x, channel, [](float a, float b) { return a < b ? a : b; }));
+
+    auto y = x.clone();
+    ts::multiply_(y, c);
+    REQUIRE(y == ts::multiply(x, c));
+}
+
+TEST_CASE("broadcast: views")
+{
+    auto x = make_tensor<3>({4, 5, 6});
+    auto transposed = x.permute({2, 0, 1});
+    VectorF row = make_tensor<1>({5}, 1.0f);
+
+    // strided operands give the same values as their contiguous copies
+    REQUIRE(ts::add(transposed, row) == ts::add(transposed.contiguous(), row));
+    REQUIRE(ts::multiply(transposed, transposed) == ts::multiply(transposed.contiguous(), transposed.contiguous()));
+    REQUIRE(ts::subtract(x[1], x[2].permute({1, 0}).permute({1, 0})) == ts::subtract(x[1].clone(), x[2].clone()));
+
+    // in place writes go through the view into the original
+    auto y = x.clone();
+    auto expected = ts::add(transposed, row);
+    ts::add_(y.permute({2, 0, 1}), row);
+    REQUIRE(y.permute({2, 0, 1}) == expected);
+}
+
+TEST_CASE("broadcast: parallel")
+{
+    auto x = make_tensor<4>({4, 16, 33, 35});
+    auto c = make_tensor<4>({1, 16, 1, 1}, 2.0f);
+    auto row = make_tensor<1>({35}, 3.0f);
+    auto long_row = make_tensor<1>({100000});
+    auto expected_channel = ts::multiply(x, c);
+    auto expected_row = ts::add(x, row);
+    auto expected_long = ts::subtract(long_row, VectorF{1.0f});
+    auto expected_view = ts::add(x.permute({0, 3, 2, 1}), c.permute({0, 3, 2, 1}));
+
+    ParallelSettings settings(4, 64);
+    REQUIRE(ts::multiply(x, c) == expected_channel);
+    REQUIRE(ts::add(x, row) == expected_row);
+    REQUIRE(ts::subtract(long_row, VectorF{1.0f}) == expected_long);
+    REQUIRE(ts::add(x.permute({0, 3, 2, 1}), c.permute({0, 3, 2, 1})) == expected_view);
+}
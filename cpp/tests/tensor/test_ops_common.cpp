@@ -83,6 +83,7 @@ TEST_CASE("transpose")
     auto result = ts::transpose(matrix);
 
     REQUIRE(result == expected);
+    REQUIRE(result.data() == matrix.data());
 }
 
 TEST_CASE("maximum(scalar, MatrixF)")
@@ -204,6 +205,27 @@ TEST_CASE("apply")
     REQUIRE(result == expected);
 }
 
+TEST_CASE("apply: any callable")
+{
+    MatrixF matrix = {{1, 2, 3},
+                     {4, 5, 6}};
+    float scale = 2;
+
+    REQUIRE(ts::apply(matrix, [scale](float e) { return e * scale; }) == MatrixF{{2, 4, 6}, {8, 10, 12}});
+    REQUIRE(ts::apply(matrix, matrix, std::plus<>()) == MatrixF{{2, 4, 6}, {8, 10, 12}});
+
+    // views are handled too
+    MatrixF transposed = ts::transpose(matrix);
+    REQUIRE(ts::apply(transposed, [](float e) { return -e; }) == MatrixF{{-1, -4}, {-2, -5}, {-3, -6}});
+    REQUIRE(ts::mask(transposed, [](float e) { return e > 3; }) ==
+            Tensor<char, 2>{{false, true}, {false, true}, {false, true}});
+    REQUIRE(ts::apply_if(transposed, transposed > 4, [](float) { return 0.0f; }) ==
+            MatrixF{{1, 4}, {2, 0}, {3, 0}});
+
+    ts::apply_(transposed, [](float e) { return e + 1; });
+    REQUIRE(matrix == MatrixF{{2, 3, 4}, {5, 6, 7}});
+}
+
 TEST_CASE("ts::log")
 {
     MatrixF matrix = {{1, 2, 3},
@@ -340,6 +362,39 @@ TEST_CASE("slice")
                             {20, 200}};
         REQUIRE(slice == expected);
     }
+
+    // slices are views
+    {
+        MatrixF slice = ts::slice(matrix, 1, 2, 1);
+        REQUIRE(slice.data() == matrix.data());
+        REQUIRE(ts::multiply(slice, 2.0f).flatten() == VectorF{0, 20, 40});
+        MatrixF ones(3, 1);
+        ts::fill_(ones, 1.0f);
+        ts::add_(slice, ones);
+        REQUIRE(matrix(2, 1) == 21);
+    }
+}
+
+TEST_CASE("clip_, fill_, saxpy_ and scalar in-place ops on views")
+{
+    MatrixF matrix = {{1, 2, 3},
+                      {4, 5, 6}};
+    MatrixF transposed = ts::transpose(matrix);
+
+    ts::add_(transposed, 1.0f);
+    REQUIRE(matrix == MatrixF{{2, 3, 4}, {5, 6, 7}});
+    ts::clip_(transposed, 3.0f, 6.0f);
+    REQUIRE(matrix == MatrixF{{3, 3, 4}, {5, 6, 6}});
+    ts::saxpy_(transposed, MatrixF{{1, 0}, {0, 0}, {0, 1}});
+    REQUIRE(matrix == MatrixF{{4, 3, 4}, {5, 6, 7}});
+
+    // the rest of the storage isn't touched
+    MatrixF column = ts::slice(matrix, 1, 2, 1);
+    ts::fill_(column, 0.0f);
+    REQUIRE(matrix == MatrixF{{4, 0, 4}, {5, 0, 7}});
+    ts::subtract_(column, 2.0f);
+    ts::clip_min_(column, -1.0f);
+    REQUIRE(matrix == MatrixF{{4, -1, 4}, {5, -1, 7}});
 }
 
 TEST_CASE("argmax(MatrixF)")
@@ -170,3 +170,90 @@ TEST_CASE("dot: Tensor[2, 2, 2] x MatrixF[2, 3]")
 
     REQUIRE(result == expected);
 }
+
+TEST_CASE("dot: strided views")
+{
+    MatrixF matrixA = {
+        {3, 1, 3},
+        {1, 5, 9},
+    };
+    MatrixF matrixB = {
+        {3, 1, 2},
+        {1, 5, 6}
+    };
+
+    // transposed view is the same as transpose flag
+    REQUIRE(dot(matrixA, ts::transpose(matrixB)) == dot(matrixA, matrixB, false, true));
+    REQUIRE(dot(ts::transpose(matrixA), matrixB) == dot(matrixA, matrixB, true, false));
+    REQUIRE(dot(ts::transpose(matrixA), ts::transpose(matrixB), false, true) == dot(matrixA, matrixB, true, false));
+    REQUIRE(dot(ts::transpose(matrixA), ts::transpose(matrixB), true, false) == dot(matrixA, matrixB, false, true));
+
+    // column slices keep the leading dimension of the original matrix
+    MatrixF sliced = ts::slice(matrixA, 1, 3, 1);
+    MatrixF expected = {
+        {1 * 3 + 3 * 1, 1 * 1 + 3 * 5},
+        {5 * 3 + 9 * 1, 5 * 1 + 9 * 5},
+    };
+    REQUIRE(dot(sliced, ts::slice(matrixB, 0, 2, 1)) == expected);
+
+    VectorF column = ts::transpose(matrixA)(2);
+    REQUIRE(dot(column, VectorF{1, 1}) == 12);
+    REQUIRE(dot(ts::transpose(matrixA), VectorF{1, 1}) == VectorF{4, 6, 12});
+
+    // output can be a view too
+    MatrixF matrixC = {
+        {1, 2},
+        {3, 4}
+    };
+    MatrixF C(3, 2);
+    auto C_T = ts::transpose(C);
+    dot(matrixC, matrixA, C_T);
+    REQUIRE(C == dot(matrixA, matrixC, true, true));
+}
+
+TEST_CASE("dot: batched products into a preallocated output")
+{
+    Tensor<float, 3> tensorA = {
+        {{1, 1},
+         {2, 2}},
+
+        {{3, 3},
+         {4, 4}}
+    };
+    MatrixF matrixB = {
+        {3, 1, 3},
+        {1, 5, 9},
+    };
+    Tensor<float, 3> expected = ts::dot(tensorA, matrixB);
+
+    // every sample goes into its part of C, beta keeps what is already there
+    Tensor<float, 3> C(2, 2, 3);
+    dot(tensorA, matrixB, C);
+    REQUIRE(C == expected);
+    dot(tensorA, ts::transpose(matrixB), C, true, 1.0f);
+    REQUIRE(C == ts::multiply(expected, 2.0f));
+
+    // samples that aren't next to each other
+    auto transposed = tensorA.permute({0, 2, 1});
+    dot(transposed, matrixB, C);
+    REQUIRE(C[0] == dot(tensorA[0], matrixB, true));
+    REQUIRE(C[1] == dot(tensorA[1], matrixB, true));
+
+    // strided batch, sample b of A times sample b of B
+    Tensor<float, 3> tensorB = {
+        {{1, 0, 2},
+         {0, 1, 3}},
+
+        {{2, 1, 0},
+         {1, 1, 1}}
+    };
+    Tensor<float, 3> batched = dot(tensorA, tensorB);
+    REQUIRE(batched[0] == dot(tensorA[0], tensorB[0]));
+    REQUIRE(batched[1] == dot(tensorA[1], tensorB[1]));
+
+    Tensor<float, 3> C_T(2, 3, 2);
+    auto C_view = C_T.permute({0, 2, 1});
+    dot(tensorA, tensorB, C_view, true, false);
+    REQUIRE(C_T[0] == dot(tensorB[0], tensorA[0], true, false));
+    REQUIRE(C_T[1] == dot(tensorB[1], tensorA[1], true, false));
+}
@@ -0,0 +1,178 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <tensor/tensor.hpp>
+
+#include "test_helpers.hpp"
+
+using namespace ts;
+using namespace ts::test;
+
+namespace {
+
+struct ParallelSettings {
+    ParallelSettings(int threads, size_type grain) : _threads(num_threads()), _grain(grain_size())
+    {
+        set_num_threads(threads);
+        set_grain_size(grain);
+    }
+
+    ~ParallelSettings()
+    {
+        set_num_threads(_threads);
+        set_grain_size(_grain);
+    }
+
+  private:
+    int _threads;
+    size_type _grain;
+};
+
+auto make_tensor(std::array<size_type, 3> shape) -> Tensor<float, 3>
+{
+    Tensor<float, 3> tensor(shape);
+    for (size_type i = 0; i < tensor.data_size(); ++i) {
+        tensor.at(i) = std::sin(static_cast<float>(i) * 0.37f) * 3.0f + 1.0f;
+    }
+    return tensor;
+}
+
+// Reduces axis of a [d0, d1, d2] tensor with fn(values) in double
+template <typename Function> auto reference(Tensor<float, 3> const &x, int axis, Function fn) -> Tensor<float, 2>
+{
+    auto shape = x.shape();
+    std::array<size_type, 2> result_shape{};
+    for (int i = 0, j = 0; i < 3; ++i) {
+        if (i != axis) {
+            result_shape[j++] = shape[i];
+        }
+    }
+    Tensor<float, 2> result(result_shape);
+    for (size_type a = 0; a < result_shape[0]; ++a) {
+        for (size_type b = 0; b < result_shape[1]; ++b) {
+            std::vector<double> values;
+            for (size_type k = 0; k < shape[axis]; ++k) {
+                std::array<size_type, 3> index = axis == 0 ? std::array<size_type, 3>{k, a, b}
+                                                 : axis == 1 ? std::array<size_type, 3>{a, k, b}
+                                                             : std::array<size_type, 3>{a, b, k};
+                values.push_back(x(index[0], index[1], index[2]));
+            }
+            result(a, b) = static_cast<float>(fn(values));
+        }
+    }
+    return result;
+}
+
+auto sum_of(std::vector<double> const &values) -> double { return std::accumulate(values.begin(), values.end(), 0.0); }
+
+auto mean_of(std::vector<double> const &values) -> double
+{
+    return sum_of(values) / static_cast<double>(values.size());
+}
+
+auto variance_of(std::vector<double> const &values) -> double
+{
+    double mean = mean_of(values);
+    double result = 0;
+    for (double value : values) {
+        result += (value - mean) * (value - mean);
+    }
+    return result / static_cast<double>(values.size());
+}
+
+auto logsumexp_of(std::vector<double> const &values) -> double
+{
+    double result = 0;
+    for (double value : values) {
+        result += std::exp(value);
+    }
+    return std::log(result);
+}
+
+auto check_axes(Tensor<float, 3> const &x) -> void
+{
+    for (int axis = 0; axis < 3; ++axis) {
+        INFO("axis " << axis);
+        require_close(ts::sum(x, axis), reference(x, axis, sum_of), 1e-5);
+        require_close(ts::mean(x, axis), reference(x, axis, mean_of), 1e-5);
+        require_close(ts::variance(x, axis), reference(x, axis, variance_of), 1e-5);
+        require_close(ts::logsumexp(x, axis), reference(x, axis, logsumexp_of), 1e-5);
+        require_close(ts::max(x, axis), reference(x, axis, [](auto const &values) {
+                          return *std::max_element(values.begin(), values.end());
+                      }), 1e-5);
+        require_close(ts::min(x, axis), reference(x, axis, [](auto const &values) {
+                          return *std::min_element(values.begin(), values.end());
+                      }), 1e-5);
+    }
+}
+
+} // namespace
+
+TEST_CASE("reduce: every axis")
+{
+    check_axes(make_tensor({3, 5, 7}));
+    // long runs go through the pairwise sum, many rows through blocks of partial sums
+    check_axes(make_tensor({2, 300, 3}));
+    check_axes(make_tensor({1, 4, 1000}));
+}
+
+TEST_CASE("reduce: negative axes and views")
+{
+    MatrixF matrix = {{1, 2, 3}, {4, 5, 6}};
+    REQUIRE(ts::sum(matrix, -1) == VectorF{6, 15});
+    REQUIRE(ts::max(matrix, -2) == VectorF{4, 5, 6});
+    REQUIRE(ts::sum(matrix.permute({1, 0}), 1) == VectorF{5, 7, 9});
+    REQUIRE(ts::mean(matrix) == 3.5f);
+    REQUIRE(ts::max(matrix) == 6.0f);
+    REQUIRE(ts::min(matrix.permute({1, 0})) == 1.0f);
+    REQUIRE(ts::variance(matrix) == Approx(35.0f / 12.0f));
+
+    MatrixI integers = {{1, -2}, {3, 4}};
+    REQUIRE(ts::sum(integers, 0) == VectorI{4, 2});
+    REQUIRE(ts::min(integers, 1) == VectorI{-2, 3});
+    REQUIRE(ts::sum(integers) == 6);
+}
+
+TEST_CASE("reduce: logsumexp doesn't overflow")
+{
+    float const inf = std::numeric_limits<float>::infinity();
+    MatrixF logits = {{1000, 1000}, {-inf, -inf}};
+    auto result = ts::logsumexp(logits, 1);
+    REQUIRE(result(0) == Approx(1000 + std::log(2.0f)));
+    REQUIRE(result(1) == -inf);
+}
+
+TEST_CASE("reduce: sums are accurate")
+{
+    // a running float sum of these is off by about 1%
+    VectorF values(1000000);
+    ts::fill_(values, 0.1f);
+    REQUIRE(ts::sum(values) == Approx(1e6 * static_cast<double>(0.1f)).epsilon(1e-6));
+    REQUIRE(ts::mean(values) == Approx(0.1f).epsilon(1e-6));
+    REQUIRE(ts::sum(values.reshape<2>({1000, 1000}), 0)(7) == Approx(1000 * static_cast<double>(0.1f)).epsilon(1e-6));
+
+    // variance of values far from zero
+    VectorF shifted = {10000.1f, 10000.2f, 10000.3f};
+    REQUIRE(ts::variance(shifted) == Approx(0.02f / 3.0f).epsilon(1e-2));
+}
+
+TEST_CASE("reduce: parallel reductions")
+{
+    auto x = make_tensor({4, 1000, 33});
+    auto tall = make_tensor({1, 20000, 3});
+    auto wide = make_tensor({2, 10, 5000});
+    auto expected_sums = std::array{ts::sum(x, 0), ts::sum(x, 1), ts::sum(x, 2)};
+    auto expected_tall = ts::sum(tall, 1);
+    auto expected_wide = ts::max(wide, 1);
+    auto expected_total = ts::sum(x);
+
+    // splits by outer slices, by columns and by parts of the reduced axis
+    ParallelSettings settings(4, 64);
+    for (int axis = 0; axis < 3; ++axis) {
+        require_close(ts::sum(x, axis), expected_sums[axis], 1e-5);
+    }
+    require_close(ts::sum(tall, 1), expected_tall, 1e-5);
+    REQUIRE(ts::max(wide, 1) == expected_wide);
+    REQUIRE(ts::sum(x) == Approx(expected_total).epsilon(1e-6));
+}
@@ -0,0 +1,186 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <tensor/parallel.hpp>
+#include <tensor/ts.hpp>
+#include <vector>
+
+using namespace ts;
+
+namespace {
+
+// Forces the parallel path for small inputs, restores the settings at the end of a test
+struct ParallelSettings {
+    ParallelSettings(int threads, size_type grain) : _threads(num_threads()), _grain(grain_size())
+    {
+        set_num_threads(threads);
+        set_grain_size(grain);
+    }
+
+    ~ParallelSettings()
+    {
+        set_num_threads(_threads);
+        set_grain_size(_grain);
+    }
+
+  private:
+    int _threads;
+    size_type _grain;
+};
+
+} // namespace
+
+TEST_CASE("parallel_for: covers the range with aligned chunks")
+{
+    ParallelSettings settings(4, 16);
+
+    size_type const size = 1000;
+    std::vector<int> visits(size, 0);
+    std::atomic<int> chunks{0};
+    std::atomic<int> misaligned{0};
+    parallel_for(
+        size,
+        [&](size_type begin, size_type end) {
+            misaligned += begin % 16 != 0;
+            ++chunks;
+            for (size_type i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        },
+        16);
+
+    REQUIRE(chunks == 4);
+    REQUIRE(misaligned == 0);
+    REQUIRE(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+}
+
+TEST_CASE("parallel_for: stays serial below the grain size")
+{
+    ParallelSettings settings(4, 100);
+
+    int calls = 0;
+    parallel_for(99, [&](size_type begin, size_type end) {
+        ++calls;
+        REQUIRE(begin == 0);
+        REQUIRE(end == 99);
+    });
+    REQUIRE(calls == 1);
+}
+
+TEST_CASE("parallel_for: nested regions")
+{
+    ParallelSettings settings(4, 100);
+
+    std::atomic<int> inner_calls{0};
+    std::atomic<int> sum{0};
+    parallel_for(400, [&](size_type, size_type) {
+        parallel_for(400, [&](size_type begin, size_type end) {
+            ++inner_calls;
+            sum += static_cast<int>(end - begin);
+        });
+    });
+    REQUIRE(inner_calls == 16);
+    REQUIRE(sum == 1600);
+}
+
+TEST_CASE("parallel_for_each")
+{
+    ParallelSettings settings(3, 1 << 20);
+
+    std::vector<int> visits(10, 0);
+    parallel_for_each(visits.size(), [&](size_type i) { ++visits[i]; });
+    REQUIRE(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+}
+
+TEST_CASE("ThreadLimit")
+{
+    ParallelSettings settings(8, 1);
+    REQUIRE(max_threads() == 8);
+    {
+        ThreadLimit limit(2);
+        REQUIRE(max_threads() == 2);
+        {
+            // can only narrow down
+            ThreadLimit inner(4);
+            REQUIRE(max_threads() == 2);
+        }
+
+        std::atomic<int> chunks{0};
+        std::atomic<int> inner_limit{0};
+        parallel_for(1000, [&](size_type, size_type) {
+            ++chunks;
+            inner_limit = max_threads();
+        });
+        REQUIRE(chunks == 2);
+        REQUIRE(inner_limit == 2);
+    }
+    REQUIRE(max_threads() == 8);
+}
+
+TEST_CASE("TaskGroup: independent tasks")
+{
+    ParallelSettings settings(4, 1 << 20);
+
+    std::vector<int> results(16, 0);
+    {
+        TaskGroup group;
+        for (size_type i = 0; i < results.size(); ++i) {
+            group.run([&results, i]() { results[i] = static_cast<int>(i * i); });
+        }
+        group.wait();
+        REQUIRE(results[15] == 225);
+    }
+
+    // tasks can start their own parallel work
+    MatrixF a = MatrixF::randn({64, 64});
+    MatrixF b;
+    MatrixF c;
+    {
+        TaskGroup group;
+        group.run([&]() { b = ts::multiply(a, 2.0f); });
+        group.run([&]() { c = ts::add(a, a); });
+    }
+    REQUIRE(b == c);
+}
+
+TEST_CASE("parallel_reduce")
+{
+    ParallelSettings settings(3, 10);
+
+    std::vector<int> values(1001);
+    std::iota(values.begin(), values.end(), 0);
+    auto sum = parallel_reduce(
+        values.size(), 0,
+        [&](size_type begin, size_type end) { return std::accumulate(&values[begin], &values[0] + end, 0); },
+        std::plus<>());
+    REQUIRE(sum == 500500);
+    REQUIRE(parallel_reduce(0, 7, [](size_type, size_type) { return 1; }, std::plus<>()) == 7);
+}
+
+TEST_CASE("parallel: ops give the same results as serial ones")
+{
+    MatrixF a = MatrixF::randn({33, 65});
+    MatrixF b = MatrixF::randn({33, 65});
+
+    MatrixF sum_serial;
+    MatrixF product_serial;
+    MatrixF applied_serial;
+    MatrixF exp_serial;
+    {
+        ParallelSettings settings(1, 1);
+        sum_serial = ts::add(a, b);
+        product_serial = ts::multiply(a, b);
+        applied_serial = ts::apply(a, [](float e) { return e * e + 1; });
+        exp_serial = ts::exp(a);
+    }
+
+    ParallelSettings settings(4, 64);
+    REQUIRE(ts::add(a, b) == sum_serial);
+    REQUIRE(ts::multiply(a, b) == product_serial);
+    REQUIRE(ts::apply(a, [](float e) { return e * e + 1; }) == applied_serial);
+    REQUIRE(ts::exp(a) == exp_serial);
+
+    MatrixF ones(100, 100);
+    ts::fill_(ones, 1.0f);
+    REQUIRE(ts::sum(ones) == 10000);
+}
@@ -0,0 +1,184 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <tensor/nn/layer/conv_2d_im2col_quantized.hpp>
+#include <tensor/nn/layer/feed_forward_quantized.hpp>
+#include <tensor/quantization.hpp>
+#include <tensor/quantization_kernels.hpp>
+#include <tensor/simd.hpp>
+#include <tensor/tensor.hpp>
+
+using namespace ts;
+
+namespace {
+
+template <int Dim> auto fill(Tensor<float, Dim> tensor, float scale, float phase = 0.0f) -> Tensor<float, Dim>
+{
+    for (size_type i = 0; i < tensor.data_size(); ++i) {
+        tensor.at(i) = scale * std::sin(static_cast<float>(i) * 0.73f + phase);
+    }
+    return tensor;
+}
+
+auto quantize(float value, float scale) -> int
+{
+    return static_cast<int>(std::max(-127.0f, std::min(127.0f, std::nearbyint(value / scale))));
+}
+
+// What the int8 GEMM is supposed to compute, in double
+auto reference(MatrixF const &x, float x_scale, MatrixF const &w, VectorF const &bias, bool relu) -> MatrixF
+{
+    MatrixF result(x.shape(0), w.shape(1));
+    for (size_type j = 0; j < w.shape(1); ++j) {
+        float max_abs = 0.0f;
+        for (size_type p = 0; p < w.shape(0); ++p) {
+            max_abs = std::max(max_abs, std::abs(w(p, j)));
+        }
+        float w_scale = max_abs / 127.0f;
+        for (size_type i = 0; i < x.shape(0); ++i) {
+            long acc = 0;
+            for (size_type p = 0; p < w.shape(0); ++p) {
+                acc += quantize(x(i, p), x_scale) * quantize(w(p, j), w_scale);
+            }
+            double y = static_cast<double>(acc) * x_scale * w_scale + bias(j);
+            result(i, j) = static_cast<float>(relu ? std::max(y, 0.0) : y);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("quantization: range observer")
+{
+    RangeObserver observer;
+    REQUIRE(observer.scale() == 1.0f);
+    observer.observe(MatrixF{{1, -2}, {0.5, 1}});
+    observer.observe(Tensor<float, 4>(1, 1, 1, 1));
+    REQUIRE(observer.max_abs() == 2.0f);
+    REQUIRE(observer.scale() == Approx(2.0f / 127.0f));
+}
+
+TEST_CASE("quantization: weights get a scale per column")
+{
+    MatrixF weight = {{1.5, -0.5, 0}, {-2, 0.2, 0}};
+    auto quantized = quantize_weights(weight);
+    REQUIRE(quantized.rows == 2);
+    REQUIRE(quantized.columns == 3);
+    REQUIRE(quantized.scales[0] == Approx(2.0f / 127.0f));
+    REQUIRE(quantized.scales[1] == Approx(0.5f / 127.0f));
+    // columns of zeros must not divide by zero
+    REQUIRE(quantized.scales[2] == 1.0f);
+    REQUIRE(quantized.column_sums[0] == 95 - 127);
+    REQUIRE(quantized.column_sums[1] == -127 + 51);
+    REQUIRE(quantized.column_sums[2] == 0);
+}
+
+TEST_CASE("quantization: quantized_dot")
+{
+    // odd sizes: partial groups of k, a partial block of columns and a tail of rows
+    auto x = fill(MatrixF(7, 37), 3.0f);
+    auto w = fill(MatrixF(37, 21), 0.2f, 1.0f);
+    auto bias = fill(VectorF(21), 0.5f, 2.0f);
+    float x_scale = 3.0f / 127.0f;
+
+    for (bool relu : {false, true}) {
+        auto expected = reference(x, x_scale, w, bias, relu);
+        auto result = quantized_dot(x, x_scale, quantize_weights(w), bias, relu);
+        REQUIRE(result.shape() == expected.shape());
+        for (size_type i = 0; i < expected.data_size(); ++i) {
+            REQUIRE(result.at(i) == Approx(expected.at(i)).margin(1e-5));
+        }
+    }
+
+    // close to the float product too
+    auto exact = ts::dot(x, w);
+    auto result = quantized_dot(x, x_scale, quantize_weights(w));
+    for (size_type i = 0; i < exact.data_size(); ++i) {
+        REQUIRE(result.at(i) == Approx(exact.at(i)).margin(0.05));
+    }
+
+    // views are quantized as they are
+    auto x_T = MatrixF(x.permute({1, 0}), true);
+    REQUIRE(quantized_dot(x_T.permute({1, 0}), x_scale, quantize_weights(w)) == result);
+}
+
+TEST_CASE("quantization: kernels agree")
+{
+    auto x = fill(MatrixF(6, 40), 1.0f);
+    auto w = quantize_weights(fill(MatrixF(40, 35), 1.0f, 0.5f));
+    auto expected = quantized_dot(x, 1.0f / 127.0f, w, std::nullopt, true);
+
+    // x in [-1, 1] with scale 1/127 is exactly what quantized_dot() feeds to the kernel
+    std::vector<std::int8_t> x_quantized(6 * 40);
+    for (size_type i = 0; i < x_quantized.size(); ++i) {
+        x_quantized[i] = static_cast<std::int8_t>(quantize(x.at(i), 1.0f / 127.0f));
+    }
+    std::vector<float> scales(w.scales);
+    for (auto &scale : scales) {
+        scale *= 1.0f / 127.0f;
+    }
+    std::vector<float> bias(scales.size(), 0.0f);
+
+    std::vector<detail::QGemmKernel> kernels;
+#ifdef TENSOR_SIMD_X86
+    // only built for x86 with TENSOR_USE_SIMD
+    if (simd::is_supported(simd::Isa::AVX2)) {
+        kernels.push_back(detail::qgemm_avx2);
+    }
+    if (simd::is_supported(simd::Isa::AVX512) && __builtin_cpu_supports("avx512vnni")) {
+        kernels.push_back(detail::qgemm_vnni);
+    }
+#endif
+    for (auto kernel : kernels) {
+        MatrixF result(6, 35);
+        detail::QGemm args{};
+        args.x = x_quantized.data();
+        args.m = 6;
+        args.k_groups = 10;
+        args.w = w.data.data();
+        args.column_sums = w.column_sums.data();
+        args.scales = scales.data();
+        args.bias = bias.data();
+        args.relu = true;
+        args.out = result.raw_data_mutable();
+        args.n = 35;
+        args.ldo = 35;
+        kernel(args, 0, 6, 0, 3);
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("quantization: FeedForward")
+{
+    auto layer = FeedForward::create(32, 20, Activation::RELU);
+    RangeObserver observer;
+    for (int batch = 0; batch < 3; ++batch) {
+        observer.observe(fill(MatrixF(8, 32), 2.0f, static_cast<float>(batch)));
+    }
+    QuantizedFeedForward quantized(layer, observer);
+
+    auto input = fill(MatrixF(5, 32), 1.5f, 0.3f);
+    auto expected = layer(input);
+    auto output = quantized(input);
+    REQUIRE(output.shape() == expected.shape());
+    for (size_type i = 0; i < output.data_size(); ++i) {
+        REQUIRE(output.at(i) >= 0.0f);
+        REQUIRE(output.at(i) == Approx(expected.at(i)).margin(0.05));
+    }
+}
+
+TEST_CASE("quantization: im2col Conv2D")
+{
+    auto layer = im2col::Conv2D::create(3, 5, 3, 1, 1, 1, Activation::RELU, false);
+    auto input = fill(Tensor<float, 4>(2, 3, 8, 8), 1.0f);
+    RangeObserver observer;
+    observer.observe(input);
+    im2col::QuantizedConv2D quantized(layer, observer);
+
+    auto expected = layer(input);
+    auto output = quantized(input);
+    REQUIRE(output.shape() == expected.shape());
+    for (size_type i = 0; i < output.data_size(); ++i) {
+        REQUIRE(output.at(i) == Approx(expected.at(i)).margin(0.05));
+    }
+}
@@ -0,0 +1,133 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <tensor/parallel.hpp>
+#include <tensor/random.hpp>
+#include <tensor/ts.hpp>
+
+using namespace ts;
+
+namespace {
+
+struct ParallelSettings {
+    ParallelSettings(int threads, size_type grain) : _threads(num_threads()), _grain(grain_size())
+    {
+        set_num_threads(threads);
+        set_grain_size(grain);
+    }
+
+    ~ParallelSettings()
+    {
+        set_num_threads(_threads);
+        set_grain_size(_grain);
+    }
+
+  private:
+    int _threads;
+    size_type _grain;
+};
+
+} // namespace
+
+TEST_CASE("random: the same seed gives the same values at any thread count")
+{
+    MatrixF expected(123, 77);
+    Tensor<int, 2> expected_int(123, 77);
+    {
+        ParallelSettings settings(1, 1 << 30);
+        Generator generator(1234);
+        normal_(expected, 0.0f, 1.0f, generator);
+        randint_(expected_int, -5, 5, generator);
+    }
+    for (int threads : {2, 3, 8}) {
+        ParallelSettings settings(threads, 64);
+        Generator generator(1234);
+        MatrixF result(123, 77);
+        Tensor<int, 2> result_int(123, 77);
+        normal_(result, 0.0f, 1.0f, generator);
+        randint_(result_int, -5, 5, generator);
+        REQUIRE(result == expected);
+        REQUIRE(result_int == expected_int);
+    }
+}
+
+TEST_CASE("random: draws, seeds and streams are independent")
+{
+    Generator generator(7);
+    VectorF first(1000);
+    VectorF second(1000);
+    uniform_(first, 0.0f, 1.0f, generator);
+    uniform_(second, 0.0f, 1.0f, generator);
+    REQUIRE_FALSE(first == second);
+    REQUIRE(generator.offset() > 0);
+
+    Generator other_stream(7, 1);
+    VectorF third(1000);
+    uniform_(third, 0.0f, 1.0f, other_stream);
+    REQUIRE_FALSE(third == first);
+
+    generator.manual_seed(7);
+    uniform_(second, 0.0f, 1.0f, generator);
+    REQUIRE(second == first);
+}
+
+TEST_CASE("random: views are filled like contiguous tensors")
+{
+    Generator generator(3);
+    MatrixF contiguous(16, 8);
+    uniform_(contiguous, -1.0f, 1.0f, generator);
+
+    generator.set_offset(0);
+    MatrixF transposed(8, 16);
+    auto view = transposed.permute({1, 0});
+    uniform_(view, -1.0f, 1.0f, generator);
+    REQUIRE(view.contiguous() == contiguous);
+}
+
+TEST_CASE("random: distributions")
+{
+    ParallelSettings settings(4, 1024);
+    Generator generator(11);
+    size_type const n = 100000;
+
+    VectorF uniform(n);
+    uniform_(uniform, -2.0f, 3.0f, generator);
+    double sum = 0.0;
+    for (auto e : uniform) {
+        REQUIRE((e >= -2.0f && e < 3.0f));
+        sum += e;
+    }
+    REQUIRE(sum / n == Approx(0.5).margin(0.02));
+
+    VectorF normal(n);
+    normal_(normal, 1.0f, 2.0f, generator);
+    double mean = 0.0;
+    double square = 0.0;
+    for (auto e : normal) {
+        REQUIRE(std::isfinite(e));
+        mean += e;
+        square += static_cast<double>(e) * e;
+    }
+    mean /= n;
+    REQUIRE(mean == Approx(1.0).margin(0.03));
+    REQUIRE(std::sqrt(square / n - mean * mean) == Approx(2.0).margin(0.03));
+
+    VectorF bernoulli(n);
+    bernoulli_(bernoulli, 0.3f, generator);
+    double ones = 0.0;
+    for (auto e : bernoulli) {
+        REQUIRE((e == 0.0f || e == 1.0f));
+        ones += e;
+    }
+    REQUIRE(ones / n == Approx(0.3).margin(0.01));
+
+    VectorI integers(n);
+    randint_(integers, 0, 2, generator);
+    std::array<size_type, 3> counts{};
+    for (auto e : integers) {
+        REQUIRE((e >= 0 && e <= 2));
+        ++counts[e];
+    }
+    for (auto count : counts) {
+        REQUIRE(static_cast<double>(count) / n == Approx(1.0 / 3.0).margin(0.01));
+    }
+}
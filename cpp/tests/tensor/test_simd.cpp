@@ -0,0 +1,285 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tensor/simd.hpp>
+#include <tensor/tensor.hpp>
+#include <vector>
+
+using namespace ts;
+
+namespace {
+
+// odd size so every kernel goes through its tail path too
+auto make_input(size_type size, float low, float high) -> std::vector<float>
+{
+    std::vector<float> values(size);
+    for (size_type i = 0; i < size; ++i) {
+        values[i] = low + (high - low) * static_cast<float>(i) / static_cast<float>(size - 1);
+    }
+    return values;
+}
+
+auto supported_isas() -> std::vector<simd::Isa>
+{
+    std::vector<simd::Isa> isas;
+    for (auto isa : {simd::Isa::SSE42, simd::Isa::AVX2, simd::Isa::AVX512}) {
+        if (simd::is_supported(isa)) {
+            isas.push_back(isa);
+        }
+    }
+    return isas;
+}
+
+} // namespace
+
+TEST_CASE("simd: kernels match scalar versions")
+{
+    size_type const n = 37;
+    auto x = make_input(n, -20.0f, 20.0f);
+    auto y = make_input(n, 3.0f, -5.0f);
+    auto positive = make_input(n, 1e-3f, 1e3f);
+    auto const &scalar = simd::kernels(simd::Isa::SCALAR);
+
+    for (auto isa : supported_isas()) {
+        INFO(simd::isa_name(isa));
+        auto const &kernels = simd::kernels(isa);
+        REQUIRE(kernels.isa == isa);
+
+        std::vector<float> expected(n);
+        std::vector<float> result(n);
+
+        scalar.add(x.data(), y.data(), expected.data(), n);
+        kernels.add(x.data(), y.data(), result.data(), n);
+        REQUIRE(result == expected);
+
+        scalar.multiply(x.data(), y.data(), expected.data(), n);
+        kernels.multiply(x.data(), y.data(), result.data(), n);
+        REQUIRE(result == expected);
+
+        scalar.add_scalar(x.data(), 0.5f, expected.data(), n);
+        kernels.add_scalar(x.data(), 0.5f, result.data(), n);
+        REQUIRE(result == expected);
+
+        scalar.multiply_scalar(x.data(), 0.5f, expected.data(), n);
+        kernels.multiply_scalar(x.data(), 0.5f, result.data(), n);
+        REQUIRE(result == expected);
+
+        scalar.maximum(0.0f, x.data(), expected.data(), n);
+        kernels.maximum(0.0f, x.data(), result.data(), n);
+        REQUIRE(result == expected);
+
+        scalar.clip(x.data(), -5.0f, 5.0f, expected.data(), n);
+        kernels.clip(x.data(), -5.0f, 5.0f, result.data(), n);
+        REQUIRE(result == expected);
+
+        scalar.fill(expected.data(), 3.0f, n);
+        kernels.fill(result.data(), 3.0f, n);
+        REQUIRE(result == expected);
+
+        expected = y;
+        result = y;
+        scalar.axpy(2.0f, x.data(), expected.data(), n);
+        kernels.axpy(2.0f, x.data(), result.data(), n);
+        REQUIRE(result == expected);
+
+        for (auto op : {simd::Binary::ADD, simd::Binary::SUBTRACT, simd::Binary::MULTIPLY, simd::Binary::DIVIDE,
+                        simd::Binary::MAXIMUM, simd::Binary::MINIMUM}) {
+            for (auto [x_step, y_step] : {std::pair<size_type, size_type>{1, 1}, {1, 0}, {0, 1}}) {
+                scalar.binary(op, x.data(), x_step, y.data(), y_step, expected.data(), n);
+                kernels.binary(op, x.data(), x_step, y.data(), y_step, result.data(), n);
+                REQUIRE(result == expected);
+            }
+        }
+
+        for (float power : {2.0f, 1.0f, 0.5f, -1.0f, -1.5f}) {
+            scalar.pow(positive.data(), power, expected.data(), n);
+            kernels.pow(positive.data(), power, result.data(), n);
+            for (size_type i = 0; i < n; ++i) {
+                REQUIRE(result[i] == Approx(expected[i]));
+            }
+        }
+
+        scalar.exp(x.data(), 1e-10f, expected.data(), n);
+        kernels.exp(x.data(), 1e-10f, result.data(), n);
+        for (size_type i = 0; i < n; ++i) {
+            REQUIRE(result[i] == Approx(expected[i]));
+        }
+
+        scalar.log(positive.data(), 1e-10f, expected.data(), n);
+        kernels.log(positive.data(), 1e-10f, result.data(), n);
+        for (size_type i = 0; i < n; ++i) {
+            REQUIRE(result[i] == Approx(expected[i]));
+        }
+    }
+}
+
+TEST_CASE("simd: gemm micro-kernel")
+{
+    size_type const k = 37;
+    auto isas = supported_isas();
+    isas.push_back(simd::Isa::SCALAR);
+    for (auto isa : isas) {
+        INFO(simd::isa_name(isa));
+        auto const &kernels = simd::kernels(isa);
+        size_type rows = kernels.gemm_rows;
+        size_type columns = kernels.gemm_columns;
+        auto a = make_input(k * rows, -1.0f, 1.0f);
+        auto b = make_input(k * columns, 2.0f, -3.0f);
+
+        // one spare column on the right of c must stay untouched
+        size_type ldc = columns + 1;
+        std::vector<float> c(rows * ldc, 1.0f);
+        kernels.gemm(k, a.data(), b.data(), c.data(), ldc, true);
+        for (size_type r = 0; r < rows; ++r) {
+            for (size_type j = 0; j < columns; ++j) {
+                double expected = 1.0;
+                for (size_type p = 0; p < k; ++p) {
+                    expected += static_cast<double>(a[p * rows + r]) * b[p * columns + j];
+                }
+                REQUIRE(c[r * ldc + j] == Approx(expected).epsilon(1e-5).margin(1e-5));
+            }
+            REQUIRE(c[r * ldc + columns] == 1.0f);
+        }
+    }
+}
+
+TEST_CASE("simd: philox")
+{
+    auto isas = supported_isas();
+    isas.push_back(simd::Isa::SCALAR);
+    // known answers of Philox4x32-10 from the Random123 distribution, word w of lane 0 is out[w * PHILOX_LANES]
+    struct Answer {
+        std::uint64_t key, stream, counter;
+        std::uint32_t words[4];
+    };
+    std::vector<Answer> answers = {
+        {0, 0, 0, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+        {~0ull, ~0ull, ~0ull, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+        {0x299f31d0a4093822, 0x0370734413198a2e, 0x85a308d3243f6a88, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}};
+    size_type const groups = 3;
+    std::vector<std::uint32_t> expected(groups * 4 * simd::PHILOX_LANES);
+    std::vector<std::uint32_t> result(expected.size());
+    simd::kernels(simd::Isa::SCALAR).philox(7, 3, 100, expected.data(), groups);
+
+    for (auto isa : isas) {
+        INFO(simd::isa_name(isa));
+        auto const &kernels = simd::kernels(isa);
+        for (auto const &answer : answers) {
+            kernels.philox(answer.key, answer.stream, answer.counter, result.data(), 1);
+            for (size_type w = 0; w < 4; ++w) {
+                REQUIRE(result[w * simd::PHILOX_LANES] == answer.words[w]);
+            }
+        }
+        kernels.philox(7, 3, 100, result.data(), groups);
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("simd: fused optimizer updates match scalar versions")
+{
+    size_type const n = 37;
+    auto const &scalar = simd::kernels(simd::Isa::SCALAR);
+    simd::UpdateParameters parameters{0.1f, 0.9f, 0.999f, 1e-8f, 0.3f, 5.0f};
+
+    for (auto isa : supported_isas()) {
+        INFO(simd::isa_name(isa));
+        auto const &kernels = simd::kernels(isa);
+        for (auto update : {simd::Update::SGD, simd::Update::MOMENTUM, simd::Update::ADAGRAD, simd::Update::RMSPROP,
+                            simd::Update::ADAM}) {
+            // gradients go past the clipping range on both ends
+            std::vector<float> w[2] = {make_input(n, -1.0f, 1.0f), make_input(n, -1.0f, 1.0f)};
+            std::vector<float> g[2] = {make_input(n, -8.0f, 7.0f), make_input(n, -8.0f, 7.0f)};
+            std::vector<float> m[2] = {make_input(n, 0.0f, 2.0f), make_input(n, 0.0f, 2.0f)};
+            std::vector<float> v[2] = {make_input(n, 0.5f, 1.0f), make_input(n, 0.5f, 1.0f)};
+            scalar.update(update, parameters, w[0].data(), g[0].data(), m[0].data(), v[0].data(), n);
+            kernels.update(update, parameters, w[1].data(), g[1].data(), m[1].data(), v[1].data(), n);
+            REQUIRE(g[1] == g[0]);
+            for (size_type i = 0; i < n; ++i) {
+                REQUIRE(w[1][i] == Approx(w[0][i]));
+                REQUIRE(m[1][i] == Approx(m[0][i]));
+                REQUIRE(v[1][i] == Approx(v[0][i]));
+            }
+        }
+    }
+}
+
+TEST_CASE("simd: fused optimizer updates keep NaN gradients")
+{
+    size_type const n = 37;
+    float const nan = std::numeric_limits<float>::quiet_NaN();
+    simd::UpdateParameters parameters{0.1f, 0.9f, 0.999f, 1e-8f, 0.3f, 5.0f};
+
+    auto isas = supported_isas();
+    isas.push_back(simd::Isa::SCALAR);
+    for (auto isa : isas) {
+        INFO(simd::isa_name(isa));
+        auto const &kernels = simd::kernels(isa);
+        for (auto update : {simd::Update::SGD, simd::Update::MOMENTUM, simd::Update::ADAGRAD, simd::Update::RMSPROP,
+                            simd::Update::ADAM}) {
+            // one NaN in the vector loop and one in the tail, clipping must not turn them into -clip (the loss scaler
+            // looks for them)
+            auto w = make_input(n, -1.0f, 1.0f);
+            auto g = make_input(n, -8.0f, 7.0f);
+            auto m = make_input(n, 0.0f, 2.0f);
+            auto v = make_input(n, 0.5f, 1.0f);
+            g[3] = nan;
+            g[n - 1] = nan;
+            kernels.update(update, parameters, w.data(), g.data(), m.data(), v.data(), n);
+            for (size_type i = 0; i < n; ++i) {
+                bool is_nan = i == 3 || i == n - 1;
+                REQUIRE(std::isnan(g[i]) == is_nan);
+                REQUIRE(std::isnan(w[i]) == is_nan);
+            }
+        }
+    }
+}
+
+TEST_CASE("simd: exp and log special values")
+{
+    float const inf = std::numeric_limits<float>::infinity();
+    std::vector<float> x = {-inf, -1000.0f, -1.0f, 0.0f, 88.0f, 88.7f, 89.0f, inf};
+    std::vector<float> result(x.size());
+
+    for (auto isa : supported_isas()) {
+        INFO(simd::isa_name(isa));
+        auto const &kernels = simd::kernels(isa);
+
+        kernels.exp(x.data(), 0.0f, result.data(), x.size());
+        REQUIRE(result[0] == 0.0f);
+        REQUIRE(result[1] == 0.0f);
+        REQUIRE(result[3] == 1.0f);
+        REQUIRE(result[4] == Approx(std::exp(88.0f)));
+        REQUIRE(result[5] == Approx(std::exp(88.7f)));
+        REQUIRE(result[6] == inf);
+        REQUIRE(result[7] == inf);
+
+        kernels.log(x.data(), 0.0f, result.data(), x.size());
+        REQUIRE(std::isnan(result[0]));
+        REQUIRE(std::isnan(result[2]));
+        REQUIRE(result[3] == -inf);
+        REQUIRE(result[4] == Approx(std::log(88.0f)));
+        REQUIRE(result[7] == inf);
+
+        std::vector<float> nan = {std::numeric_limits<float>::quiet_NaN()};
+        kernels.exp(nan.data(), 0.0f, result.data(), 1);
+        REQUIRE(std::isnan(result[0]));
+        kernels.log(nan.data(), 0.0f, result.data(), 1);
+        REQUIRE(std::isnan(result[0]));
+    }
+}
+
+TEST_CASE("simd: ops use the selected kernels")
+{
+    REQUIRE(simd::is_supported(simd::kernels().isa));
+
+    MatrixF matrix = {{-1, 2, -3}, {4, -5, 6}};
+    REQUIRE(ts::maximum(0.0f, matrix) == MatrixF{{0, 2, 0}, {4, 0, 6}});
+    REQUIRE(ts::pow(matrix, 2.0f) == MatrixF{{1, 4, 9}, {16, 25, 36}});
+
+    ts::clip_(matrix, -2.0f, 2.0f);
+    REQUIRE(matrix == MatrixF{{-1, 2, -2}, {2, -2, 2}});
+
+    ts::fill_(matrix, 7.0f);
+    REQUIRE(matrix == MatrixF{{7, 7, 7}, {7, 7, 7}});
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <tensor/storage.hpp>
+#include <tensor/tensor.hpp>
+#include <vector>
+
+using namespace ts;
+
+namespace {
+
+auto temporary_path(std::string const &name) -> std::string { return "/tmp/tensor_test_storage_" + name; }
+
+auto write_file(std::string const &path, std::vector<float> const &values) -> void
+{
+    std::ofstream output(path, std::ios::binary);
+    output.write(reinterpret_cast<char const *>(values.data()), values.size() * sizeof(float));
+}
+
+} // namespace
+
+TEST_CASE("storage: external buffer")
+{
+    std::vector<float> buffer = {1, 2, 3, 4, 5, 6};
+    int released = 0;
+    {
+        auto matrix = from_external<float, 2>(buffer.data(), {2, 3}, [&]() { released++; });
+        REQUIRE(matrix.raw_data() == buffer.data());
+        REQUIRE(matrix == MatrixF{{1, 2, 3}, {4, 5, 6}});
+
+        // writes go to the buffer
+        matrix(1, 2) = 7;
+        REQUIRE(buffer[5] == 7);
+
+        // views share the storage, the buffer is released after the last of them
+        auto row = matrix[1];
+        auto transposed = matrix.permute({1, 0});
+        matrix = MatrixF();
+        REQUIRE(released == 0);
+        REQUIRE(transposed(2, 1) == 7);
+
+        // results of ops and deep copies get storage of their own
+        auto sum = ts::add(row, row);
+        auto copy = VectorF(row, true);
+        REQUIRE(copy.raw_data() != buffer.data() + 3);
+        REQUIRE(sum == VectorF{8, 10, 14});
+    }
+    REQUIRE(released == 1);
+    REQUIRE(buffer == std::vector<float>{1, 2, 3, 4, 5, 7});
+}
+
+TEST_CASE("storage: read-only mapping")
+{
+    auto path = temporary_path("read_only");
+    write_file(path, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+    auto file = MappedFile::open(path);
+    REQUIRE(file != nullptr);
+    REQUIRE(file->size() == 10 * sizeof(float));
+
+    auto tensor = from_mapped_file<float, 2>(file, {2, 3}, 4 * sizeof(float));
+    file = nullptr;
+    REQUIRE(tensor == MatrixF{{4, 5, 6}, {7, 8, 9}});
+    REQUIRE(ts::sum(tensor) == 39);
+    REQUIRE(tensor.cast<bf16>().cast<float>() == tensor);
+
+    REQUIRE(MappedFile::open(temporary_path("missing")) == nullptr);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("storage: writable mappings")
+{
+    auto path = temporary_path("read_write");
+    {
+        auto file = MappedFile::create(path, 4 * sizeof(float));
+        REQUIRE(file != nullptr);
+        auto vector = from_mapped_file<float, 1>(file, {4});
+        REQUIRE(vector == VectorF{0, 0, 0, 0});
+        ts::fill_(vector, 2.5f);
+        file->sync();
+    }
+    {
+        // private writes don't reach the file
+        auto file = MappedFile::open(path, MapMode::COPY_ON_WRITE);
+        auto vector = from_mapped_file<float, 1>(file, {4});
+        REQUIRE(vector == VectorF{2.5, 2.5, 2.5, 2.5});
+        vector(0) = 1;
+        REQUIRE(vector(0) == 1);
+    }
+    {
+        // shared ones do, and are visible through every mapping of the file
+        auto first = from_mapped_file<float, 1>(MappedFile::open(path, MapMode::READ_WRITE), {4});
+        auto second = from_mapped_file<float, 1>(MappedFile::open(path), {4});
+        REQUIRE(first(0) == 2.5);
+        first(3) = -1;
+        REQUIRE(second == VectorF{2.5, 2.5, 2.5, -1});
+    }
+    std::remove(path.c_str());
+}
@@ -16,7 +16,7 @@ TEST_CASE("simple initializer_list")
     Tensor<int, 1> array = {0, 1, 2, 3};
     REQUIRE(array.shape() == std::array<size_type, 1>{4});
     REQUIRE(array.data_size() == 4);
-    REQUIRE(*array.data() == std::vector{0, 1, 2, 3});
+    REQUIRE(*array.data() == Tensor<int, 1>::vector_t{0, 1, 2, 3});
 }
 
 TEST_CASE("nested initializer_list")
@@ -25,7 +25,7 @@ TEST_CASE("nested initializer_list")
                             {2, 3}};
     REQUIRE(array.shape() == std::array<size_type, 2>{2, 2});
     REQUIRE(array.data_size() == 4);
-    REQUIRE(*array.data() == std::vector{0, 1, 2, 3});
+    REQUIRE(*array.data() == Tensor<int, 2>::vector_t{0, 1, 2, 3});
 }
 
 TEST_CASE("indexing multidimensional array")
@@ -64,7 +64,7 @@ TEST_CASE("bracket operator")
     Tensor<float, 2> matrix ={{1, 2, 3},
                               {4, 5, 6}};
     REQUIRE(matrix.shape() == std::array<size_type, 2>{2, 3});
-    REQUIRE(*matrix.data() == std::vector<float>{1, 2, 3, 4, 5, 6});
+    REQUIRE(*matrix.data() == Tensor<float, 2>::vector_t{1, 2, 3, 4, 5, 6});
 
     {
         Tensor<float, 1> array = matrix[0];
@@ -337,3 +337,55 @@ TEST_CASE("get_subarray") {
         REQUIRE(std::equal(b, e, tensor(1, 2).begin()));
     }
 }
+
+TEST_CASE("permute: view with strides")
+{
+    ts::Tensor<int, 3> tensor = {{{0, 1}, {2, 3}, {4, 5}}, {{6, 7}, {8, 9}, {10, 11}}};
+    REQUIRE(tensor.strides() == std::array<size_type, 3>{6, 2, 1});
+    REQUIRE(tensor.is_contiguous());
+
+    auto permuted = tensor.permute({2, 0, 1});
+    REQUIRE(permuted.shape() == std::array<size_type, 3>{2, 2, 3});
+    REQUIRE(permuted.strides() == std::array<size_type, 3>{1, 6, 2});
+    REQUIRE(!permuted.is_contiguous());
+    REQUIRE(permuted.data() == tensor.data());
+
+    REQUIRE(permuted(1, 0, 2) == tensor(0, 2, 1));
+    REQUIRE(permuted.at({0, 1, 1}) == tensor.at({1, 1, 0}));
+    REQUIRE(permuted(1, 1)[0] == 7);
+
+    ts::Tensor<int, 3> expected = {{{0, 2, 4}, {6, 8, 10}}, {{1, 3, 5}, {7, 9, 11}}};
+    REQUIRE(permuted == expected);
+
+    auto contiguous = permuted.contiguous();
+    REQUIRE(contiguous.is_contiguous());
+    REQUIRE(contiguous.data() != tensor.data());
+    REQUIRE(std::equal(contiguous.begin(), contiguous.end(), expected.begin()));
+    REQUIRE(permuted.clone().is_contiguous());
+
+    // writes through a view land in the original tensor
+    permuted(1, 1, 2) = 100;
+    REQUIRE(tensor(1, 2, 1) == 100);
+}
+
+TEST_CASE("view: in-place ops and reshape")
+{
+    MatrixF matrix = {{1, 2, 3}, {4, 5, 6}};
+    auto transposed = matrix.permute({1, 0});
+
+    transposed += MatrixF{{1, 1}, {2, 2}, {3, 3}};
+    REQUIRE(matrix == MatrixF{{2, 4, 6}, {5, 7, 9}});
+
+    -transposed;
+    REQUIRE(matrix == MatrixF{{-2, -4, -6}, {-5, -7, -9}});
+
+    transposed.assign(MatrixF{{1, 4}, {2, 5}, {3, 6}});
+    REQUIRE(matrix == MatrixF{{1, 2, 3}, {4, 5, 6}});
+
+    auto flat = transposed.flatten();
+    REQUIRE(flat == VectorF{1, 4, 2, 5, 3, 6});
+    REQUIRE(flat.data() != matrix.data());
+
+    auto reshaped = matrix.reshape<1>({6});
+    REQUIRE(reshaped.data() == matrix.data());
+}
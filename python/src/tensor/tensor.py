@@ -142,7 +142,8 @@ class Tensor:
 
     @property
     def numpy(self):
-        return np.array(self._data)
+        # a view sharing memory with the tensor, copy it to keep values around after in-place updates
+        return np.asarray(self._data)
 
     def __getitem__(self, item: IndexT) -> ArrayT:
         if not isinstance(item, int) and len(item) != self.dim:
@@ -37,6 +37,57 @@ def test_tensor_from_numpy():
             assert tensor[i, j] == array[i, j]
 
 
+def test_tensor_shares_numpy_memory():
+    array = np.arange(24, dtype=np.float32).reshape(2, 3, 4)
+    tensor = _ts.Tensor3F(array)
+    array[1, 2, 3] = -1.
+    assert tensor[1, 2, 3] == -1.
+    tensor[0, 0, 0] = 42.
+    assert array[0, 0, 0] == 42.
+
+    # the tensor keeps the array alive
+    del array
+    assert tensor[1, 2, 3] == -1.
+
+    # strided views get copied
+    array = np.arange(12, dtype=np.float32).reshape(3, 4)
+    tensor = _ts.MatrixF(array.T)
+    assert tensor.shape() == [4, 3]
+    assert tensor[3, 1] == array[1, 3]
+    array[1, 3] = 100.
+    assert tensor[3, 1] == 7.
+
+    # read-only buffers too
+    array.flags.writeable = False
+    tensor = _ts.MatrixF(array)
+    array.flags.writeable = True
+    array[1, 3] = 0.
+    assert tensor[1, 3] == 100.
+
+
+def test_layers_on_transposed_arrays():
+    # NCHW view of a NHWC batch, not C-contiguous
+    images = np.random.randn(2, 6, 6, 3).astype(np.float32)
+    transposed = images.transpose(0, 3, 1, 2)
+    contiguous = np.ascontiguousarray(transposed)
+
+    conv = _ts.Conv2D(3, 4, 3, 1, 0, 1, _ts.Activation.NONE, True)
+    np.testing.assert_allclose(np.array(conv(_ts.Tensor4F(transposed))), np.array(conv(_ts.Tensor4F(contiguous))),
+                               rtol=1e-6)
+
+    max_pool = _ts.MaxPool2D(2, 2, 0)
+    np.testing.assert_array_equal(np.array(max_pool(_ts.Tensor4F(transposed))),
+                                  np.array(max_pool(_ts.Tensor4F(contiguous))))
+
+
+def test_numpy_view_of_tensor():
+    tensor = _ts.MatrixF(np.arange(6, dtype=np.float32).reshape(2, 3))
+    view = np.asarray(tensor)
+    assert view.strides == (12, 4)
+    view[1, 2] = 7.
+    assert tensor[1, 2] == 7.
+
+
 def test_numpy_from_tensor():
     tensor = _ts.MatrixF(5, 4)
     assert memoryview(tensor).shape == (5, 4)